@@ -3744,13 +3744,13 @@ class YarrGenerator : private DefaultMacroAssembler {
         // Do nothing.
 #endif
 
-        store8(TrustedImm32(1), &m_vm->isExecutingInRegExpJIT);
+        // QV4: Don't track isExecutingInRegExpJIT. Nothing reads it, and the
+        // generated code must not refer to the VM so that it can be shared
+        // between engines.
     }
 
     void generateReturn()
     {
-        store8(TrustedImm32(0), &m_vm->isExecutingInRegExpJIT);
-
 #if CPU(X86_64)
 #if OS(WINDOWS)
         // Store the return value in the allocated space pointed by rcx.
@@ -43,7 +43,7 @@
 QT_BEGIN_NAMESPACE
 
 QV4ProfilerAdapter::QV4ProfilerAdapter(QQmlProfilerService *service, QV4::ExecutionEngine *engine) :
-    m_functionCallPos(0), m_memoryPos(0)
+    m_functionCallPos(0), m_memoryPos(0), m_allocationSitePos(0), m_heapSnapshotPos(0)
 {
     setService(service);
     engine->setProfiler(new QV4::Profiling::Profiler(engine));
@@ -76,7 +76,32 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
 
     while (memoryData.length() > m_memoryPos && memoryData[m_memoryPos].timestamp <= until) {
         const QV4::Profiling::MemoryAllocationProperties &props = memoryData[m_memoryPos];
-        d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
+        switch (props.type) {
+        case QV4::Profiling::SampledAllocation: {
+            const QV4::Profiling::FunctionLocation &site
+                    = m_allocationSites.at(m_allocationSitePos++);
+            d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size
+              << site.file << site.line << site.column << site.name;
+            break;
+        }
+        case QV4::Profiling::HeapSnapshot: {
+            // Split the snapshot so that each packet stays well below the 64k the client can
+            // store per event. The subtype is the index of the chunk.
+            const QByteArray &snapshot = m_heapSnapshots.at(m_heapSnapshotPos++);
+            int chunk = 0;
+            for (int pos = 0; pos < snapshot.size(); pos += s_heapSnapshotChunkSize, ++chunk) {
+                d << props.timestamp << int(HeapSnapshot) << chunk
+                  << snapshot.mid(pos, s_heapSnapshotChunkSize);
+                messages.append(d.squeezedData());
+                d.clear();
+            }
+            ++m_memoryPos;
+            continue;
+        }
+        default:
+            d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
+            break;
+        }
         ++m_memoryPos;
         messages.append(d.squeezedData());
         d.clear();
@@ -100,7 +125,11 @@ qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &mes
 
     if (memoryNext == -1) {
         m_memoryData.clear();
+        m_allocationSites.clear();
+        m_heapSnapshots.clear();
         m_memoryPos = 0;
+        m_allocationSitePos = 0;
+        m_heapSnapshotPos = 0;
         return callNext;
     }
 
@@ -161,7 +190,9 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
 void QV4ProfilerAdapter::receiveData(
         const QV4::Profiling::FunctionLocationHash &locations,
         const QVector<QV4::Profiling::FunctionCallProperties> &functionCallData,
-        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData)
+        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData,
+        const QVector<QV4::Profiling::FunctionLocation> &allocationSites,
+        const QVector<QByteArray> &heapSnapshots)
 {
     // In rare cases it could be that another flush or stop event is processed while data from
     // the previous one is still pending. In that case we just append the data.
@@ -180,6 +211,16 @@ void QV4ProfilerAdapter::receiveData(
     else
         m_memoryData.append(memoryData);
 
+    if (m_allocationSites.isEmpty())
+        m_allocationSites = allocationSites;
+    else
+        m_allocationSites.append(allocationSites);
+
+    if (m_heapSnapshots.isEmpty())
+        m_heapSnapshots = heapSnapshots;
+    else
+        m_heapSnapshots.append(heapSnapshots);
+
     service->dataReady(this);
 }
 
@@ -191,6 +232,8 @@ quint64 QV4ProfilerAdapter::translateFeatures(quint64 qmlFeatures)
         v4Features |= (one << QV4::Profiling::FeatureFunctionCall);
     if (qmlFeatures & (one << ProfileMemory))
         v4Features |= (one << QV4::Profiling::FeatureMemoryAllocation);
+    if (qmlFeatures & (one << ProfileHeapSnapshots))
+        v4Features |= (one << QV4::Profiling::FeatureHeapSnapshot);
     return v4Features;
 }
 
@@ -72,18 +72,26 @@ public:
 
     void receiveData(const QV4::Profiling::FunctionLocationHash &,
                      const QVector<QV4::Profiling::FunctionCallProperties> &,
-                     const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                     const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                     const QVector<QV4::Profiling::FunctionLocation> &,
+                     const QVector<QByteArray> &);
 
 signals:
     void v4ProfilingEnabled(quint64 v4Features);
     void v4ProfilingEnabledWhileWaiting(quint64 v4Features);
 
 private:
+    static const int s_heapSnapshotChunkSize = 32 * 1024;
+
     QV4::Profiling::FunctionLocationHash m_functionLocations;
     QVector<QV4::Profiling::FunctionCallProperties> m_functionCallData;
     QVector<QV4::Profiling::MemoryAllocationProperties> m_memoryData;
+    QVector<QV4::Profiling::FunctionLocation> m_allocationSites;
+    QVector<QByteArray> m_heapSnapshots;
     int m_functionCallPos;
     int m_memoryPos;
+    int m_allocationSitePos;
+    int m_heapSnapshotPos;
     QStack<qint64> m_stack;
     qint64 appendMemoryEvents(qint64 until, QList<QByteArray> &messages, QQmlDebugPacket &d);
     qint64 finalizeMessages(qint64 until, QList<QByteArray> &messages, qint64 callNext,
@@ -50,6 +50,7 @@
 // We mean it.
 //
 
+#include <algorithm>
 #include <functional>
 
 #include <QtCore/qstring.h>
@@ -75,7 +76,7 @@ QT_BEGIN_NAMESPACE
 // Also change the comment behind the number to describe the latest change. This has the added
 // benefit that if another patch changes the version too, it will result in a merge conflict, and
 // not get removed silently.
-#define QV4_DATA_STRUCTURE_VERSION 0x26// support required properties
+#define QV4_DATA_STRUCTURE_VERSION 0x29// units with lazily compiled functions are flagged
 
 class QIODevice;
 class QQmlTypeNameCache;
@@ -286,7 +287,8 @@ struct Function
     enum Flags : unsigned int {
         IsStrict            = 0x1,
         IsArrowFunction     = 0x2,
-        IsGenerator         = 0x4
+        IsGenerator         = 0x4,
+        IsLazy              = 0x8
     };
 
     // Absolute offset into file where the code for this function is located.
@@ -312,6 +314,8 @@ struct Function
     quint32_le nLabelInfos;
     size_t labelInfosOffset() const { return lineNumberOffset() + nLineNumbers * sizeof(CodeOffsetToLine); }
 
+    quint32_le lazySourceIndex; // for IsLazy functions, string index of the source to compile on first call
+
     // Keep all unaligned data at the end
     quint8 flags;
     quint8 padding1;
@@ -344,7 +348,7 @@ struct Function
         return (a + 7) & ~size_t(7);
     }
 };
-static_assert(sizeof(Function) == 56, "Function structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+static_assert(sizeof(Function) == 60, "Function structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
 
 struct Method {
     enum Type {
@@ -441,6 +445,31 @@ struct TranslationData
 };
 static_assert(sizeof(TranslationData) == 16, "TranslationData structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
 
+// Describes a script binding whose expression is simple enough to be evaluated without running
+// its function: "object", "object.property", "!object.property" or "object.property <op> number".
+struct SimpleBinding
+{
+    enum Operation : unsigned int {
+        Copy,
+        Not,
+        Add,
+        Subtract,
+        Multiply,
+        Divide
+    };
+
+    quint32_le functionIndex; // the binding's function, used as fallback
+    quint32_le objectNameIndex;
+    quint32_le propertyNameIndex; // 0 (the empty string) if the object name itself is the result
+    union {
+        quint32_le_bitfield<0, 4> operation;
+        quint32_le_bitfield<4, 28> constantIndex; // right hand side of the arithmetic operations
+    };
+
+    bool hasProperty() const { return propertyNameIndex != 0; }
+};
+static_assert(sizeof(SimpleBinding) == 16, "SimpleBinding structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+
 struct Binding
 {
     quint32_le propertyNameIndex;
@@ -863,18 +892,34 @@ struct QmlUnit
     quint32_le offsetToImports;
     quint32_le nObjects;
     quint32_le offsetToObjects;
+    quint32_le nSimpleBindings;
+    quint32_le offsetToSimpleBindings; // sorted by function index
 
     const Import *importAt(int idx) const {
         return reinterpret_cast<const Import*>((reinterpret_cast<const char *>(this)) + offsetToImports + idx * sizeof(Import));
     }
 
+    const SimpleBinding *simpleBindingTable() const {
+        return reinterpret_cast<const SimpleBinding *>(reinterpret_cast<const char *>(this) + offsetToSimpleBindings);
+    }
+
+    const SimpleBinding *simpleBindingForFunction(quint32 functionIndex) const {
+        const SimpleBinding *begin = simpleBindingTable();
+        const SimpleBinding *end = begin + nSimpleBindings;
+        const SimpleBinding *it = std::lower_bound(begin, end, functionIndex,
+                                                   [](const SimpleBinding &binding, quint32 index) {
+            return binding.functionIndex < index;
+        });
+        return (it != end && it->functionIndex == functionIndex) ? it : nullptr;
+    }
+
     const Object *objectAt(int idx) const {
         const quint32_le *offsetTable = reinterpret_cast<const quint32_le*>((reinterpret_cast<const char *>(this)) + offsetToObjects);
         const quint32_le offset = offsetTable[idx];
         return reinterpret_cast<const Object*>(reinterpret_cast<const char*>(this) + offset);
     }
 };
-static_assert(sizeof(QmlUnit) == 16, "QmlUnit structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
+static_assert(sizeof(QmlUnit) == 24, "QmlUnit structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
 
 enum { QmlCompileHashSpace = 48 };
 static const char magic_str[] = "qv4cdata";
@@ -900,7 +945,8 @@ struct Unit
         IsSingleton = 0x4,
         IsSharedLibrary = 0x8, // .pragma shared?
         IsESModule = 0x10,
-        PendingTypeCompilation = 0x20 // the QML data structures present are incomplete and require type compilation
+        PendingTypeCompilation = 0x20, // the QML data structures present are incomplete and require type compilation
+        HasLazyFunctions = 0x40 // some functions are stubs that get compiled on their first call
     };
     quint32_le flags;
     quint32_le stringTableSize;
@@ -1038,6 +1084,50 @@ struct Unit
 
 static_assert(sizeof(Unit) == 248, "Unit structure needs to have the expected size to be binary compatible on disk when generated by host compiler and loaded by target");
 
+// Machine code generated by the JIT can be stored in cache files, following the Unit data. It is
+// only valid on the machine it was generated on, with the exact same build of the QtQml library.
+struct NativeCodeRelocation
+{
+    enum Kind : quint32 {
+        CodeAddress, // value is an offset from the start of the function's code
+        LibraryAddress // value is an offset from the base address of the QtQml library
+    };
+
+    quint32_le offset; // of the pointer to patch, from the start of the function's code
+    quint32_le kind;
+    quint64_le value;
+};
+static_assert(sizeof(NativeCodeRelocation) == 16, "NativeCodeRelocation structure needs to have the expected size to be binary compatible on disk");
+
+struct NativeCodeFunction
+{
+    quint32_le functionIndex;
+    quint32_le codeOffset; // from the start of the native code section
+    quint32_le codeSize;
+    quint32_le osrEntryOffset; // from the start of the function's code, 0 if there is none
+    quint32_le relocationTableOffset; // from the start of the native code section
+    quint32_le nRelocations;
+
+    const NativeCodeRelocation *relocationTable(const char *section) const
+    { return reinterpret_cast<const NativeCodeRelocation *>(section + relocationTableOffset); }
+};
+static_assert(sizeof(NativeCodeFunction) == 24, "NativeCodeFunction structure needs to have the expected size to be binary compatible on disk");
+
+struct NativeCodeHeader
+{
+    char magic[8];
+    quint64_le cpuFeatures;
+    char buildHash[16]; // identifies the QtQml library and the JIT configuration
+    quint32_le sectionSize; // including this header
+    quint32_le nFunctions;
+
+    const NativeCodeFunction *functionTable() const
+    { return reinterpret_cast<const NativeCodeFunction *>(this + 1); }
+    const char *code(const NativeCodeFunction *function) const
+    { return reinterpret_cast<const char *>(this) + function->codeOffset; }
+};
+static_assert(sizeof(NativeCodeHeader) == 40, "NativeCodeHeader structure needs to have the expected size to be binary compatible on disk");
+
 struct TypeReference
 {
     TypeReference(const Location &loc)
@@ -421,6 +421,7 @@ bool IRBuilder::generateFromQml(const QString &code, const QString &url, Documen
     qSwap(_objects, output->objects);
     this->pool = output->jsParserEngine.pool();
     this->jsGenerator = &output->jsGenerator;
+    this->debugMode = output->jsModule.debugMode;
 
     Q_ASSERT(registerString(QString()) == emptyStringIndex);
 
@@ -1046,6 +1047,9 @@ void IRBuilder::setBindingValue(QV4::CompiledData::Binding *binding, QQmlJS::AST
         expr->parentNode = parentNode;
         expr->nameIndex = registerString(QLatin1String("expression for ")
                                          + stringAt(binding->propertyNameIndex));
+        // Simple bindings bypass the function, so the debugger could not step through them.
+        if (exprStmt && !debugMode && !isSignalPropertyName(stringAt(binding->propertyNameIndex)))
+            expr->simpleBinding = tryGeneratingSimpleBinding(exprStmt->expression);
         const int index = bindingsTarget()->functionsAndExpressions->append(expr);
         binding->value.compiledScriptIndex = index;
         // We don't need to store the binding script as string, except for script strings
@@ -1054,6 +1058,80 @@ void IRBuilder::setBindingValue(QV4::CompiledData::Binding *binding, QQmlJS::AST
     }
 }
 
+static QQmlJS::AST::ExpressionNode *stripParentheses(QQmlJS::AST::ExpressionNode *expr)
+{
+    while (QQmlJS::AST::NestedExpression *nested = QQmlJS::AST::cast<QQmlJS::AST::NestedExpression *>(expr))
+        expr = nested->expression;
+    return expr;
+}
+
+QV4::CompiledData::SimpleBinding *IRBuilder::tryGeneratingSimpleBinding(QQmlJS::AST::ExpressionNode *expr)
+{
+    QV4::CompiledData::SimpleBinding simpleBinding;
+    simpleBinding.functionIndex = 0; // set when the unit is generated
+    simpleBinding.operation = QV4::CompiledData::SimpleBinding::Copy;
+    simpleBinding.constantIndex = 0;
+
+    QQmlJS::AST::NumericLiteral *constant = nullptr;
+    expr = stripParentheses(expr);
+    if (QQmlJS::AST::NotExpression *notExpr = QQmlJS::AST::cast<QQmlJS::AST::NotExpression *>(expr)) {
+        simpleBinding.operation = QV4::CompiledData::SimpleBinding::Not;
+        expr = notExpr->expression;
+    } else if (QQmlJS::AST::BinaryExpression *binary = QQmlJS::AST::cast<QQmlJS::AST::BinaryExpression *>(expr)) {
+        switch (binary->op) {
+        case QSOperator::Add:
+            simpleBinding.operation = QV4::CompiledData::SimpleBinding::Add;
+            break;
+        case QSOperator::Sub:
+            simpleBinding.operation = QV4::CompiledData::SimpleBinding::Subtract;
+            break;
+        case QSOperator::Mul:
+            simpleBinding.operation = QV4::CompiledData::SimpleBinding::Multiply;
+            break;
+        case QSOperator::Div:
+            simpleBinding.operation = QV4::CompiledData::SimpleBinding::Divide;
+            break;
+        default:
+            return nullptr;
+        }
+
+        constant = QQmlJS::AST::cast<QQmlJS::AST::NumericLiteral *>(stripParentheses(binary->right));
+        if (!constant)
+            return nullptr;
+        expr = binary->left;
+    }
+
+    if (!setSimpleBindingOperand(expr, &simpleBinding))
+        return nullptr;
+
+    if (constant)
+        simpleBinding.constantIndex = jsGenerator->registerConstant(QV4::Encode(constant->value));
+
+    QV4::CompiledData::SimpleBinding *result = New<QV4::CompiledData::SimpleBinding>();
+    *result = simpleBinding;
+    return result;
+}
+
+bool IRBuilder::setSimpleBindingOperand(QQmlJS::AST::ExpressionNode *expr, QV4::CompiledData::SimpleBinding *simpleBinding)
+{
+    QStringRef propertyName;
+    expr = stripParentheses(expr);
+    if (QQmlJS::AST::FieldMemberExpression *member = QQmlJS::AST::cast<QQmlJS::AST::FieldMemberExpression *>(expr)) {
+        propertyName = member->name;
+        expr = stripParentheses(member->base);
+    }
+
+    QQmlJS::AST::IdentifierExpression *object = QQmlJS::AST::cast<QQmlJS::AST::IdentifierExpression *>(expr);
+    // Names starting with an upper case letter may refer to types, enums or imported scripts.
+    if (!object || object->name.isEmpty() || object->name.at(0).isUpper())
+        return false;
+
+    simpleBinding->objectNameIndex = registerString(object->name.toString());
+    simpleBinding->propertyNameIndex = propertyName.isEmpty() ? emptyStringIndex
+                                                              : registerString(propertyName.toString());
+    return true;
+}
+
 void IRBuilder::tryGeneratingTranslationBinding(const QStringRef &base, AST::ArgumentList *args, QV4::CompiledData::Binding *binding)
 {
     if (base == QLatin1String("qsTr")) {
@@ -1542,12 +1620,30 @@ void QmlUnitGenerator::generate(Document &output, const QV4::CompiledData::Depen
     // No more new strings after this point, we're calculating offsets.
     output.jsGenerator.stringTable.freeze();
 
+    QVector<QV4::CompiledData::SimpleBinding> simpleBindings;
+    for (const Object *o : qAsConst(output.objects)) {
+        int scriptIndex = 0;
+        for (const CompiledFunctionOrExpression *foe = o->functionsAndExpressions->first; foe; foe = foe->next, ++scriptIndex) {
+            if (!foe->simpleBinding || scriptIndex >= o->runtimeFunctionIndices.size())
+                continue;
+            QV4::CompiledData::SimpleBinding simpleBinding = *foe->simpleBinding;
+            simpleBinding.functionIndex = o->runtimeFunctionIndices.at(scriptIndex);
+            simpleBindings.append(simpleBinding);
+        }
+    }
+    std::sort(simpleBindings.begin(), simpleBindings.end(),
+              [](const QV4::CompiledData::SimpleBinding &lhs, const QV4::CompiledData::SimpleBinding &rhs) {
+        return lhs.functionIndex < rhs.functionIndex;
+    });
+
     const uint importSize = sizeof(QV4::CompiledData::Import) * output.imports.count();
+    const uint simpleBindingTableSize = sizeof(QV4::CompiledData::SimpleBinding) * simpleBindings.count();
     const uint objectOffsetTableSize = output.objects.count() * sizeof(quint32);
 
     QHash<const Object*, quint32> objectOffsets;
 
-    const unsigned int objectOffset = sizeof(QV4::CompiledData::QmlUnit) + importSize;
+    const unsigned int simpleBindingOffset = sizeof(QV4::CompiledData::QmlUnit) + importSize;
+    const unsigned int objectOffset = simpleBindingOffset + simpleBindingTableSize;
     uint nextOffset = objectOffset + objectOffsetTableSize;
     for (Object *o : qAsConst(output.objects)) {
         objectOffsets.insert(o, nextOffset);
@@ -1574,6 +1670,8 @@ void QmlUnitGenerator::generate(Document &output, const QV4::CompiledData::Depen
     qmlUnit->nImports = output.imports.count();
     qmlUnit->offsetToObjects = objectOffset;
     qmlUnit->nObjects = output.objects.count();
+    qmlUnit->offsetToSimpleBindings = simpleBindingOffset;
+    qmlUnit->nSimpleBindings = simpleBindings.count();
 
     // write imports
     char *importPtr = data + qmlUnit->offsetToImports;
@@ -1583,6 +1681,9 @@ void QmlUnitGenerator::generate(Document &output, const QV4::CompiledData::Depen
         importPtr += sizeof(QV4::CompiledData::Import);
     }
 
+    // write simple bindings
+    memcpy(data + qmlUnit->offsetToSimpleBindings, simpleBindings.constData(), simpleBindingTableSize);
+
     // write objects
     quint32_le *objectTable = reinterpret_cast<quint32_le*>(data + qmlUnit->offsetToObjects);
     for (int i = 0; i < output.objects.count(); ++i) {
@@ -1720,6 +1821,7 @@ void QmlUnitGenerator::generate(Document &output, const QV4::CompiledData::Depen
         qDebug() << "    " << jsUnit->functionTableSize << "functions";
         qDebug() << "    " << jsUnit->unitSize << "for JS unit";
         qDebug() << "    " << importSize << "for imports";
+        qDebug() << "    " << simpleBindingTableSize << "for" << simpleBindings.count() << "simple bindings";
         qDebug() << "    " << nextOffset - objectOffset - objectOffsetTableSize << "for" << qmlUnit->nObjects << "objects";
         quint32 totalBindingCount = 0;
         for (quint32 i = 0; i < qmlUnit->nObjects; ++i)
@@ -288,6 +288,7 @@ struct Q_QMLCOMPILER_PRIVATE_EXPORT CompiledFunctionOrExpression
     QQmlJS::AST::Node *parentNode = nullptr; // FunctionDeclaration, Statement or Expression
     QQmlJS::AST::Node *node = nullptr; // FunctionDeclaration, Statement or Expression
     quint32 nameIndex = 0;
+    QV4::CompiledData::SimpleBinding *simpleBinding = nullptr; // set for bindings that don't need to run the function
     CompiledFunctionOrExpression *next = nullptr;
 };
 
@@ -462,6 +463,8 @@ public:
     void setBindingValue(QV4::CompiledData::Binding *binding, QQmlJS::AST::Statement *statement,
                          QQmlJS::AST::Node *parentNode);
     void tryGeneratingTranslationBinding(const QStringRef &base, QQmlJS::AST::ArgumentList *args, QV4::CompiledData::Binding *binding);
+    QV4::CompiledData::SimpleBinding *tryGeneratingSimpleBinding(QQmlJS::AST::ExpressionNode *expr);
+    bool setSimpleBindingOperand(QQmlJS::AST::ExpressionNode *expr, QV4::CompiledData::SimpleBinding *simpleBinding);
 
     void appendBinding(QQmlJS::AST::UiQualifiedId *name, QQmlJS::AST::Statement *value,
                        QQmlJS::AST::Node *parentNode);
@@ -511,6 +514,7 @@ public:
     QQmlJS::MemoryPool *pool;
     QString sourceCode;
     QV4::Compiler::JSUnitGenerator *jsGenerator;
+    bool debugMode = false;
 };
 
 struct Q_QMLCOMPILER_PRIVATE_EXPORT QmlUnitGenerator
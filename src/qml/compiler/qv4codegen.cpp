@@ -572,6 +572,22 @@ void Codegen::variableDeclaration(PatternElement *ast)
         }
         return;
     }
+    if (!_context->scalarReplacements.isEmpty()) {
+        const auto replacement = _context->scalarReplacements.constFind(ast->bindingIdentifier.toString());
+        if (replacement != _context->scalarReplacements.constEnd() && replacement->declaration == ast) {
+            // The object is never observable, only initialize the registers holding its properties.
+            PatternPropertyList *it = AST::cast<ObjectPattern *>(ast->initializer)->properties;
+            for (int reg = replacement->firstRegister; it; it = it->next, ++reg) {
+                RegisterScope innerScope(this);
+                Reference value = expression(it->property->initializer, it->property->name->asString());
+                if (hasError())
+                    return;
+                value.loadInAccumulator();
+                Reference::fromStackSlot(this, reg, true /*isLocal*/).storeConsumeAccumulator();
+            }
+            return;
+        }
+    }
     initializeAndDestructureBindingElement(ast, Reference(), /*isDefinition*/ true);
 }
 
@@ -2237,6 +2253,15 @@ bool Codegen::visit(FieldMemberExpression *ast)
             setExprResult(r);
             return false;
         }
+
+        const int reg = _context->scalarReplacementRegister(id->name, ast->name);
+        if (reg != -1) {
+            // A property of an object replaced by registers, see ScanFunctions
+            Reference r = Reference::fromStackSlot(this, reg, true /*isLocal*/);
+            r.isVolatile = true;
+            setExprResult(r);
+            return false;
+        }
     }
 
     Reference base = expression(ast->base);
@@ -2993,6 +3018,24 @@ int Codegen::defineFunction(const QString &name, AST::Node *ast,
     _module->functions.append(_context);
     _context->functionIndex = _module->functions.count() - 1;
 
+    if (!_context->lazySourceCode.isEmpty()) {
+        // The real code is generated from the source on the first call, see
+        // QV4::Function::compileLazily(). This stub is only run if that fails, and leaves the
+        // pending exception to the caller.
+        BytecodeGenerator bytecode(_context->line, _module->debugMode);
+        BytecodeGenerator *savedBytecodeGenerator = bytecodeGenerator;
+        bytecodeGenerator = &bytecode;
+        bytecodeGenerator->setLocation(ast->firstSourceLocation());
+        bytecodeGenerator->newRegisterArray(
+                sizeof(CallData) / sizeof(StaticValue) - 1 + _context->arguments.size());
+        Reference::fromConst(this, Encode::undefined()).loadInAccumulator();
+        bytecodeGenerator->addInstruction(Instruction::Ret());
+        bytecodeGenerator->finalize(_context);
+        _context->registerCountInFunction = bytecodeGenerator->registerCount();
+        bytecodeGenerator = savedBytecodeGenerator;
+        return leaveContext();
+    }
+
     Context *savedFunctionContext = _functionContext;
     _functionContext = _context;
     ControlFlow *savedControlFlow = controlFlow;
@@ -270,6 +270,8 @@ QV4::CompiledData::Unit *QV4::Compiler::JSUnitGenerator::generateUnit(GeneratorO
     for (Context *f : qAsConst(module->functions)) {
         registerString(f->name);
         registerString(f->returnType);
+        if (!f->lazySourceCode.isEmpty())
+            registerString(f->lazySourceCode);
         for (int i = 0; i < f->arguments.size(); ++i) {
             registerString(f->arguments.at(i).id);
             registerString(f->arguments.at(i).typeName());
@@ -434,6 +436,12 @@ void QV4::Compiler::JSUnitGenerator::writeFunction(char *f, QV4::Compiler::Conte
         function->flags |= CompiledData::Function::IsArrowFunction;
     if (irFunction->isGenerator)
         function->flags |= CompiledData::Function::IsGenerator;
+    if (!irFunction->lazySourceCode.isEmpty()) {
+        function->flags |= CompiledData::Function::IsLazy;
+        function->lazySourceIndex = getStringId(irFunction->lazySourceCode);
+    } else {
+        function->lazySourceIndex = 0;
+    }
     function->nestedFunctionIndex =
             irFunction->returnsClosure ? quint32(module->functions.indexOf(irFunction->nestedContexts.first()))
                                        : std::numeric_limits<uint32_t>::max();
@@ -606,6 +614,12 @@ QV4::CompiledData::Unit QV4::Compiler::JSUnitGenerator::generateHeader(QV4::Comp
     memcpy(unit.magic, CompiledData::magic_str, sizeof(unit.magic));
     unit.flags = QV4::CompiledData::Unit::IsJavascript;
     unit.flags |= module->unitFlags;
+    for (Context *f : qAsConst(module->functions)) {
+        if (!f->lazySourceCode.isEmpty()) {
+            unit.flags |= QV4::CompiledData::Unit::HasLazyFunctions;
+            break;
+        }
+    }
     unit.version = QV4_DATA_STRUCTURE_VERSION;
     unit.qtVersion = QT_VERSION;
     qstrcpy(unit.libraryVersionHash, QML_COMPILE_HASH);
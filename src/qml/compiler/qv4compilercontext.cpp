@@ -197,6 +197,23 @@ Context::ResolvedName Context::resolveName(const QString &name, const QQmlJS::AS
     return result;
 }
 
+int Context::scalarReplacementRegister(const QStringRef &name, const QStringRef &property) const
+{
+    const Context *c = this;
+    while (c->contextType == ContextType::Block && !c->isWithBlock && c->parent)
+        c = c->parent;
+    if (c->scalarReplacements.isEmpty())
+        return -1;
+
+    const auto it = c->scalarReplacements.constFind(name.toString());
+    if (it == c->scalarReplacements.constEnd())
+        return -1;
+    const int index = it->properties.indexOf(property.toString());
+    Q_ASSERT(index != -1);
+    Q_ASSERT(it->firstRegister != -1);
+    return it->firstRegister + index;
+}
+
 void Context::emitBlockHeader(Codegen *codegen)
 {
     using Instruction = Moth::Instruction;
@@ -371,6 +388,8 @@ void Context::setupFunctionIndices(Moth::BytecodeGenerator *bytecodeGenerator)
                     allocateRegister(it);
             }
         }
+        for (ScalarReplacement &replacement : scalarReplacements)
+            replacement.firstRegister = bytecodeGenerator->newRegisterArray(replacement.properties.size());
         break;
     }
     case ContextType::Global:
@@ -152,6 +152,8 @@ struct Module {
     QDateTime sourceTimeStamp;
     uint unitFlags = 0; // flags merged into CompiledData::Unit::flags
     bool debugMode = false;
+    // Generate the bytecode of plain function bodies on their first call, see ScanFunctions
+    bool lazyFunctionCompilation = false;
     QVector<ExportEntry> localExportEntries;
     QVector<ExportEntry> indirectExportEntries;
     QVector<ExportEntry> starExportEntries;
@@ -190,11 +192,24 @@ struct Context {
     };
     typedef QMap<QString, Member> MemberMap;
 
+    // An object literal held by a local variable that is only ever used to read and write
+    // the literal's own properties. No object is created; its properties live in consecutive
+    // registers starting at firstRegister.
+    struct ScalarReplacement {
+        QQmlJS::AST::PatternElement *declaration = nullptr;
+        QStringList properties;
+        int firstRegister = -1;
+    };
+    typedef QHash<QString, ScalarReplacement> ScalarReplacementMap;
+
     MemberMap members;
+    ScalarReplacementMap scalarReplacements;
     QSet<QString> usedVariables;
     QQmlJS::AST::FormalParameterList *formals = nullptr;
     QQmlJS::AST::BoundNames arguments;
     QString returnType;
+    // Source of the function for QV4::Function::compileLazily(), empty if compiled up front
+    QString lazySourceCode;
     QStringList locals;
     QStringList moduleRequests;
     QVector<ImportEntry> importEntries;
@@ -352,6 +367,7 @@ struct Context {
         bool isValid() const { return type != Unresolved; }
     };
     ResolvedName resolveName(const QString &name, const QQmlJS::AST::SourceLocation &accessLocation);
+    int scalarReplacementRegister(const QStringRef &name, const QStringRef &property) const;
     void emitBlockHeader(Compiler::Codegen *codegen);
     void emitBlockFooter(Compiler::Codegen *codegen);
 
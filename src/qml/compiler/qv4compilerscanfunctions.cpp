@@ -48,6 +48,7 @@
 #include <private/qqmljsast_p.h>
 #include <private/qv4compilercontext_p.h>
 #include <private/qv4codegen_p.h>
+#include <private/qv4stringtoarrayindex_p.h>
 
 QT_USE_NAMESPACE
 using namespace QV4;
@@ -64,6 +65,235 @@ static CompiledData::Location location(const QQmlJS::AST::SourceLocation &astLoc
 }
 
 
+namespace {
+
+// Finds object literals that are bound to a variable declared at the top level of a
+// function body, where the variable is only ever used to read or write the literal's own
+// properties after its initialization. Such an object is unobservable, so Codegen can keep
+// its properties in registers instead of allocating it. Any other use of the name, including
+// from nested functions or declarations shadowing it, disqualifies the candidate.
+class ScalarReplacementAnalysis : protected Visitor
+{
+public:
+    ScalarReplacementAnalysis(quint16 parentRecursionDepth)
+        : Visitor(parentRecursionDepth)
+    {}
+
+    Context::ScalarReplacementMap operator()(FormalParameterList *formals, StatementList *body)
+    {
+        collectCandidates(body);
+        if (m_candidates.isEmpty())
+            return Context::ScalarReplacementMap();
+
+        Node::accept(formals, this);
+        Node::accept(body, this);
+
+        Context::ScalarReplacementMap result;
+        if (m_failed)
+            return result;
+        for (auto it = m_candidates.constBegin(), end = m_candidates.constEnd(); it != end; ++it) {
+            if (!it->disqualified)
+                result.insert(it.key(), it->replacement);
+        }
+        return result;
+    }
+
+protected:
+    using Visitor::visit;
+    using Visitor::endVisit;
+
+    bool visit(IdentifierExpression *ast) override
+    {
+        disqualify(ast->name);
+        return false;
+    }
+
+    bool visit(FieldMemberExpression *ast) override
+    {
+        IdentifierExpression *id = cast<IdentifierExpression *>(ast->base);
+        if (!id)
+            return true;
+        auto candidate = m_candidates.find(id->name.toString());
+        if (candidate == m_candidates.end())
+            return false;
+        if (m_functionDepth > 0
+                || ast->firstSourceLocation().begin() < candidate->endOfInitializer
+                || !candidate->replacement.properties.contains(ast->name.toString())) {
+            candidate->disqualified = true;
+        }
+        return false;
+    }
+
+    bool visit(CallExpression *ast) override
+    {
+        if (IdentifierExpression *id = cast<IdentifierExpression *>(ast->base)) {
+            if (id->name == QLatin1String("eval"))
+                m_failed = true;
+        }
+        // Calling a method passes the object as this
+        disqualifyMember(ast->base);
+        return true;
+    }
+
+    bool visit(TaggedTemplate *ast) override
+    {
+        disqualifyMember(ast->base);
+        return true;
+    }
+
+    bool visit(DeleteExpression *ast) override
+    {
+        disqualifyMember(ast->expression);
+        return true;
+    }
+
+    bool visit(TemplateLiteral *ast) override
+    {
+        Node::accept(ast->expression, this);
+        return true;
+    }
+
+    bool visit(PatternElement *ast) override
+    {
+        if (ast != currentDeclaration(ast->bindingIdentifier))
+            disqualify(ast->bindingIdentifier);
+        return true;
+    }
+
+    bool visit(PatternProperty *ast) override
+    {
+        disqualify(ast->bindingIdentifier);
+        return true;
+    }
+
+    bool visit(FunctionExpression *ast) override
+    {
+        disqualify(ast->name);
+        ++m_functionDepth;
+        return true;
+    }
+
+    void endVisit(FunctionExpression *) override { --m_functionDepth; }
+
+    bool visit(FunctionDeclaration *ast) override
+    {
+        disqualify(ast->name);
+        ++m_functionDepth;
+        return true;
+    }
+
+    void endVisit(FunctionDeclaration *) override { --m_functionDepth; }
+
+    bool visit(ClassExpression *ast) override
+    {
+        disqualify(ast->name);
+        return true;
+    }
+
+    bool visit(ClassDeclaration *ast) override
+    {
+        disqualify(ast->name);
+        return true;
+    }
+
+    bool visit(WithStatement *) override
+    {
+        m_failed = true;
+        return false;
+    }
+
+    void throwRecursionDepthError() override
+    {
+        // ScanFunctions reports the error
+        m_failed = true;
+    }
+
+private:
+    struct Candidate {
+        Context::ScalarReplacement replacement;
+        quint32 endOfInitializer = 0;
+        bool disqualified = false;
+    };
+
+    static bool collectProperties(ObjectPattern *pattern, QStringList *properties)
+    {
+        for (PatternPropertyList *it = pattern->properties; it; it = it->next) {
+            PatternProperty *p = it->property;
+            if (p->type != PatternProperty::Literal || !p->initializer
+                    || cast<ComputedPropertyName *>(p->name)
+                    || cast<NumericLiteralPropertyName *>(p->name)) {
+                return false;
+            }
+            const QString name = p->name->asString();
+            if (name == QLatin1String("__proto__") || stringToArrayIndex(name) != UINT_MAX
+                    || properties->contains(name)) {
+                return false;
+            }
+            properties->append(name);
+        }
+        return true;
+    }
+
+    void collectCandidates(StatementList *body)
+    {
+        for (StatementList *it = body; it; it = it->next) {
+            VariableStatement *statement = cast<VariableStatement *>(it->statement);
+            if (!statement)
+                continue;
+            for (VariableDeclarationList *decl = statement->declarations; decl; decl = decl->next) {
+                PatternElement *e = decl->declaration;
+                ObjectPattern *pattern = cast<ObjectPattern *>(e->initializer);
+                if (!pattern || e->bindingIdentifier.isEmpty() || e->bindingTarget)
+                    continue;
+
+                Candidate candidate;
+                candidate.replacement.declaration = e;
+                candidate.endOfInitializer = e->lastSourceLocation().end();
+                candidate.disqualified = !collectProperties(pattern, &candidate.replacement.properties);
+
+                const QString name = e->bindingIdentifier.toString();
+                if (m_candidates.contains(name))
+                    candidate.disqualified = true;
+                m_candidates.insert(name, candidate);
+            }
+        }
+    }
+
+    PatternElement *currentDeclaration(const QStringRef &name) const
+    {
+        if (name.isEmpty())
+            return nullptr;
+        auto candidate = m_candidates.constFind(name.toString());
+        return candidate == m_candidates.constEnd() ? nullptr : candidate->replacement.declaration;
+    }
+
+    void disqualify(const QStringRef &name)
+    {
+        if (name.isEmpty())
+            return;
+        auto candidate = m_candidates.find(name.toString());
+        if (candidate != m_candidates.end())
+            candidate->disqualified = true;
+    }
+
+    void disqualifyMember(ExpressionNode *expression)
+    {
+        while (NestedExpression *nested = cast<NestedExpression *>(expression))
+            expression = nested->expression;
+        if (FieldMemberExpression *member = cast<FieldMemberExpression *>(expression)) {
+            if (IdentifierExpression *id = cast<IdentifierExpression *>(member->base))
+                disqualify(id->name);
+        }
+    }
+
+    QHash<QString, Candidate> m_candidates;
+    int m_functionDepth = 0;
+    bool m_failed = false;
+};
+
+} // anonymous namespace
+
+
 ScanFunctions::ScanFunctions(Codegen *cg, const QString &sourceCode, ContextType defaultProgramType)
     : QQmlJS::AST::Visitor(cg->recursionDepth())
     , _cg(cg)
@@ -717,9 +947,62 @@ bool ScanFunctions::enterFunction(Node *ast, const QString &name, FormalParamete
             _context->addLocalVar(arg, Context::VariableDefinition, VariableScope::Var);
     }
 
+    findScalarReplacements(formals, body);
+
+    // Only remember the source now, the bytecode is generated when the function is first called.
+    // A function expression keeps its name, so that it can still refer to itself.
+    if (expr && canCompileLazily(expr, outerContext)) {
+        _context->lazySourceCode = QStringLiteral("function ");
+        if (!enterName)
+            _context->lazySourceCode += name;
+        _context->lazySourceCode += _sourceCode.midRef(
+                    expr->lparenToken.offset, expr->rbraceToken.end() - expr->lparenToken.offset);
+    }
+
+    return true;
+}
+
+bool ScanFunctions::canCompileLazily(FunctionExpression *ast, Context *outerContext) const
+{
+    const Module *module = _cg->_module;
+    if (!module->lazyFunctionCompilation || module->debugMode || !outerContext)
+        return false;
+
+    // Arrow functions, generators, methods and accessors are always compiled up front, as are
+    // the functions the QML compiler synthesizes, which have no source of their own.
+    if (ast->isArrowFunction || ast->isGenerator || !ast->lparenToken.isValid()
+            || _sourceCode.midRef(ast->functionToken.offset, ast->functionToken.length)
+                != QLatin1String("function")) {
+        return false;
+    }
+
+    // Type annotations are only understood in QML mode.
+    if (ast->typeAnnotation)
+        return false;
+    for (FormalParameterList *it = ast->formals; it; it = it->next) {
+        if (it->element && it->element->typeAnnotation)
+            return false;
+    }
+
+    for (const Context *c = outerContext; c; c = c->parent) {
+        if (c->contextType == ContextType::ESModule)
+            return false;
+    }
     return true;
 }
 
+void ScanFunctions::findScalarReplacements(FormalParameterList *formals, StatementList *body)
+{
+    if (!body || _cg->_module->debugMode)
+        return;
+
+    ScalarReplacementAnalysis analysis(recursionDepth());
+    _context->scalarReplacements = analysis(formals, body);
+
+    // Stay conservative about variables shadowing the function's own name
+    _context->scalarReplacements.remove(_context->name);
+}
+
 void ScanFunctions::calcEscapingVariables()
 {
     Module *m = _cg->_module;
@@ -875,6 +1158,18 @@ void ScanFunctions::calcEscapingVariables()
         }
     }
 
+    for (Context *c : qAsConst(m->contextMap)) {
+        if (c->scalarReplacements.isEmpty())
+            continue;
+        for (auto it = c->scalarReplacements.begin(); it != c->scalarReplacements.end();) {
+            auto member = c->members.constFind(it.key());
+            if (c->hasDirectEval || member == c->members.constEnd() || member->canEscape)
+                it = c->scalarReplacements.erase(it);
+            else
+                ++it;
+        }
+    }
+
     static const bool showEscapingVars = qEnvironmentVariableIsSet("QV4_SHOW_ESCAPING_VARS");
     if (showEscapingVars) {
         qDebug() << "==== escaping variables ====";
@@ -887,6 +1182,8 @@ void ScanFunctions::calcEscapingVariables()
             for (auto it = c->members.constBegin(); it != c->members.constEnd(); ++it) {
                 qDebug() << "    " << it.key() << it.value().index << it.value().canEscape << "isLexicallyScoped:" << it.value().isLexicallyScoped();
             }
+            for (auto it = c->scalarReplacements.constBegin(); it != c->scalarReplacements.constEnd(); ++it)
+                qDebug() << "    " << it.key() << "scalar replaced:" << it.value().properties;
         }
     }
 }
@@ -163,6 +163,9 @@ protected:
                        QQmlJS::AST::FormalParameterList *formals,
                        QQmlJS::AST::StatementList *body, bool enterName);
 
+    void findScalarReplacements(QQmlJS::AST::FormalParameterList *formals,
+                                QQmlJS::AST::StatementList *body);
+    bool canCompileLazily(QQmlJS::AST::FunctionExpression *ast, Context *outerContext) const;
     void calcEscapingVariables();
 // fields:
     Codegen *_cg;
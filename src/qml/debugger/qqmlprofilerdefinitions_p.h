@@ -70,6 +70,7 @@ struct QQmlProfilerDefinitions {
         SceneGraphFrame,
         MemoryAllocation,
         DebugMessage,
+        HeapSnapshot, // chunk of a V4 heap snapshot, see QV4::MemoryManager::writeHeapSnapshot()
 
         MaximumMessage
     };
@@ -137,6 +138,7 @@ struct QQmlProfilerDefinitions {
         ProfileHandlingSignal,
         ProfileInputEvents,
         ProfileDebugMessages,
+        ProfileHeapSnapshots,
 
         MaximumProfileFeature
     };
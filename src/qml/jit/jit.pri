@@ -10,3 +10,6 @@ HEADERS += \
     $$PWD/qv4baselinejit_p.h \
     $$PWD/qv4baselineassembler_p.h \
     $$PWD/qv4assemblercommon_p.h
+
+# dladdr() is used to relocate code stored in the disk cache
+qtConfig(dlopen): LIBS_PRIVATE += $$QMAKE_LIBS_DYNLOAD
@@ -38,12 +38,18 @@
 ****************************************************************************/
 
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QLoggingCategory>
+#include <QtCore/private/qglobal_p.h>
 
 #include "qv4engine_p.h"
 #include "qv4assemblercommon_p.h"
+#include "qv4baselinejit_p.h"
 #include <private/qv4function_p.h>
+#include <private/qv4mm_p.h>
 #include <private/qv4functiontable_p.h>
 #include <private/qv4runtime_p.h>
 
@@ -51,6 +57,10 @@
 #include <assembler/LinkBuffer.h>
 #include <WTFStubs.h>
 
+#if QT_CONFIG(dlopen)
+#include <dlfcn.h>
+#endif
+
 #undef ENABLE_ALL_ASSEMBLERS_FOR_REFACTORING_PURPOSES
 
 QT_BEGIN_NAMESPACE
@@ -132,6 +142,9 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         linkBuffer.patch(ehTarget.label, linkBuffer.locationOf(targetLabel));
     }
 
+    void *osrEntryAddress = osrEntry.isSet() ? linkBuffer.locationOf(osrEntry).executableAddress()
+                                             : nullptr;
+
     JSC::MacroAssemblerCodeRef codeRef;
 
     static const bool showCode = lcAsm().isDebugEnabled();
@@ -151,14 +164,166 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         codeRef = linkBuffer.finalizeCodeWithoutDisassembly();
     }
 
+    if (function->codeRef) {
+        // recompiled, the old code may still be executing
+        Q_ASSERT(!function->baselineCodeRef);
+        function->baselineCodeRef = function->codeRef;
+    }
     function->codeRef = new JSC::MacroAssemblerCodeRef(codeRef);
     function->jittedCode = reinterpret_cast<Function::JittedCode>(function->codeRef->code().executableAddress());
+    function->osrEntry = reinterpret_cast<Function::JittedCode>(osrEntryAddress);
 
     generateFunctionTable(function, &codeRef);
 
     linkBuffer.makeExecutable();
 }
 
+// Relocatable code refers to the runtime functions relative to the start of the QtQml library
+struct LibraryInfo
+{
+    quintptr base = 0;
+    QByteArray fileName;
+};
+
+static const LibraryInfo &libraryInfo()
+{
+    static const LibraryInfo info = []() {
+        LibraryInfo info;
+#if QT_CONFIG(dlopen)
+        Dl_info dlInfo;
+        if (dladdr(reinterpret_cast<const void *>(&libraryInfo), &dlInfo) && dlInfo.dli_fname) {
+            info.base = quintptr(dlInfo.dli_fbase);
+            info.fileName = dlInfo.dli_fname;
+        }
+#endif
+        return info;
+    }();
+    return info;
+}
+
+static bool isInLibrary(const void *address)
+{
+#if QT_CONFIG(dlopen)
+    Dl_info dlInfo;
+    return dladdr(address, &dlInfo) && quintptr(dlInfo.dli_fbase) == libraryInfo().base;
+#else
+    Q_UNUSED(address);
+    return false;
+#endif
+}
+
+QByteArray PlatformAssemblerCommon::relocatableBuildHash(ExecutionEngine *engine)
+{
+    const LibraryInfo &library = libraryInfo();
+    if (!library.base)
+        return QByteArray();
+
+    const QFileInfo fileInfo(QFile::decodeName(library.fileName));
+    if (!fileInfo.exists())
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(fileInfo.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QSysInfo::buildAbi().toUtf8());
+    // The generated code depends on the garbage collector
+    hash.addData(engine->memoryManager->usesWriteBarrier() ? QByteArrayLiteral("barrier")
+                                                         : QByteArrayLiteral("plain"));
+    return hash.result();
+}
+
+bool PlatformAssemblerCommon::linkRelocatable(Function *function, RelocatableCode *code)
+{
+    const quintptr libraryBase = libraryInfo().base;
+    if (!libraryBase)
+        return false;
+
+    for (const auto &jumpTarget : jumpsToLink)
+        jumpTarget.jump.linkTo(labelForOffset[jumpTarget.offset], this);
+
+    JSC::JSGlobalData dummy(function->internalClass->engine->executableAllocator);
+    JSC::LinkBuffer<MacroAssembler> linkBuffer(dummy, this, nullptr);
+
+    const char *start = static_cast<const char *>(linkBuffer.debugAddress());
+    const char *executableStart = static_cast<const char *>(
+                JSC::MacroAssemblerCodePtr(linkBuffer.debugAddress()).executableAddress());
+    auto codeOffset = [executableStart](const JSC::CodeLocationLabel &location) {
+        return quint64(static_cast<const char *>(location.executableAddress()) - executableStart);
+    };
+    auto dataOffset = [start](const JSC::CodeLocationDataLabelPtr &location) {
+        return quint32(static_cast<const char *>(location.dataLocation()) - start);
+    };
+
+    for (const auto &ehTarget : ehTargets) {
+        CompiledData::NativeCodeRelocation relocation;
+        relocation.offset = dataOffset(linkBuffer.locationOf(ehTarget.label));
+        relocation.kind = CompiledData::NativeCodeRelocation::CodeAddress;
+        relocation.value = codeOffset(linkBuffer.locationOf(labelForOffset.value(ehTarget.offset)));
+        code->relocations.append(relocation);
+    }
+
+    for (const auto &address : absoluteAddresses) {
+        if (!isInLibrary(address.target))
+            return false;
+        CompiledData::NativeCodeRelocation relocation;
+        relocation.offset = dataOffset(linkBuffer.locationOf(address.label));
+        relocation.kind = CompiledData::NativeCodeRelocation::LibraryAddress;
+        relocation.value = quint64(quintptr(address.target) - libraryBase);
+        code->relocations.append(relocation);
+    }
+
+    code->osrEntryOffset = osrEntry.isSet() ? quint32(codeOffset(linkBuffer.locationOf(osrEntry)))
+                                            : 0;
+
+    // The code is only copied, it never runs from here
+    linkBuffer.finalizeCodeWithoutDisassembly();
+    code->code = QByteArray(start, int(linkBuffer.debugSize()));
+    return true;
+}
+
+bool PlatformAssemblerCommon::loadRelocatable(Function *function,
+                                              const CompiledData::NativeCodeHeader *section,
+                                              const CompiledData::NativeCodeFunction *code)
+{
+    const quintptr libraryBase = libraryInfo().base;
+    if (!libraryBase)
+        return false;
+
+    const size_t size = code->codeSize;
+    JSC::JSGlobalData dummy(function->internalClass->engine->executableAllocator);
+    RefPtr<JSC::ExecutableMemoryHandle> memory
+            = dummy.executableAllocator.allocate(dummy, size, nullptr, JSC::JITCompilationMustSucceed);
+    char *start = static_cast<char *>(memory->start());
+    JSC::ExecutableAllocator::makeWritable(start, size);
+    memcpy(start, section->code(code), size);
+
+    JSC::MacroAssemblerCodeRef codeRef(memory.release());
+    char *executableStart = static_cast<char *>(codeRef.code().executableAddress());
+    const CompiledData::NativeCodeRelocation *relocations
+            = code->relocationTable(reinterpret_cast<const char *>(section));
+    for (quint32 i = 0; i < code->nRelocations; ++i) {
+        const CompiledData::NativeCodeRelocation &relocation = relocations[i];
+        void *value = relocation.kind == CompiledData::NativeCodeRelocation::CodeAddress
+                ? static_cast<void *>(executableStart + relocation.value)
+                : reinterpret_cast<void *>(libraryBase + quintptr(relocation.value));
+        MacroAssembler::linkPointer(start, JSC::AssemblerLabel(relocation.offset), value);
+    }
+
+    MacroAssembler::cacheFlush(start, size);
+    JSC::ExecutableAllocator::makeExecutable(start, size);
+
+    Q_ASSERT(!function->codeRef);
+    function->codeRef = new JSC::MacroAssemblerCodeRef(codeRef);
+    function->jittedCode = reinterpret_cast<Function::JittedCode>(executableStart);
+    function->osrEntry = code->osrEntryOffset
+            ? reinterpret_cast<Function::JittedCode>(executableStart + code->osrEntryOffset)
+            : nullptr;
+
+    generateFunctionTable(function, &codeRef);
+    return true;
+}
+
 void PlatformAssemblerCommon::prepareCallWithArgCount(int argc)
 {
 #ifndef QT_NO_DEBUG
@@ -318,7 +483,7 @@ void PlatformAssemblerCommon::callRuntime(const char *functionName, const void *
 void PlatformAssemblerCommon::callRuntimeUnchecked(const char *functionName, const void *funcPtr)
 {
     functions.insert(funcPtr, functionName);
-    callAbsolute(funcPtr);
+    absoluteAddresses.push_back({ callAbsolute(funcPtr), funcPtr });
 }
 
 void PlatformAssemblerCommon::tailCallRuntime(const char *functionName, const void *funcPtr)
@@ -328,7 +493,7 @@ void PlatformAssemblerCommon::tailCallRuntime(const char *functionName, const vo
     setTailCallArg(CppStackFrameRegister, 0);
     freeStackSpace();
     generatePlatformFunctionExit(/*tailCall =*/ true);
-    jumpAbsolute(funcPtr);
+    absoluteAddresses.push_back({ jumpAbsolute(funcPtr), funcPtr });
 }
 
 void PlatformAssemblerCommon::setTailCallArg(RegisterID src, int arg)
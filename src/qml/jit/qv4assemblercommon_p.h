@@ -65,6 +65,8 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 namespace JIT {
 
+struct RelocatableCode;
+
 #if defined(Q_PROCESSOR_X86_64) || defined(ENABLE_ALL_ASSEMBLERS_FOR_REFACTORING_PURPOSES)
 #if defined(Q_OS_LINUX) || defined(Q_OS_QNX) || defined(Q_OS_FREEBSD) || defined(Q_OS_DARWIN)
 
@@ -127,16 +129,18 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return target;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return target;
     }
 
     void pushAligned(RegisterID reg)
@@ -174,6 +178,7 @@ public:
     static const RegisterID StackPointerRegister  = RegisterID::esp;
     static const RegisterID FramePointerRegister  = RegisterID::ebp;
     static const FPRegisterID FPScratchRegister   = FPRegisterID::xmm1;
+    static const FPRegisterID FPScratchRegister2  = FPRegisterID::xmm2;
 
     static const RegisterID Arg0Reg = RegisterID::ecx;
     static const RegisterID Arg1Reg = RegisterID::edx;
@@ -213,18 +218,20 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         subPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
         call(ScratchRegister);
         addPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
+        return target;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return target;
     }
 
     void pushAligned(RegisterID reg)
@@ -306,16 +313,18 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return target;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return target;
     }
 
     void pushAligned(RegisterID reg)
@@ -354,6 +363,7 @@ public:
     static const RegisterID StackPointerRegister  = JSC::ARM64Registers::sp;
     static const RegisterID FramePointerRegister  = JSC::ARM64Registers::fp;
     static const FPRegisterID FPScratchRegister   = JSC::ARM64Registers::q1;
+    static const FPRegisterID FPScratchRegister2  = JSC::ARM64Registers::q2;
 
     static const RegisterID Arg0Reg = JSC::ARM64Registers::x0;
     static const RegisterID Arg1Reg = JSC::ARM64Registers::x1;
@@ -407,16 +417,18 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return target;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return target;
     }
 
     void pushAligned(RegisterID reg)
@@ -511,16 +523,18 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), dataTempRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), dataTempRegister);
         call(dataTempRegister);
+        return target;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), dataTempRegister);
+        DataLabelPtr target = moveWithPatch(TrustedImmPtr(funcPtr), dataTempRegister);
         jump(dataTempRegister);
+        return target;
     }
 
     void pushAligned(RegisterID reg)
@@ -657,6 +671,13 @@ public:
         allocateStackSpace();
     }
 
+    // Entry point used by the interpreter to continue a running frame in JIT code
+    void generateOsrEntry()
+    {
+        osrEntry = label();
+        generateFunctionEntry();
+    }
+
     virtual void allocateStackSpace() {}
 
     void generateFunctionExit()
@@ -690,6 +711,10 @@ public:
     }
 
     void link(Function *function, const char *jitKind);
+    bool linkRelocatable(Function *function, RelocatableCode *code);
+    static bool loadRelocatable(Function *function, const CompiledData::NativeCodeHeader *section,
+                                const CompiledData::NativeCodeFunction *code);
+    static QByteArray relocatableBuildHash(ExecutionEngine *engine);
 
     Value constant(int idx) const
     { return constantTable[idx]; }
@@ -723,10 +748,13 @@ private:
     std::vector<JumpTarget> jumpsToLink;
     struct ExceptionHanlderTarget { JSC::MacroAssemblerBase::DataLabelPtr label; int offset; };
     std::vector<ExceptionHanlderTarget> ehTargets;
+    struct AbsoluteAddress { JSC::MacroAssemblerBase::DataLabelPtr label; const void *target; };
+    std::vector<AbsoluteAddress> absoluteAddresses;
     QHash<int, JSC::MacroAssemblerBase::Label> labelForOffset;
     QHash<const void *, const char *> functions;
     std::vector<Jump> catchyJumps;
     Label functionExit;
+    Label osrEntry;
 
 #ifndef QT_NO_DEBUG
     enum { NoCall = -1 };
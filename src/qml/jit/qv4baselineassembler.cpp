@@ -44,8 +44,12 @@
 #include "qv4baselineassembler_p.h"
 #include "qv4assemblercommon_p.h"
 #include <private/qv4function_p.h>
+#include <private/qv4functionobject_p.h>
 #include <private/qv4runtime_p.h>
 #include <private/qv4stackframe_p.h>
+#include <private/qv4lookup_p.h>
+#include <private/qv4memberdata_p.h>
+#include <private/qv4mathobject_p.h>
 
 #include <wtf/Vector.h>
 #include <assembler/MacroAssembler.h>
@@ -370,6 +374,225 @@ public:
         passAsArg(AccumulatorRegister, 0);
         doCall();
     }
+
+    // Inlines the property load of a lookup that was found to be monomorphic when compiling.
+    // The internal class and offset are read from the lookup at runtime, so that the code stays
+    // valid if the lookup changes. Falls through to the generic lookup if anything doesn't match.
+    void getLookupFastPath(Lookup *lookup)
+    {
+        JumpList slowPath;
+        loadLookupProperty(lookup, slowPath);
+        lookupFastPathDone = jump();
+        slowPath.link(this);
+    }
+
+    // Inlines a call to one of the Math builtins, looked up through a monomorphic lookup. The
+    // callee is checked to still be the builtin the code was generated for, and only number
+    // arguments are handled inline. Everything else falls through to the generic call.
+    void mathBuiltinFastPath(Lookup *lookup, Address base, Address argv,
+                             BaselineAssembler::MathBuiltin builtin, const void *builtinClass)
+    {
+        using MathBuiltin = BaselineAssembler::MathBuiltin;
+
+        JumpList slowPath;
+        loadAccumulator(base);
+        loadLookupProperty(lookup, slowPath);
+
+        jumpIfNotManaged(AccumulatorRegister, slowPath);
+        loadPtr(Address(AccumulatorRegister, offsetof(Heap::Base, internalClass)), ScratchRegister);
+        slowPath.append(branchPtr(NotEqual, ScratchRegister, TrustedImmPtr(builtinClass)));
+        loadPtr(Address(AccumulatorRegister, offsetof(Heap::FunctionObjectOffsetStruct, jsCall)
+                                             + Heap::FunctionObjectData::baseOffset),
+                ScratchRegister);
+        slowPath.append(branchPtr(NotEqual, ScratchRegister,
+                                  TrustedImmPtr(reinterpret_cast<void *>(mathMethod(builtin)))));
+
+        switch (builtin) {
+        case MathBuiltin::Floor:
+        case MathBuiltin::Ceil: {
+            load64(argv, AccumulatorRegister);
+            // integers are their own floor and ceiling
+            Jump isInt = branchIsInt(AccumulatorRegister);
+            unboxDouble(AccumulatorRegister, FPScratchRegister, slowPath);
+            slowPath.append(branchDouble(DoubleNotEqualOrUnordered, FPScratchRegister,
+                                         FPScratchRegister));
+            slowPath.append(branchTruncateDoubleToInt32(FPScratchRegister, AccumulatorRegister));
+            convertInt32ToDouble(AccumulatorRegister, FPScratchRegister2);
+            if (builtin == MathBuiltin::Floor) {
+                Jump exact = branchDouble(DoubleLessThanOrEqual, FPScratchRegister2,
+                                          FPScratchRegister);
+                slowPath.append(branchSub32(Overflow, TrustedImm32(1), AccumulatorRegister));
+                exact.link(this);
+            } else {
+                Jump exact = branchDouble(DoubleGreaterThanOrEqual, FPScratchRegister2,
+                                          FPScratchRegister);
+                slowPath.append(branchAdd32(Overflow, TrustedImm32(1), AccumulatorRegister));
+                exact.link(this);
+            }
+            // a zero result for a negative argument is -0, which is not an integer
+            Jump nonZero = branchTest32(NonZero, AccumulatorRegister);
+            moveDoubleTo64(FPScratchRegister, ScratchRegister);
+            slowPath.append(branch64(LessThan, ScratchRegister, TrustedImm64(0)));
+            nonZero.link(this);
+            zeroExtend32ToPtr(AccumulatorRegister, AccumulatorRegister);
+            setAccumulatorTag(IntegerTag);
+            isInt.link(this);
+            break;
+        }
+        case MathBuiltin::Abs: {
+            load64(argv, AccumulatorRegister);
+            Jump isInt = branchIsInt(AccumulatorRegister);
+            unboxDouble(AccumulatorRegister, FPScratchRegister, slowPath);
+            absDouble(FPScratchRegister, FPScratchRegister2);
+            encodeDoubleIntoAccumulator(FPScratchRegister2);
+            Jump done = jump();
+
+            isInt.link(this);
+            Jump nonNegative = branch32(GreaterThanOrEqual, AccumulatorRegister, TrustedImm32(0));
+            slowPath.append(branchNeg32(Overflow, AccumulatorRegister));
+            zeroExtend32ToPtr(AccumulatorRegister, AccumulatorRegister);
+            setAccumulatorTag(IntegerTag);
+            nonNegative.link(this);
+            done.link(this);
+            break;
+        }
+        case MathBuiltin::Sqrt:
+            loadNumberAsDouble(argv, FPScratchRegister, slowPath);
+            sqrtDouble(FPScratchRegister, FPScratchRegister);
+            encodeDoubleIntoAccumulator(FPScratchRegister);
+            break;
+        case MathBuiltin::Min:
+        case MathBuiltin::Max: {
+            // the arguments are numbers, so the result is one of them, unchanged
+            Address secondArg(argv.base, argv.offset + int(sizeof(Value)));
+            load64(argv, AccumulatorRegister);
+            load64(secondArg, ScratchRegister2);
+            urshift64(AccumulatorRegister, TrustedImm32(32), ScratchRegister);
+            Jump firstNotInt = branch32(NotEqual, ScratchRegister, TrustedImm32(int(IntegerTag)));
+            urshift64(ScratchRegister2, TrustedImm32(32), ScratchRegister);
+            Jump secondNotInt = branch32(NotEqual, ScratchRegister, TrustedImm32(int(IntegerTag)));
+            Jump keepFirstInt = branch32(builtin == MathBuiltin::Min ? LessThanOrEqual
+                                                                      : GreaterThanOrEqual,
+                                         AccumulatorRegister, ScratchRegister2);
+            move(ScratchRegister2, AccumulatorRegister);
+            keepFirstInt.link(this);
+            Jump done = jump();
+
+            firstNotInt.link(this);
+            secondNotInt.link(this);
+            loadNumberAsDouble(argv, FPScratchRegister, slowPath);
+            loadNumberAsDouble(secondArg, FPScratchRegister2, slowPath);
+            // NaN, and equal values that could be zeros of different sign, need the generic code
+            slowPath.append(branchDouble(DoubleEqualOrUnordered, FPScratchRegister,
+                                         FPScratchRegister2));
+            Jump keepFirst = branchDouble(builtin == MathBuiltin::Min ? DoubleLessThan
+                                                                      : DoubleGreaterThan,
+                                          FPScratchRegister, FPScratchRegister2);
+            load64(secondArg, AccumulatorRegister);
+            Jump selected = jump();
+            keepFirst.link(this);
+            load64(argv, AccumulatorRegister);
+            selected.link(this);
+            done.link(this);
+            break;
+        }
+        }
+
+        lookupFastPathDone = jump();
+        slowPath.link(this);
+    }
+
+    void linkLookupFastPath()
+    {
+        if (lookupFastPathDone.isSet()) {
+            lookupFastPathDone.link(this);
+            lookupFastPathDone = Jump();
+        }
+    }
+
+private:
+    void jumpIfNotManaged(RegisterID reg, JumpList &target)
+    {
+        target.append(branchTest64(Zero, reg));
+        urshift64(reg, TrustedImm32(Value::IsManagedOrUndefined_Shift), ScratchRegister);
+        target.append(branch32(NotEqual, ScratchRegister, TrustedImm32(0)));
+    }
+
+    // Loads the property of the object in the accumulator through a getter0Inline or
+    // getter0MemberData lookup.
+    void loadLookupProperty(Lookup *lookup, JumpList &slowPath)
+    {
+        const bool inMemberData = lookup->getter == Lookup::getter0MemberData;
+        Q_ASSERT(inMemberData || lookup->getter == Lookup::getter0Inline);
+
+        // only heap objects can have the cached internal class
+        jumpIfNotManaged(AccumulatorRegister, slowPath);
+
+        move(TrustedImmPtr(lookup), ScratchRegister2);
+        loadPtr(Address(ScratchRegister2, offsetof(Lookup, getter)), ScratchRegister);
+        slowPath.append(branchPtr(NotEqual, ScratchRegister,
+                                  TrustedImmPtr(reinterpret_cast<void *>(lookup->getter))));
+        loadPtr(Address(AccumulatorRegister, offsetof(Heap::Base, internalClass)), ScratchRegister);
+        slowPath.append(branchPtr(NotEqual, ScratchRegister,
+                                  Address(ScratchRegister2, offsetof(Lookup, objectLookup.ic))));
+
+        load32(Address(ScratchRegister2, offsetof(Lookup, objectLookup.offset)), ScratchRegister);
+        if (inMemberData) {
+            Heap::Object o;
+            Heap::MemberData m;
+            Q_UNUSED(o)
+            Q_UNUSED(m)
+            loadPtr(Address(AccumulatorRegister, o.memberData.offset), ScratchRegister2);
+            load64(BaseIndex(ScratchRegister2, ScratchRegister, TimesEight,
+                             m.values.offset + offsetof(ValueArray<0>, values)),
+                   AccumulatorRegister);
+        } else {
+            load64(BaseIndex(AccumulatorRegister, ScratchRegister, TimesEight), AccumulatorRegister);
+        }
+    }
+
+    Jump branchIsInt(RegisterID reg)
+    {
+        urshift64(reg, TrustedImm32(32), ScratchRegister);
+        return branch32(Equal, ScratchRegister, TrustedImm32(int(IntegerTag)));
+    }
+
+    void unboxDouble(RegisterID reg, FPRegisterID dest, JumpList &notDouble)
+    {
+        urshift64(reg, TrustedImm32(Value::IsDouble_Shift), ScratchRegister);
+        notDouble.append(branch32(Equal, ScratchRegister, TrustedImm32(0)));
+        move(TrustedImm64(Value::NaNEncodeMask), ScratchRegister);
+        xor64(reg, ScratchRegister);
+        move64ToDouble(ScratchRegister, dest);
+    }
+
+    // clobbers the accumulator
+    void loadNumberAsDouble(Address src, FPRegisterID dest, JumpList &notNumber)
+    {
+        load64(src, AccumulatorRegister);
+        Jump isInt = branchIsInt(AccumulatorRegister);
+        unboxDouble(AccumulatorRegister, dest, notNumber);
+        Jump done = jump();
+        isInt.link(this);
+        convertInt32ToDouble(AccumulatorRegister, dest);
+        done.link(this);
+    }
+
+    static VTable::Call mathMethod(BaselineAssembler::MathBuiltin builtin)
+    {
+        switch (builtin) {
+        case BaselineAssembler::MathBuiltin::Floor: return MathObject::method_floor;
+        case BaselineAssembler::MathBuiltin::Ceil: return MathObject::method_ceil;
+        case BaselineAssembler::MathBuiltin::Abs: return MathObject::method_abs;
+        case BaselineAssembler::MathBuiltin::Sqrt: return MathObject::method_sqrt;
+        case BaselineAssembler::MathBuiltin::Min: return MathObject::method_min;
+        case BaselineAssembler::MathBuiltin::Max: return MathObject::method_max;
+        }
+        Q_UNREACHABLE();
+        return nullptr;
+    }
+
+    Jump lookupFastPathDone;
 };
 
 typedef PlatformAssembler64 PlatformAssembler;
@@ -803,6 +1026,12 @@ public:
         if (ArgInRegCount < 2)
             addPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
     }
+
+    // not implemented, always use the generic lookup
+    void getLookupFastPath(Lookup *) {}
+    void mathBuiltinFastPath(Lookup *, Address, Address, BaselineAssembler::MathBuiltin,
+                             const void *) {}
+    void linkLookupFastPath() {}
 };
 
 typedef PlatformAssembler32 PlatformAssembler;
@@ -842,9 +1071,44 @@ void BaselineAssembler::generateEpilogue()
     pasm()->generateCatchTrampoline();
 }
 
-void BaselineAssembler::link(Function *function)
+void BaselineAssembler::generateOsrEntry(const std::vector<int> &loopHeaders)
+{
+    // The interpreter has stored the accumulator in the frame and the offset of the loop
+    // header it is about to execute in the instruction pointer.
+    pasm()->generateOsrEntry();
+    pasm()->loadAccumulator(PlatformAssembler::Address(PlatformAssembler::JSStackFrameRegister,
+                                                       offsetof(CallData, accumulator)));
+    pasm()->load32(Address(PlatformAssembler::CppStackFrameRegister,
+                           offsetof(CppStackFrame, instructionPointer)),
+                   PlatformAssembler::ScratchRegister);
+    for (int offset : loopHeaders) {
+        auto jump = pasm()->branch32(PlatformAssembler::Equal, PlatformAssembler::ScratchRegister,
+                                     TrustedImm32(offset));
+        pasm()->addJumpToOffset(jump, offset);
+    }
+    pasm()->breakpoint();
+}
+
+void BaselineAssembler::link(Function *function, const char *jitKind)
 {
-    pasm()->link(function, "BaselineJIT");
+    pasm()->link(function, jitKind);
+}
+
+bool BaselineAssembler::linkRelocatable(Function *function, RelocatableCode *code)
+{
+    return pasm()->linkRelocatable(function, code);
+}
+
+bool BaselineAssembler::loadRelocatable(Function *function,
+                                        const CompiledData::NativeCodeHeader *section,
+                                        const CompiledData::NativeCodeFunction *code)
+{
+    return PlatformAssembler::loadRelocatable(function, section, code);
+}
+
+QByteArray BaselineAssembler::relocatableBuildHash(ExecutionEngine *engine)
+{
+    return PlatformAssembler::relocatableBuildHash(engine);
 }
 
 void BaselineAssembler::addLabel(int offset)
@@ -906,6 +1170,50 @@ void BaselineAssembler::storeLocal(int index, int level)
     pasm()->storeAccumulator(Address(PlatformAssembler::ScratchRegister, ctx.locals.offset + offsetof(ValueArray<0>, values) + sizeof(Value)*index));
 }
 
+static void storeLocalWithWriteBarrierHelper(ExecutionEngine *engine, const Value *context,
+                                             const Value *value, int index, int level)
+{
+    Heap::ExecutionContext *scope = static_cast<const ExecutionContext *>(context)->d();
+    while (level > 0) {
+        --level;
+        scope = scope->outer;
+    }
+    Heap::CallContext *cc = static_cast<Heap::CallContext *>(scope);
+    QV4::WriteBarrier::write(engine, cc, cc->locals.values[index].data_ptr(), value->asReturnedValue());
+}
+
+void BaselineAssembler::storeLocalWithWriteBarrier(int index, int level)
+{
+    saveAccumulatorInFrame();
+    pasm()->prepareCallWithArgCount(5);
+    pasm()->passInt32AsArg(level, 4);
+    pasm()->passInt32AsArg(index, 3);
+    pasm()->passAccumulatorAsArg(2);
+    pasm()->passJSSlotAsArg(CallData::Context, 1);
+    pasm()->passEngineAsArg(0);
+    pasm()->callRuntime("storeLocalWithWriteBarrierHelper",
+                        reinterpret_cast<void *>(&storeLocalWithWriteBarrierHelper),
+                        CallResultDestination::Ignore);
+    pasm()->loadAccumulator(PlatformAssembler::Address(PlatformAssembler::JSStackFrameRegister,
+                                                       offsetof(CallData, accumulator)));
+}
+
+void BaselineAssembler::getLookupFastPath(Lookup *lookup)
+{
+    pasm()->getLookupFastPath(lookup);
+}
+
+void BaselineAssembler::mathBuiltinFastPath(Lookup *lookup, int base, int argv,
+                                            MathBuiltin builtin, const void *builtinClass)
+{
+    pasm()->mathBuiltinFastPath(lookup, regAddr(base), regAddr(argv), builtin, builtinClass);
+}
+
+void BaselineAssembler::linkLookupFastPath()
+{
+    pasm()->linkLookupFastPath();
+}
+
 void BaselineAssembler::loadString(int stringId)
 {
     pasm()->loadString(stringId);
@@ -55,6 +55,8 @@
 #include <private/qv4function_p.h>
 #include <QHash>
 
+#include <vector>
+
 QT_REQUIRE_CONFIG(qml_jit);
 
 QT_BEGIN_NAMESPACE
@@ -62,6 +64,8 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 namespace JIT {
 
+struct RelocatableCode;
+
 #define JIT_STRINGIFYx(s) #s
 #define JIT_STRINGIFY(s) JIT_STRINGIFYx(s)
 
@@ -81,7 +85,12 @@ public:
     // codegen infrastructure
     void generatePrologue();
     void generateEpilogue();
-    void link(Function *function);
+    void generateOsrEntry(const std::vector<int> &loopHeaders);
+    void link(Function *function, const char *jitKind = "BaselineJIT");
+    bool linkRelocatable(Function *function, RelocatableCode *code);
+    static bool loadRelocatable(Function *function, const CompiledData::NativeCodeHeader *section,
+                                const CompiledData::NativeCodeFunction *code);
+    static QByteArray relocatableBuildHash(ExecutionEngine *engine);
     void addLabel(int offset);
 
     // loads/stores/moves
@@ -92,11 +101,19 @@ public:
     void storeReg(int reg);
     void loadLocal(int index, int level = 0);
     void storeLocal(int index, int level = 0);
+    void storeLocalWithWriteBarrier(int index, int level = 0);
     void loadString(int stringId);
     void loadValue(ReturnedValue value);
     void storeHeapObject(int reg);
     void loadImport(int index);
 
+    // inline caches, used when compiling with type feedback
+    enum class MathBuiltin { Floor, Ceil, Abs, Sqrt, Min, Max };
+    void getLookupFastPath(Lookup *lookup);
+    void mathBuiltinFastPath(Lookup *lookup, int base, int argv, MathBuiltin builtin,
+                             const void *builtinClass);
+    void linkLookupFastPath();
+
     // numeric ops
     void unot();
     void toNumber();
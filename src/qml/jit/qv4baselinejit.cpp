@@ -41,15 +41,21 @@
 #include "qv4baselineassembler_p.h"
 #include <private/qv4lookup_p.h>
 #include <private/qv4generatorobject_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4mm_p.h>
+
+#include <algorithm>
 
 QT_USE_NAMESPACE
 using namespace QV4;
 using namespace QV4::JIT;
 using namespace QV4::Moth;
 
-BaselineJIT::BaselineJIT(Function *function)
+BaselineJIT::BaselineJIT(Function *function, bool useTypeFeedback)
     : function(function)
       , as(new BaselineAssembler(&(function->compilationUnit->constants->asValue<Value>())))
+      , needsWriteBarrier(function->internalClass->engine->memoryManager->usesWriteBarrier())
+      , useTypeFeedback(useTypeFeedback)
 {}
 
 BaselineJIT::~BaselineJIT()
@@ -58,6 +64,27 @@ BaselineJIT::~BaselineJIT()
 void BaselineJIT::generate()
 {
 //    qDebug()<<"jitting" << function->name()->toQString();
+    generateCode();
+
+    if (useTypeFeedback) {
+        as->link(function, "BaselineJIT (type feedback)");
+        function->hasOptimizedCode = true;
+    } else {
+        as->link(function);
+    }
+//    qDebug()<<"done";
+}
+
+bool BaselineJIT::generateRelocatable(RelocatableCode *code)
+{
+    // Type feedback is specific to the objects of the running engine
+    Q_ASSERT(!useTypeFeedback);
+    generateCode();
+    return as->linkRelocatable(function, code);
+}
+
+void BaselineJIT::generateCode()
+{
     const char *code = function->codeData;
     uint len = function->compiledFunction->codeSize;
 
@@ -67,9 +94,19 @@ void BaselineJIT::generate()
     as->generatePrologue();
     decode(code, len);
     as->generateEpilogue();
+    if (!loopHeaders.empty())
+        as->generateOsrEntry(loopHeaders);
+}
 
-    as->link(function);
-//    qDebug()<<"done";
+bool BaselineJIT::loadRelocatable(Function *function, const CompiledData::NativeCodeHeader *section,
+                                  const CompiledData::NativeCodeFunction *code)
+{
+    return BaselineAssembler::loadRelocatable(function, section, code);
+}
+
+QByteArray BaselineJIT::relocatableBuildHash(ExecutionEngine *engine)
+{
+    return BaselineAssembler::relocatableBuildHash(engine);
 }
 
 #define STORE_IP() as->storeInstructionPointer(nextInstructionOffset())
@@ -157,7 +194,10 @@ void BaselineJIT::generate_LoadLocal(int index)
 void BaselineJIT::generate_StoreLocal(int index)
 {
     as->checkException();
-    as->storeLocal(index);
+    if (needsWriteBarrier)
+        as->storeLocalWithWriteBarrier(index);
+    else
+        as->storeLocal(index);
 }
 
 void BaselineJIT::generate_LoadScopedLocal(int scope, int index)
@@ -168,7 +208,10 @@ void BaselineJIT::generate_LoadScopedLocal(int scope, int index)
 void BaselineJIT::generate_StoreScopedLocal(int scope, int index)
 {
     as->checkException();
-    as->storeLocal(index, scope);
+    if (needsWriteBarrier)
+        as->storeLocalWithWriteBarrier(index, scope);
+    else
+        as->storeLocal(index, scope);
 }
 
 void BaselineJIT::generate_LoadRuntimeString(int stringId)
@@ -277,6 +320,15 @@ void BaselineJIT::generate_LoadProperty(int name)
 
 void BaselineJIT::generate_GetLookup(int index)
 {
+    Lookup *lookup = nullptr;
+    if (useTypeFeedback) {
+        lookup = function->executableCompilationUnit()->runtimeLookups + index;
+        if (lookup->getter != Lookup::getter0Inline && lookup->getter != Lookup::getter0MemberData)
+            lookup = nullptr;
+    }
+    if (lookup)
+        as->getLookupFastPath(lookup);
+
     STORE_IP();
     STORE_ACC();
     as->prepareCallWithArgCount(4);
@@ -285,6 +337,9 @@ void BaselineJIT::generate_GetLookup(int index)
     as->passFunctionAsArg(1);
     as->passEngineAsArg(0);
     BASELINEJIT_GENERATE_RUNTIME_CALL(GetLookup, CallResultDestination::InAccumulator);
+
+    if (lookup)
+        as->linkLookupFastPath();
 }
 
 void BaselineJIT::generate_StoreProperty(int name, int base)
@@ -388,8 +443,54 @@ void BaselineJIT::generate_CallProperty(int name, int base, int argc, int argv)
     BASELINEJIT_GENERATE_RUNTIME_CALL(CallProperty, CallResultDestination::InAccumulator);
 }
 
+static bool mathBuiltinForCall(const QString &name, int argc, BaselineAssembler::MathBuiltin *builtin)
+{
+    using MathBuiltin = BaselineAssembler::MathBuiltin;
+    if (argc == 1) {
+        if (name == QLatin1String("floor"))
+            *builtin = MathBuiltin::Floor;
+        else if (name == QLatin1String("ceil"))
+            *builtin = MathBuiltin::Ceil;
+        else if (name == QLatin1String("abs"))
+            *builtin = MathBuiltin::Abs;
+        else if (name == QLatin1String("sqrt"))
+            *builtin = MathBuiltin::Sqrt;
+        else
+            return false;
+        return true;
+    }
+    if (argc == 2) {
+        if (name == QLatin1String("min"))
+            *builtin = MathBuiltin::Min;
+        else if (name == QLatin1String("max"))
+            *builtin = MathBuiltin::Max;
+        else
+            return false;
+        return true;
+    }
+    return false;
+}
+
 void BaselineJIT::generate_CallPropertyLookup(int lookupIndex, int base, int argc, int argv)
 {
+    // Calls to Math builtins are inlined, guarded by the callee. The name is only used to pick
+    // the builtin to check for, so calling any other function named like this stays correct.
+    Lookup *lookup = nullptr;
+    BaselineAssembler::MathBuiltin builtin = BaselineAssembler::MathBuiltin::Floor;
+    if (useTypeFeedback) {
+        ExecutableCompilationUnit *unit = function->executableCompilationUnit();
+        lookup = unit->runtimeLookups + lookupIndex;
+        if ((lookup->getter != Lookup::getter0Inline && lookup->getter != Lookup::getter0MemberData)
+                || !mathBuiltinForCall(unit->stringAt(lookup->nameIndex), argc, &builtin)) {
+            lookup = nullptr;
+        }
+    }
+    if (lookup) {
+        as->mathBuiltinFastPath(lookup, base, argv, builtin,
+                                function->internalClass->engine->internalClasses(
+                                        EngineBase::Class_BuiltinFunction));
+    }
+
     STORE_IP();
     as->prepareCallWithArgCount(5);
     as->passInt32AsArg(argc, 4);
@@ -398,6 +499,9 @@ void BaselineJIT::generate_CallPropertyLookup(int lookupIndex, int base, int arg
     as->passJSSlotAsArg(base, 1);
     as->passEngineAsArg(0);
     BASELINEJIT_GENERATE_RUNTIME_CALL(CallPropertyLookup, CallResultDestination::InAccumulator);
+
+    if (lookup)
+        as->linkLookupFastPath();
 }
 
 void BaselineJIT::generate_CallElement(int base, int index, int argc, int argv)
@@ -771,16 +875,22 @@ void BaselineJIT::generate_ToObject()
 
 void BaselineJIT::generate_Jump(int offset)
 {
+    if (offset < 0)
+        addLoopHeader(absoluteOffset(offset));
     labels.insert(as->jump(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpTrue(int offset)
 {
+    if (offset < 0)
+        addLoopHeader(absoluteOffset(offset));
     labels.insert(as->jumpTrue(absoluteOffset(offset)));
 }
 
 void BaselineJIT::generate_JumpFalse(int offset)
 {
+    if (offset < 0)
+        addLoopHeader(absoluteOffset(offset));
     labels.insert(as->jumpFalse(absoluteOffset(offset)));
 }
 
@@ -903,6 +1013,13 @@ void BaselineJIT::generate_GetTemplateObject(int index)
     BASELINEJIT_GENERATE_RUNTIME_CALL(GetTemplateObject, CallResultDestination::InAccumulator);
 }
 
+void BaselineJIT::addLoopHeader(int offset)
+{
+    // The interpreter can only enter the JIT code on backward jumps, see VME::interpret
+    if (std::find(loopHeaders.begin(), loopHeaders.end(), offset) == loopHeaders.end())
+        loopHeaders.push_back(offset);
+}
+
 ByteCodeHandler::Verdict BaselineJIT::startInstruction(Instr::Type /*instr*/)
 {
     if (labels.contains(currentInstructionOffset()))
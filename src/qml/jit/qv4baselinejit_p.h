@@ -65,14 +65,31 @@ namespace JIT {
 
 class BaselineAssembler;
 
+// Code that can be stored in a cache file and loaded into another process
+struct RelocatableCode
+{
+    QByteArray code;
+    QVector<CompiledData::NativeCodeRelocation> relocations;
+    quint32 osrEntryOffset = 0;
+};
+
 class BaselineJIT final: public Moth::ByteCodeHandler
 {
 public:
-    BaselineJIT(QV4::Function *);
+    // With type feedback, the function is recompiled to specialize on the state its lookups
+    // have reached when running the previously generated code.
+    BaselineJIT(QV4::Function *, bool useTypeFeedback = false);
     virtual ~BaselineJIT() Q_DECL_OVERRIDE;
 
     void generate();
 
+    // Generates code without installing it. Returns false if it cannot be relocated.
+    bool generateRelocatable(RelocatableCode *code);
+    static bool loadRelocatable(Function *function, const CompiledData::NativeCodeHeader *section,
+                                const CompiledData::NativeCodeFunction *code);
+    // Relocatable code can only be loaded if this matches
+    static QByteArray relocatableBuildHash(ExecutionEngine *engine);
+
     void generate_Ret() override;
     void generate_Debug() override;
     void generate_LoadConst(int index) override;
@@ -210,9 +227,15 @@ public:
     void endInstruction(Moth::Instr::Type instr) override;
 
 private:
+    void generateCode();
+    void addLoopHeader(int offset);
+
     QV4::Function *function;
     QScopedPointer<BaselineAssembler> as;
     QSet<int> labels;
+    std::vector<int> loopHeaders;
+    bool needsWriteBarrier;
+    bool useTypeFeedback;
 };
 
 } // namespace JIT
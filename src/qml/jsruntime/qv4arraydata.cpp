@@ -139,6 +139,10 @@ void ArrayData::realloc(Object *o, Type newType, uint requested, bool enforceAtt
     }
     newData->setAlloc(alloc);
     newData->setType(newType);
+    if (newType != Heap::ArrayData::Simple)
+        newData->d()->elementKind = Heap::ArrayData::Generic;
+    else if (d)
+        newData->d()->elementKind = d->d()->elementKind;
     newData->setAttrs(enforceAttributes ? reinterpret_cast<PropertyAttributes *>(newData->d()->values.values + alloc) : nullptr);
     o->setArrayData(newData);
 
@@ -228,6 +232,8 @@ bool SimpleArrayData::put(Object *o, uint index, const Value &value)
     Heap::SimpleArrayData *dd = o->d()->arrayData.cast<Heap::SimpleArrayData>();
     Q_ASSERT(index >= dd->values.size || !dd->attrs || !dd->attrs[index].isAccessor());
     // ### honour attributes
+    if (index > dd->values.size)
+        dd->elementKind = Heap::ArrayData::Generic; // leaves a gap
     dd->setData(o->engine(), index, value);
     if (index >= dd->values.size) {
         if (dd->attrs)
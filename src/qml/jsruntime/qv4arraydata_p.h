@@ -92,7 +92,7 @@ namespace Heap {
 
 #define ArrayDataMembers(class, Member) \
     Member(class, NoMark, ushort, type) \
-    Member(class, NoMark, ushort, unused) \
+    Member(class, NoMark, ushort, elementKind) \
     Member(class, NoMark, uint, offset) \
     Member(class, NoMark, PropertyAttributes *, attrs) \
     Member(class, NoMark, SparseArray *, sparse) \
@@ -103,8 +103,18 @@ DECLARE_HEAP_OBJECT(ArrayData, Base) {
 
     enum Type { Simple = 0, Sparse = 1, Custom = 2 };
 
+    // What the first values.size elements of Simple array data hold. Packed kinds have no
+    // holes. The kind only ever moves towards Generic, which is what Sparse data always is.
+    enum ElementKind { PackedInt32 = 0, PackedDouble = 1, Generic = 2 };
+
     bool isSparse() const { return type == Sparse; }
 
+    void updateElementKind(Value v) {
+        if (elementKind == Generic || v.isInteger())
+            return;
+        elementKind = v.isDouble() ? PackedDouble : Generic;
+    }
+
     const ArrayVTable *vtable() const { return reinterpret_cast<const ArrayVTable *>(internalClass->vtable); }
 
     inline ReturnedValue get(uint i) const {
@@ -125,6 +135,7 @@ DECLARE_HEAP_OBJECT(ArrayData, Base) {
 
     void setArrayData(EngineBase *e, uint index, Value newVal) {
         values.set(e, index, newVal);
+        updateElementKind(newVal);
     }
 
     uint mappedIndex(uint index) const;
@@ -136,6 +147,7 @@ struct SimpleArrayData : public ArrayData {
     const Value &data(uint index) const { return values[mappedIndex(index)]; }
     void setData(EngineBase *e, uint index, Value newVal) {
         values.set(e, mappedIndex(index), newVal);
+        updateElementKind(newVal);
     }
 
     PropertyAttributes attributes(uint i) const {
@@ -180,6 +192,8 @@ struct Q_QML_EXPORT ArrayData : public Managed
     void setAlloc(uint a) { d()->values.alloc = a; }
     Type type() const { return static_cast<Type>(d()->type); }
     void setType(Type t) { d()->type = t; }
+    Heap::ArrayData::ElementKind elementKind() const
+    { return static_cast<Heap::ArrayData::ElementKind>(d()->elementKind); }
     PropertyAttributes *attrs() const { return d()->attrs; }
     void setAttrs(PropertyAttributes *a) { d()->attrs = a; }
     const Value *arrayData() const { return d()->values.data(); }
@@ -301,6 +315,7 @@ void ArrayData::setProperty(QV4::EngineBase *e, uint index, const Property *p)
     uint mapped = mappedIndex(index);
     Q_ASSERT(mapped != UINT_MAX);
     values.set(e, mapped, p->value);
+    updateElementKind(p->value);
     if (attributes(index).isAccessor())
         values.set(e, mapped + 1 /*QV4::Object::SetterOffset*/, p->set);
 }
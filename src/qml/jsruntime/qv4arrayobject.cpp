@@ -51,6 +51,9 @@
 #include <QtCore/qscopedvaluerollback.h>
 #include "qv4proxy_p.h"
 
+#include <cmath>
+#include <limits>
+
 using namespace QV4;
 
 DEFINE_OBJECT_VTABLE(ArrayCtor);
@@ -597,6 +600,61 @@ ReturnedValue ArrayPrototype::method_findIndex(const FunctionObject *b, const Va
     return Encode(-1);
 }
 
+// Returns the array data if it only holds numbers, without holes. Elements up to
+// values.size can then be read directly: there are no getters and the prototype chain
+// can't interfere.
+static const Heap::SimpleArrayData *packedNumbers(Object *instance)
+{
+    const Heap::ArrayData *d = instance->d()->arrayData;
+    if (!d || d->type != Heap::ArrayData::Simple || d->elementKind == Heap::ArrayData::Generic
+            || ArgumentsObject::isNonStrictArgumentsObject(instance)) {
+        return nullptr;
+    }
+    return static_cast<const Heap::SimpleArrayData *>(d);
+}
+
+static inline double packedNumberAt(const Heap::SimpleArrayData *sa, uint index)
+{
+    const Value &v = sa->data(index);
+    if (sa->elementKind == Heap::ArrayData::PackedInt32 || v.isInteger())
+        return v.int_32();
+    return v.doubleValue();
+}
+
+// Strict equality (or SameValueZero for includes()) on packed number arrays.
+static qint64 indexOfPackedNumber(const Heap::SimpleArrayData *sa, double needle, uint from,
+                                  uint end, bool sameValueZero)
+{
+    if (std::isnan(needle)) {
+        if (!sameValueZero || sa->elementKind == Heap::ArrayData::PackedInt32)
+            return -1;
+        for (uint i = from; i < end; ++i) {
+            if (std::isnan(packedNumberAt(sa, i)))
+                return i;
+        }
+        return -1;
+    }
+
+    if (sa->elementKind == Heap::ArrayData::PackedInt32) {
+        if (needle < std::numeric_limits<int>::min() || needle > std::numeric_limits<int>::max())
+            return -1;
+        const int i32 = static_cast<int>(needle);
+        if (i32 != needle)
+            return -1;
+        for (uint i = from; i < end; ++i) {
+            if (sa->data(i).int_32() == i32)
+                return i;
+        }
+        return -1;
+    }
+
+    for (uint i = from; i < end; ++i) {
+        if (packedNumberAt(sa, i) == needle)
+            return i;
+    }
+    return -1;
+}
+
 ReturnedValue ArrayPrototype::method_join(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
 {
     Scope scope(b);
@@ -623,15 +681,40 @@ ReturnedValue ArrayPrototype::method_join(const FunctionObject *b, const Value *
 
     // ### FIXME
     if (ArrayObject *a = instance->as<ArrayObject>()) {
+        const Heap::SimpleArrayData *sa = packedNumbers(a);
+        if (sa && sa->elementKind == Heap::ArrayData::PackedInt32
+                && a->getLength() <= sa->values.size) {
+            const uint len = a->getLength();
+            for (uint i = 0; i < len; ++i) {
+                if (i)
+                    R += r4;
+                R += QString::number(sa->data(i).int_32());
+            }
+            return Encode(scope.engine->newString(R));
+        }
+
+        // Convert the elements first, so that the result can be allocated in one go.
+        QVector<QString> parts;
+        parts.reserve(int(qMin(a->getLength(), 1024u)));
+        qint64 resultLength = 0;
         ScopedValue e(scope);
         for (uint i = 0; i < a->getLength(); ++i) {
-            if (i)
-                R += r4;
-
             e = a->get(i);
             CHECK_EXCEPTION();
-            if (!e->isNullOrUndefined())
-                R += e->toQString();
+            parts.append(e->isNullOrUndefined() ? QString() : e->toQString());
+            resultLength += parts.last().size();
+        }
+
+        if (!parts.isEmpty())
+            resultLength += qint64(parts.size() - 1) * r4.size();
+        if (resultLength > std::numeric_limits<int>::max())
+            return scope.engine->throwRangeError(QStringLiteral("Invalid string length"));
+
+        R.reserve(int(resultLength));
+        for (int i = 0; i < parts.size(); ++i) {
+            if (i)
+                R += r4;
+            R += parts.at(i);
         }
     } else {
         //
@@ -1050,6 +1133,17 @@ ReturnedValue ArrayPrototype::method_includes(const FunctionObject *b, const Val
         }
     }
 
+    // Holes read as undefined here, so the packed range is only enough if it covers len.
+    if (argc && argv[0].isNumber() && !instance->protoHasArray()) {
+        const Heap::SimpleArrayData *sa = packedNumbers(instance);
+        if (sa && len <= sa->values.size) {
+            if (k >= len)
+                return Encode(false);
+            return Encode(indexOfPackedNumber(sa, argv[0].asDouble(), uint(k), uint(len),
+                                              true) != -1);
+        }
+    }
+
     while (k < len) {
         ScopedValue val(scope, instance->get(k));
         if (val->sameValueZero(argv[0])) {
@@ -1098,6 +1192,15 @@ ReturnedValue ArrayPrototype::method_indexOf(const FunctionObject *b, const Valu
 
     ScopedValue value(scope);
 
+    if (searchValue->isNumber() && !instance->protoHasArray()) {
+        if (const Heap::SimpleArrayData *sa = packedNumbers(instance)) {
+            // Anything beyond values.size is a hole and can't match.
+            const qint64 idx = indexOfPackedNumber(sa, searchValue->asDouble(), fromIndex,
+                                                   qMin(len, sa->values.size), false);
+            return idx < 0 ? Encode(-1) : Encode(uint(idx));
+        }
+    }
+
     if (ArgumentsObject::isNonStrictArgumentsObject(instance) ||
         (instance->arrayType() >= Heap::ArrayData::Sparse) || instance->protoHasArray()) {
         // lets be safe and slow
@@ -1171,6 +1274,18 @@ ReturnedValue ArrayPrototype::method_lastIndexOf(const FunctionObject *b, const
         fromIndex = (uint) f + 1;
     }
 
+    if (searchValue->isNumber() && !instance->protoHasArray()) {
+        if (const Heap::SimpleArrayData *sa = packedNumbers(instance)) {
+            const double needle = searchValue->asDouble();
+            for (uint k = qMin(fromIndex, sa->values.size); k > 0;) {
+                --k;
+                if (packedNumberAt(sa, k) == needle)
+                    return Encode(k);
+            }
+            return Encode(-1);
+        }
+    }
+
     ScopedValue v(scope);
     for (uint k = fromIndex; k > 0;) {
         --k;
@@ -49,7 +49,8 @@ QT_BEGIN_NAMESPACE
 using namespace QV4;
 
 CompilationUnitMapper::CompilationUnitMapper()
-    : dataPtr(nullptr)
+    : length(0)
+    , dataPtr(nullptr)
 {
 
 }
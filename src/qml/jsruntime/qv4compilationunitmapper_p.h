@@ -71,10 +71,11 @@ public:
     CompiledData::Unit *open(const QString &cacheFilePath, const QDateTime &sourceTimeStamp, QString *errorString);
     void close();
 
+    // Anything stored in the file after the unit, like JIT generated code
+    const char *trailingData(quint32 unitSize, size_t *size) const;
+
 private:
-#if defined(Q_OS_UNIX)
     size_t length;
-#endif
     void *dataPtr;
 };
 
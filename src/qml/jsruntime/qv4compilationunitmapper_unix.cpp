@@ -90,6 +90,16 @@ CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, co
     return reinterpret_cast<CompiledData::Unit*>(dataPtr);
 }
 
+const char *CompilationUnitMapper::trailingData(quint32 unitSize, size_t *size) const
+{
+    if (!dataPtr || length <= unitSize) {
+        *size = 0;
+        return nullptr;
+    }
+    *size = length - unitSize;
+    return static_cast<const char *>(dataPtr) + unitSize;
+}
+
 void CompilationUnitMapper::close()
 {
     // Do not unmap the data here.
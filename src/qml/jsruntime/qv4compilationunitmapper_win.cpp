@@ -92,6 +92,13 @@ CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, co
 
     // Data structure and qt version matched, so now we can access the rest of the file safely.
 
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        *errorString = qt_error_string(GetLastError());
+        return nullptr;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+
     HANDLE fileMappingHandle = CreateFileMapping(handle, 0, PAGE_READONLY, 0, 0, 0);
     if (!fileMappingHandle) {
         *errorString = qt_error_string(GetLastError());
@@ -111,6 +118,16 @@ CompiledData::Unit *CompilationUnitMapper::open(const QString &cacheFileName, co
     return reinterpret_cast<CompiledData::Unit*>(dataPtr);
 }
 
+const char *CompilationUnitMapper::trailingData(quint32 unitSize, size_t *size) const
+{
+    if (!dataPtr || length <= unitSize) {
+        *size = 0;
+        return nullptr;
+    }
+    *size = length - unitSize;
+    return static_cast<const char *>(dataPtr) + unitSize;
+}
+
 void CompilationUnitMapper::close()
 {
     if (dataPtr != nullptr) {
@@ -47,6 +47,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QLoggingCategory>
+#include <QVarLengthArray>
 #if QT_CONFIG(regularexpression)
 #include <QRegularExpression>
 #endif
@@ -141,6 +142,8 @@ using namespace QV4;
 
 static QBasicAtomicInt engineSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
 
+Q_LOGGING_CATEGORY(lcLookupStats, "qt.qml.lookup.statistics")
+
 ReturnedValue throwTypeError(const FunctionObject *b, const QV4::Value *, const QV4::Value *, int)
 {
     return b->engine()->throwTypeError();
@@ -185,9 +188,138 @@ static void restoreJSValue(QDataStream &stream, void *data)
     }
 }
 
+namespace {
+
+// The members the ExecutionEngine constructor adds to a builtin object, in the order it adds them
+struct BuiltinObjectLayout
+{
+    struct Member {
+        QString name;
+        int symbol; // index into jsSymbols, or -1 if the key is the name
+        PropertyAttributes attributes;
+    };
+
+    uint initialSize = UINT_MAX; // UINT_MAX if there is no layout for the object
+    uint finalSize = 0;
+    QVector<Member> members;
+};
+
+// Recorded by the first engine of the process, and only read afterwards
+struct BuiltinObjectLayouts
+{
+    ~BuiltinObjectLayouts() { delete layouts.loadAcquire(); }
+    QAtomicPointer<const QVector<BuiltinObjectLayout>> layouts;
+};
+
+}
+
+Q_GLOBAL_STATIC(BuiltinObjectLayouts, builtinObjectLayouts)
+
+// The builtin objects that receive their members from a layout. The order has to be the same in
+// all engines.
+static QVector<Value *> builtinObjects(ExecutionEngine *engine)
+{
+    QVector<Value *> objects;
+    objects.reserve(ExecutionEngine::NJSObjects + 2 * ExecutionEngine::NTypedArrayTypes + 1);
+    for (int i = ExecutionEngine::ObjectProto; i < ExecutionEngine::NJSObjects; ++i)
+        objects.append(engine->jsObjects + i);
+    for (int i = 0; i < ExecutionEngine::NTypedArrayTypes; ++i) {
+        objects.append(engine->typedArrayCtors + i);
+        objects.append(engine->typedArrayPrototype + i);
+    }
+    objects.append(engine->globalObject);
+    return objects;
+}
+
+static QVector<uint> builtinObjectSizes(const QVector<Value *> &objects)
+{
+    QVector<uint> sizes;
+    sizes.reserve(objects.size());
+    for (const Value *v : objects) {
+        const Object *o = v->as<Object>();
+        sizes.append(o ? o->internalClass()->size : UINT_MAX);
+    }
+    return sizes;
+}
+
+static void applyBuiltinObjectLayouts(ExecutionEngine *engine, const QVector<Value *> &objects,
+                                      const QVector<BuiltinObjectLayout> &layouts)
+{
+    Q_ASSERT(objects.size() == layouts.size());
+    for (int i = 0, end = objects.size(); i < end; ++i) {
+        const BuiltinObjectLayout &layout = layouts.at(i);
+        Object *o = objects.at(i)->as<Object>();
+        if (!o || layout.members.isEmpty() || o->internalClass()->size != layout.initialSize)
+            continue;
+
+        Scope scope(engine);
+        const int count = layout.members.size();
+        Value *names = scope.alloc(count);
+        QVarLengthArray<PropertyKey, 64> identifiers(count);
+        QVarLengthArray<PropertyAttributes, 64> attributes(count);
+        for (int j = 0; j < count; ++j) {
+            const BuiltinObjectLayout::Member &member = layout.members.at(j);
+            if (member.symbol >= 0) {
+                identifiers[j] = reinterpret_cast<Symbol *>(engine->jsSymbols + member.symbol)->propertyKey();
+            } else {
+                Heap::String *name = engine->identifierTable->insertSharedString(member.name);
+                if (!name)
+                    name = engine->identifierTable->insertString(member.name);
+                names[j] = name;
+                identifiers[j] = name->identifier;
+            }
+            attributes[j] = member.attributes;
+        }
+
+        Scoped<InternalClass> ic(scope, o->internalClass()->addMembers(
+                                     &layout, identifiers.constData(), attributes.constData(), count));
+        o->setInternalClass(ic->d());
+    }
+}
+
+static QVector<BuiltinObjectLayout> *recordBuiltinObjectLayouts(ExecutionEngine *engine, const QVector<Value *> &objects,
+                                                                const QVector<uint> &initialSizes)
+{
+    Q_ASSERT(objects.size() == initialSizes.size());
+    QVector<BuiltinObjectLayout> *layouts = new QVector<BuiltinObjectLayout>(objects.size());
+    for (int i = 0, end = objects.size(); i < end; ++i) {
+        const Object *o = objects.at(i)->as<Object>();
+        if (!o || initialSizes.at(i) == UINT_MAX)
+            continue;
+
+        Heap::InternalClass *ic = o->internalClass();
+        BuiltinObjectLayout layout;
+        layout.initialSize = initialSizes.at(i);
+        layout.finalSize = ic->size;
+        bool valid = layout.initialSize <= ic->size;
+        for (uint index = layout.initialSize; valid && index < ic->size; ++index) {
+            const PropertyKey key = ic->nameMap.at(index);
+            if (!key.isValid())
+                continue; // the setter slot of an accessor
+            BuiltinObjectLayout::Member member = { QString(), -1, ic->propertyData.at(index) };
+            if (member.attributes.isEmpty()) {
+                // removed again
+                valid = false;
+            } else if (key.isSymbol()) {
+                for (int symbol = 0; symbol < ExecutionEngine::NJSSymbols; ++symbol) {
+                    if (reinterpret_cast<Symbol *>(engine->jsSymbols + symbol)->propertyKey() == key)
+                        member.symbol = symbol;
+                }
+                valid = member.symbol >= 0;
+            } else {
+                member.name = key.toQString();
+            }
+            layout.members.append(member);
+        }
+        if (valid)
+            (*layouts)[i] = layout;
+    }
+    return layouts;
+}
+
 ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
     : executableAllocator(new QV4::ExecutableAllocator)
-    , regExpAllocator(new QV4::ExecutableAllocator)
+    , regExpAllocator(QV4::SharedRegExpCode::acquireAllocator())
     , bumperPointerAllocator(new WTF::BumpPointerAllocator)
     , jsStack(new WTF::PageAllocation)
     , gcStack(new WTF::PageAllocation)
@@ -257,6 +389,22 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
             jitCallCountThreshold = 3;
         if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER"))
             jitCallCountThreshold = std::numeric_limits<int>::max();
+
+        ok = false;
+        jitOptimizeCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_OPTIMIZE_CALL_THRESHOLD", &ok);
+        if (!ok)
+            jitOptimizeCallCountThreshold = 100;
+
+        ok = false;
+        jitOsrBackEdgeThreshold = qEnvironmentVariableIntValue("QV4_JIT_OSR_THRESHOLD", &ok);
+        if (!ok)
+            jitOsrBackEdgeThreshold = 1000;
+        jitOsrEnabled = !qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER");
+
+        jitDiskCache = qEnvironmentVariableIsSet("QV4_JIT_DISK_CACHE")
+                && !qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER");
+
+        lazyFunctionCompilation = qEnvironmentVariableIsSet("QV4_LAZY_FUNCTION_COMPILATION");
     }
 
     exceptionValue = jsAlloca(1);
@@ -532,6 +680,44 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
 
     str = newString(QStringLiteral("get [Symbol.species]"));
     jsObjects[GetSymbolSpecies] = FunctionObject::createBuiltinFunction(this, str, ArrayPrototype::method_get_species, 0);
+    // all builtin functions share the class of this one, as they only carry a name and a length
+    classes[Class_BuiltinFunction] = jsObjects[GetSymbolSpecies].as<FunctionObject>()->internalClass();
+
+    jsObjects[WeakMap_Ctor] = memoryManager->allocate<WeakMapCtor>(global);
+    jsObjects[WeakMapProto] = memoryManager->allocate<WeakMapPrototype>();
+    jsObjects[Map_Ctor] = memoryManager->allocate<MapCtor>(global);
+    jsObjects[MapProto] = memoryManager->allocate<MapPrototype>();
+    jsObjects[WeakSet_Ctor] = memoryManager->allocate<WeakSetCtor>(global);
+    jsObjects[WeakSetProto] = memoryManager->allocate<WeakSetPrototype>();
+    jsObjects[Set_Ctor] = memoryManager->allocate<SetCtor>(global);
+    jsObjects[SetProto] = memoryManager->allocate<SetPrototype>();
+    jsObjects[Promise_Ctor] = memoryManager->allocate<PromiseCtor>(global);
+    jsObjects[PromiseProto] = memoryManager->allocate<PromisePrototype>();
+    jsObjects[SharedArrayBuffer_Ctor] = memoryManager->allocate<SharedArrayBufferCtor>(global);
+    jsObjects[SharedArrayBufferProto] = memoryManager->allocate<SharedArrayBufferPrototype>();
+    jsObjects[ArrayBuffer_Ctor] = memoryManager->allocate<ArrayBufferCtor>(global);
+    jsObjects[ArrayBufferProto] = memoryManager->allocate<ArrayBufferPrototype>();
+    jsObjects[DataView_Ctor] = memoryManager->allocate<DataViewCtor>(global);
+    jsObjects[DataViewProto] = memoryManager->allocate<DataViewPrototype>();
+    jsObjects[ValueTypeProto] = (Heap::Base *) nullptr;
+    jsObjects[SignalHandlerProto] = (Heap::Base *) nullptr;
+    jsObjects[IntrinsicTypedArray_Ctor] = memoryManager->allocate<IntrinsicTypedArrayCtor>(global);
+    jsObjects[IntrinsicTypedArrayProto] = memoryManager->allocate<IntrinsicTypedArrayPrototype>();
+    for (int i = 0; i < NTypedArrayTypes; ++i) {
+        static_cast<Value &>(typedArrayCtors[i]) = memoryManager->allocate<TypedArrayCtor>(global, Heap::TypedArray::Type(i));
+        static_cast<Value &>(typedArrayPrototype[i]) = memoryManager->allocate<TypedArrayPrototype>(Heap::TypedArray::Type(i));
+    }
+
+    // The builtin objects end up with the same members in every engine. Once the first engine of
+    // the process has set them up, the others give each object its final class right away, and the
+    // init() functions below only fill in the values.
+    const QVector<Value *> builtins = builtinObjects(this);
+    const QVector<BuiltinObjectLayout> *layouts = builtinObjectLayouts()->layouts.loadAcquire();
+    QVector<uint> builtinSizes;
+    if (layouts)
+        applyBuiltinObjectLayouts(this, builtins, *layouts);
+    else
+        builtinSizes = builtinObjectSizes(builtins);
 
     static_cast<ObjectPrototype *>(objectPrototype())->init(this, objectCtor());
     static_cast<StringPrototype *>(stringPrototype())->init(this, stringCtor());
@@ -565,56 +751,22 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
     sequencePrototype()->cast<SequencePrototype>()->init();
 #endif
 
-    jsObjects[WeakMap_Ctor] = memoryManager->allocate<WeakMapCtor>(global);
-    jsObjects[WeakMapProto] = memoryManager->allocate<WeakMapPrototype>();
     static_cast<WeakMapPrototype *>(weakMapPrototype())->init(this, weakMapCtor());
-
-    jsObjects[Map_Ctor] = memoryManager->allocate<MapCtor>(global);
-    jsObjects[MapProto] = memoryManager->allocate<MapPrototype>();
     static_cast<MapPrototype *>(mapPrototype())->init(this, mapCtor());
-
-    jsObjects[WeakSet_Ctor] = memoryManager->allocate<WeakSetCtor>(global);
-    jsObjects[WeakSetProto] = memoryManager->allocate<WeakSetPrototype>();
     static_cast<WeakSetPrototype *>(weakSetPrototype())->init(this, weakSetCtor());
-
-    jsObjects[Set_Ctor] = memoryManager->allocate<SetCtor>(global);
-    jsObjects[SetProto] = memoryManager->allocate<SetPrototype>();
     static_cast<SetPrototype *>(setPrototype())->init(this, setCtor());
-
-    //
-    // promises
-    //
-
-    jsObjects[Promise_Ctor] = memoryManager->allocate<PromiseCtor>(global);
-    jsObjects[PromiseProto] = memoryManager->allocate<PromisePrototype>();
     static_cast<PromisePrototype *>(promisePrototype())->init(this, promiseCtor());
 
     // typed arrays
 
-    jsObjects[SharedArrayBuffer_Ctor] = memoryManager->allocate<SharedArrayBufferCtor>(global);
-    jsObjects[SharedArrayBufferProto] = memoryManager->allocate<SharedArrayBufferPrototype>();
     static_cast<SharedArrayBufferPrototype *>(sharedArrayBufferPrototype())->init(this, sharedArrayBufferCtor());
-
-    jsObjects[ArrayBuffer_Ctor] = memoryManager->allocate<ArrayBufferCtor>(global);
-    jsObjects[ArrayBufferProto] = memoryManager->allocate<ArrayBufferPrototype>();
     static_cast<ArrayBufferPrototype *>(arrayBufferPrototype())->init(this, arrayBufferCtor());
-
-    jsObjects[DataView_Ctor] = memoryManager->allocate<DataViewCtor>(global);
-    jsObjects[DataViewProto] = memoryManager->allocate<DataViewPrototype>();
     static_cast<DataViewPrototype *>(dataViewPrototype())->init(this, dataViewCtor());
-    jsObjects[ValueTypeProto] = (Heap::Base *) nullptr;
-    jsObjects[SignalHandlerProto] = (Heap::Base *) nullptr;
-
-    jsObjects[IntrinsicTypedArray_Ctor] = memoryManager->allocate<IntrinsicTypedArrayCtor>(global);
-    jsObjects[IntrinsicTypedArrayProto] = memoryManager->allocate<IntrinsicTypedArrayPrototype>();
     static_cast<IntrinsicTypedArrayPrototype *>(intrinsicTypedArrayPrototype())
             ->init(this, static_cast<IntrinsicTypedArrayCtor *>(intrinsicTypedArrayCtor()));
 
-    for (int i = 0; i < NTypedArrayTypes; ++i) {
-        static_cast<Value &>(typedArrayCtors[i]) = memoryManager->allocate<TypedArrayCtor>(global, Heap::TypedArray::Type(i));
-        static_cast<Value &>(typedArrayPrototype[i]) = memoryManager->allocate<TypedArrayPrototype>(Heap::TypedArray::Type(i));
+    for (int i = 0; i < NTypedArrayTypes; ++i)
         typedArrayPrototype[i].as<TypedArrayPrototype>()->init(this, static_cast<TypedArrayCtor *>(typedArrayCtors[i].as<Object>()));
-    }
 
     //
     // set up the global object
@@ -716,12 +868,40 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
 
     QV4::QObjectWrapper::initializeBindings(this);
 
+    if (!layouts) {
+        QVector<BuiltinObjectLayout> *recorded = recordBuiltinObjectLayouts(this, builtins, builtinSizes);
+        if (!builtinObjectLayouts()->layouts.testAndSetOrdered(nullptr, recorded))
+            delete recorded;
+    }
+#if !defined(QT_NO_DEBUG) || defined(QT_FORCE_ASSERTS)
+    else {
+        // The init() functions must not add any members beyond the ones in the layouts
+        for (int i = 0, end = builtins.size(); i < end; ++i) {
+            const BuiltinObjectLayout &layout = layouts->at(i);
+            Q_ASSERT(layout.initialSize == UINT_MAX || layout.members.isEmpty()
+                     || builtins.at(i)->as<Object>()->internalClass()->size == layout.finalSize);
+        }
+    }
+#endif
+
     m_delayedCallQueue.init(this);
 }
 
 ExecutionEngine::~ExecutionEngine()
 {
+    if (lcLookupStats().isDebugEnabled()) {
+        const QLoggingCategory &stats = lcLookupStats();
+        qDebug(stats) << "Lookup statistics:";
+        qDebug(stats) << "Polymorphic lookups:" << lookupStatistics.polymorphicLookups;
+        qDebug(stats) << "Shapes recorded by polymorphic lookups:" << lookupStatistics.polymorphicEntries;
+        qDebug(stats) << "Hits in polymorphic lookups:" << lookupStatistics.polymorphicHits;
+        qDebug(stats) << "Megamorphic lookups:" << lookupStatistics.megamorphicLookups;
+    }
+
     modules.clear();
+    // Regenerating the code for the disk cache requires the functions to be fully alive
+    for (ExecutableCompilationUnit *unit : compilationUnits)
+        unit->saveNativeCodeToDisk();
     qDeleteAll(m_extensionData);
     delete m_multiplyWrappedQObjects;
     m_multiplyWrappedQObjects = nullptr;
@@ -733,7 +913,7 @@ ExecutionEngine::~ExecutionEngine()
 
     delete bumperPointerAllocator;
     delete regExpCache;
-    delete regExpAllocator;
+    SharedRegExpCode::releaseAllocator();
     delete executableAllocator;
     jsStack->deallocate();
     delete jsStack;
@@ -862,6 +1042,8 @@ Heap::ArrayObject *ExecutionEngine::newArrayObject(const Value *values, int leng
         // this doesn't require a write barrier, things will be ok, when the new array data gets inserted into
         // the parent object
         memcpy(&d->values.values, values, length*sizeof(Value));
+        for (int i = 0; i < length && d->elementKind != Heap::ArrayData::Generic; ++i)
+            d->updateElementKind(values[i]);
         a->d()->arrayData.set(this, d);
         a->setArrayLengthUnchecked(length);
     }
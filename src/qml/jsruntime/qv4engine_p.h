@@ -165,7 +165,7 @@ private:
     friend struct Heap::ExecutionContext;
 public:
     ExecutableAllocator *executableAllocator;
-    ExecutableAllocator *regExpAllocator;
+    ExecutableAllocator *regExpAllocator; // Shared by all engines, see SharedRegExpCode
 
     WTF::BumpPointerAllocator *bumperPointerAllocator; // Used by Yarr Regex engine.
 
@@ -655,6 +655,27 @@ public:
 #endif
     }
 
+    // Hot functions get recompiled, using the type feedback gathered by the lookups meanwhile
+    bool canOptimize(Function *f) const
+    {
+#if QT_CONFIG(qml_jit)
+        return !f->hasOptimizedCode && f->baselineCallCount >= jitOptimizeCallCountThreshold;
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
+    // Number of loop iterations after which an interpreted frame continues in JIT code
+    bool osrEnabled() const { return jitOsrEnabled; }
+    int osrBackEdgeThreshold() const { return jitOsrBackEdgeThreshold; }
+
+    // JIT code of compilation units loaded from the disk cache is stored next to them
+    bool jitDiskCacheEnabled() const { return jitDiskCache; }
+
+    // Code compiled from source defers generating the bytecode of functions to their first call
+    bool lazyFunctionCompilationEnabled() const { return lazyFunctionCompilation; }
+
     QV4::ReturnedValue global();
     void initQmlGlobalObject();
     void initializeGlobal();
@@ -697,6 +718,14 @@ public:
 
     double localTZA = 0.0; // local timezone, initialized at startup
 
+    // Collected by the property lookups, printed on destruction with qt.qml.lookup.statistics
+    struct LookupStatistics {
+        quint64 polymorphicLookups = 0; // lookups that have seen more than two shapes
+        quint64 polymorphicEntries = 0; // shapes recorded by those lookups
+        quint64 polymorphicHits = 0;
+        quint64 megamorphicLookups = 0; // lookups that have given up on caching shapes
+    } lookupStatistics;
+
     QQmlRefPointer<ExecutableCompilationUnit> compileModule(const QUrl &url);
     QQmlRefPointer<ExecutableCompilationUnit> compileModule(
             const QUrl &url, const QString &sourceCode, const QDateTime &sourceTimeStamp);
@@ -714,6 +743,11 @@ private:
 #endif
     QSet<QString> m_illegalNames;
     int jitCallCountThreshold;
+    int jitOptimizeCallCountThreshold;
+    int jitOsrBackEdgeThreshold;
+    bool jitOsrEnabled;
+    bool jitDiskCache;
+    bool lazyFunctionCompilation;
 
     // used by generated Promise objects to handle 'then' events
     QScopedPointer<QV4::Promise::ReactionHandler> m_reactionHandler;
@@ -84,7 +84,9 @@ struct Q_QML_EXPORT EngineBase {
 #endif
 
     quint8 isExecutingInRegExpJIT = false;
-    quint8 padding[3];
+    // set by the memory manager when it needs modified heap objects to be recorded
+    quint8 writeBarrierActive = false;
+    quint8 padding[2];
     MemoryManager *memoryManager = nullptr;
     Runtime runtime;
 
@@ -132,6 +134,7 @@ struct Q_QML_EXPORT EngineBase {
         Class_ProxyObject,
         Class_ProxyFunctionObject,
         Class_Symbol,
+        Class_BuiltinFunction,
         NClasses
     };
     Heap::InternalClass *classes[NClasses];
@@ -52,6 +52,9 @@
 #include <private/qv4module_p.h>
 #include <private/qv4compilationunitmapper_p.h>
 #include <private/qml_compile_hash_p.h>
+#if QT_CONFIG(qml_jit)
+#include <private/qv4baselinejit_p.h>
+#endif
 
 #include <QtQml/qqmlfile.h>
 #include <QtQml/qqmlpropertymap.h>
@@ -61,6 +64,8 @@
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qscopeguard.h>
 #include <QtCore/qcryptographichash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/private/qsimd_p.h>
 
 #if defined(QML_COMPILE_HASH)
 #  ifdef Q_OS_LINUX
@@ -77,6 +82,8 @@ static_assert(sizeof(QV4::CompiledData::Unit::libraryVersionHash) >= QML_COMPILE
 
 QT_BEGIN_NAMESPACE
 
+Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
+
 namespace QV4 {
 
 ExecutableCompilationUnit::ExecutableCompilationUnit() = default;
@@ -138,21 +145,18 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
     runtimeStrings = (QV4::Heap::String **)malloc(stringCount * sizeof(QV4::Heap::String*));
     // memset the strings to 0 in case a GC run happens while we're within the loop below
     memset(runtimeStrings, 0, stringCount * sizeof(QV4::Heap::String*));
-    for (uint i = 0; i < stringCount; ++i)
-        runtimeStrings[i] = engine->newString(stringAt(i));
+    // Share the text and hash of the strings with other engines, see SharedIdentifierTable
+    for (uint i = 0; i < stringCount; ++i) {
+        const QString string = stringAt(i);
+        Heap::String *shared = engine->identifierTable->insertSharedString(string);
+        runtimeStrings[i] = shared ? shared : engine->newString(string);
+    }
 
+    // Regular expressions are compiled on first use, see runtimeRegularExpression().
     runtimeRegularExpressions
             = new QV4::Value[data->regexpTableSize];
-    // memset the regexps to 0 in case a GC run happens while we're within the loop below
     memset(runtimeRegularExpressions, 0,
            data->regexpTableSize * sizeof(QV4::Value));
-    for (uint i = 0; i < data->regexpTableSize; ++i) {
-        const CompiledData::RegExp *re = data->regexpAt(i);
-        uint f = re->flags;
-        const CompiledData::RegExp::Flags flags = static_cast<CompiledData::RegExp::Flags>(f);
-        runtimeRegularExpressions[i] = QV4::RegExp::create(
-                engine, stringAt(re->stringIndex), flags);
-    }
 
     if (data->lookupTableSize) {
         runtimeLookups = new QV4::Lookup[data->lookupTableSize];
@@ -205,6 +209,17 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
         runtimeFunctions[i] = QV4::Function::create(engine, this, compiledFunction);
     }
 
+    // Functions compiled to C++ can't be stepped through, so leave them to the debugger.
+    if (aotCompiledFunctions && !engine->debugger()) {
+        for (const QQmlPrivate::AOTCompiledFunction *aotFunction = aotCompiledFunctions;
+             aotFunction->index != -1; ++aotFunction) {
+            if (aotFunction->index < runtimeFunctions.size())
+                runtimeFunctions[aotFunction->index]->aotFunction = aotFunction;
+        }
+    }
+
+    loadNativeCode();
+
     Scope scope(engine);
     Scoped<InternalClass> ic(scope);
 
@@ -275,8 +290,10 @@ Heap::Object *ExecutableCompilationUnit::templateObjectAt(int index) const
 
 void ExecutableCompilationUnit::unlink()
 {
-    if (engine)
+    if (engine) {
+        saveNativeCodeToDisk();
         nextCompilationUnit.remove();
+    }
 
     if (isRegisteredWithEngine) {
         Q_ASSERT(data && propertyCaches.count() > 0 && propertyCaches.at(/*root object*/0));
@@ -289,24 +306,12 @@ void ExecutableCompilationUnit::unlink()
     propertyCaches.clear();
 
     if (runtimeLookups) {
-        for (uint i = 0; i < data->lookupTableSize; ++i) {
-            QV4::Lookup &l = runtimeLookups[i];
-            if (l.getter == QV4::QObjectWrapper::lookupGetter) {
-                if (QQmlPropertyCache *pc = l.qobjectLookup.propertyCache)
-                    pc->release();
-            } else if (l.getter == QQmlValueTypeWrapper::lookupGetter) {
-                if (QQmlPropertyCache *pc = l.qgadgetLookup.propertyCache)
-                    pc->release();
-            }
-
-            if (l.qmlContextPropertyGetter == QQmlContextWrapper::lookupScopeObjectProperty) {
-                if (QQmlPropertyCache *pc = l.qobjectLookup.propertyCache)
-                    pc->release();
-            }
-        }
+        for (uint i = 0; i < data->lookupTableSize; ++i)
+            runtimeLookups[i].releasePropertyCaches();
     }
 
     dependentScripts.clear();
+    lazilyCompiledUnits.clear();
 
     typeNameCache = nullptr;
 
@@ -331,6 +336,19 @@ void ExecutableCompilationUnit::unlink()
     runtimeClasses = nullptr;
 }
 
+Heap::RegExp *ExecutableCompilationUnit::runtimeRegularExpression(int index)
+{
+    Q_ASSERT(uint(index) < data->regexpTableSize);
+    if (const RegExp *regExp = Value::fromStaticValue(runtimeRegularExpressions[index]).as<RegExp>())
+        return regExp->d();
+
+    const CompiledData::RegExp *re = data->regexpAt(index);
+    const CompiledData::RegExp::Flags flags = static_cast<CompiledData::RegExp::Flags>(uint(re->flags));
+    Heap::RegExp *regExp = QV4::RegExp::create(engine, stringAt(re->stringIndex), flags);
+    runtimeRegularExpressions[index] = Value::fromHeapObject(regExp);
+    return regExp;
+}
+
 void ExecutableCompilationUnit::markObjects(QV4::MarkStack *markStack)
 {
     if (runtimeStrings) {
@@ -641,7 +659,8 @@ void ExecutableCompilationUnit::evaluateModuleRequests()
     }
 }
 
-bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString)
+bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp,
+                                             QString *errorString, bool lazyFunctionCompilation)
 {
     if (!QQmlFile::isLocalFile(url)) {
         *errorString = QStringLiteral("File has to be a local file.");
@@ -657,6 +676,13 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         if (!mappedUnit)
             continue;
 
+        // Stubs for lazily compiled functions are only acceptable to an engine that
+        // compiles lazily itself. Fully compiled units can be used either way.
+        if ((mappedUnit->flags & CompiledData::Unit::HasLazyFunctions) && !lazyFunctionCompilation) {
+            *errorString = QStringLiteral("Cached file was written with lazy function compilation enabled.");
+            continue;
+        }
+
         const CompiledData::Unit * const oldDataPtr
                 = (data && !(data->flags & QV4::CompiledData::Unit::StaticData)) ? data
                                                                                      : nullptr;
@@ -675,6 +701,9 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         dataPtrRevert.dismiss();
         free(const_cast<CompiledData::Unit*>(oldDataPtr));
         backingFile.reset(cacheFile.take());
+        // Files generated ahead of time are left alone
+        if (cachePath != cachePaths.first())
+            nativeCodeCacheFilePath = cachePath;
         return true;
     }
 
@@ -700,6 +729,191 @@ bool ExecutableCompilationUnit::saveToDisk(const QUrl &unitUrl, QString *errorSt
     });
 }
 
+#if QT_CONFIG(qml_jit)
+static const char nativeCodeMagic[] = "qv4code";
+
+static quint32 nativeCodeSectionOffset(quint32 unitSize)
+{
+    return (unitSize + 15) & ~15u;
+}
+
+// The code is patched and run as found in the file, so everything it points to has to stay
+// within the function's code. The table offsets were checked against the section already.
+static bool nativeCodeIsValid(const CompiledData::NativeCodeHeader *section,
+                              const CompiledData::NativeCodeFunction *code)
+{
+    const quint32 codeSize = code->codeSize;
+    if (codeSize == 0 || code->osrEntryOffset >= codeSize)
+        return false;
+
+    const CompiledData::NativeCodeRelocation *relocations
+            = code->relocationTable(reinterpret_cast<const char *>(section));
+    for (quint32 i = 0; i < code->nRelocations; ++i) {
+        const CompiledData::NativeCodeRelocation &relocation = relocations[i];
+        // The pointer is written right before the offset
+        if (relocation.offset < sizeof(void *) || relocation.offset > codeSize)
+            return false;
+        switch (relocation.kind) {
+        case CompiledData::NativeCodeRelocation::CodeAddress:
+            if (relocation.value >= codeSize)
+                return false;
+            break;
+        case CompiledData::NativeCodeRelocation::LibraryAddress:
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+void ExecutableCompilationUnit::loadNativeCode()
+{
+#if QT_CONFIG(qml_jit)
+    if (!engine->jitDiskCacheEnabled() || nativeCodeCacheFilePath.isEmpty() || !backingFile
+            || !engine->canJIT() || engine->debugger()) {
+        return;
+    }
+
+    size_t size = 0;
+    const char *trailingData = backingFile->trailingData(data->unitSize, &size);
+    const size_t padding = nativeCodeSectionOffset(data->unitSize) - data->unitSize;
+    if (size < padding + sizeof(CompiledData::NativeCodeHeader))
+        return;
+    size -= padding;
+
+    const auto *section = reinterpret_cast<const CompiledData::NativeCodeHeader *>(
+                trailingData + padding);
+    if (memcmp(section->magic, nativeCodeMagic, sizeof(section->magic)) != 0
+            || section->sectionSize > size || section->sectionSize < sizeof(*section)
+            || section->cpuFeatures != qCpuFeatures()) {
+        return;
+    }
+
+    const QByteArray buildHash = JIT::BaselineJIT::relocatableBuildHash(engine);
+    if (buildHash.size() != int(sizeof(section->buildHash))
+            || memcmp(section->buildHash, buildHash.constData(), sizeof(section->buildHash)) != 0) {
+        return;
+    }
+
+    const quint32 sectionSize = section->sectionSize;
+    if (section->nFunctions > (sectionSize - sizeof(CompiledData::NativeCodeHeader))
+            / sizeof(CompiledData::NativeCodeFunction)) {
+        return;
+    }
+
+    const CompiledData::NativeCodeFunction *functions = section->functionTable();
+    for (quint32 i = 0; i < section->nFunctions; ++i) {
+        const CompiledData::NativeCodeFunction *code = functions + i;
+        if (code->functionIndex >= quint32(runtimeFunctions.size())
+                || code->codeOffset > sectionSize || code->codeSize > sectionSize - code->codeOffset
+                || code->relocationTableOffset > sectionSize
+                || code->nRelocations > (sectionSize - code->relocationTableOffset)
+                                        / sizeof(CompiledData::NativeCodeRelocation)
+                || !nativeCodeIsValid(section, code)) {
+            continue;
+        }
+
+        Function *function = runtimeFunctions[code->functionIndex];
+        if (!function->isGenerator() && JIT::BaselineJIT::loadRelocatable(function, section, code))
+            ++nativeCodeFunctionCount;
+    }
+#endif
+}
+
+/*!
+    Stores the machine code the JIT generated for the functions of this unit in the cache file it
+    was loaded from, unless there are no new functions since the last time. The code is stored
+    after the regular unit data, so that it gets mapped into memory together with it.
+*/
+void ExecutableCompilationUnit::saveNativeCodeToDisk()
+{
+#if QT_CONFIG(qml_jit)
+    if (!engine || !engine->jitDiskCacheEnabled() || nativeCodeCacheFilePath.isEmpty())
+        return;
+
+    int jittedFunctionCount = 0;
+    for (const Function *function : qAsConst(runtimeFunctions)) {
+        if (function->jittedCode)
+            ++jittedFunctionCount;
+    }
+    if (jittedFunctionCount <= nativeCodeFunctionCount)
+        return;
+    nativeCodeFunctionCount = jittedFunctionCount;
+
+    const QByteArray buildHash = JIT::BaselineJIT::relocatableBuildHash(engine);
+    if (buildHash.size() != int(sizeof(CompiledData::NativeCodeHeader::buildHash)))
+        return;
+
+    QVector<quint32> functionIndices;
+    QVector<JIT::RelocatableCode> functionCode;
+    for (int i = 0; i < runtimeFunctions.size(); ++i) {
+        Function *function = runtimeFunctions.at(i);
+        if (!function->jittedCode)
+            continue;
+        JIT::RelocatableCode code;
+        if (JIT::BaselineJIT(function).generateRelocatable(&code)) {
+            functionIndices.append(quint32(i));
+            functionCode.append(code);
+        }
+    }
+    if (functionCode.isEmpty())
+        return;
+
+    auto align = [](quint32 offset) { return (offset + 15) & ~15u; };
+
+    // Header and function table, then the relocations and the code of each function
+    quint32 sectionSize = align(sizeof(CompiledData::NativeCodeHeader)
+                                + functionCode.size() * sizeof(CompiledData::NativeCodeFunction));
+    QVector<CompiledData::NativeCodeFunction> functionTable(functionCode.size());
+    for (int i = 0; i < functionCode.size(); ++i) {
+        const JIT::RelocatableCode &code = functionCode.at(i);
+        CompiledData::NativeCodeFunction &entry = functionTable[i];
+        entry.functionIndex = functionIndices.at(i);
+        entry.osrEntryOffset = code.osrEntryOffset;
+        entry.relocationTableOffset = sectionSize;
+        entry.nRelocations = quint32(code.relocations.size());
+        sectionSize += entry.nRelocations * sizeof(CompiledData::NativeCodeRelocation);
+        entry.codeOffset = sectionSize;
+        entry.codeSize = quint32(code.code.size());
+        sectionSize = align(sectionSize + entry.codeSize);
+    }
+
+    CompiledData::NativeCodeHeader header;
+    memcpy(header.magic, nativeCodeMagic, sizeof(header.magic));
+    header.cpuFeatures = qCpuFeatures();
+    memcpy(header.buildHash, buildHash.constData(), sizeof(header.buildHash));
+    header.sectionSize = sectionSize;
+    header.nFunctions = quint32(functionTable.size());
+
+    const quint32 sectionOffset = nativeCodeSectionOffset(data->unitSize);
+    QByteArray contents(int(sectionOffset + sectionSize), 0);
+    char *out = contents.data();
+    // The unit was loaded from the file, so it already carries the flags for being saved.
+    memcpy(out, data, data->unitSize);
+    out += sectionOffset;
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), functionTable.constData(),
+           functionTable.size() * sizeof(CompiledData::NativeCodeFunction));
+    for (int i = 0; i < functionCode.size(); ++i) {
+        const JIT::RelocatableCode &code = functionCode.at(i);
+        const CompiledData::NativeCodeFunction &entry = functionTable.at(i);
+        memcpy(out + entry.relocationTableOffset, code.relocations.constData(),
+               entry.nRelocations * sizeof(CompiledData::NativeCodeRelocation));
+        memcpy(out + entry.codeOffset, code.code.constData(), entry.codeSize);
+    }
+
+    QString errorString;
+    if (!CompiledData::SaveableUnitPointer::writeDataToFile(
+                nativeCodeCacheFilePath, contents.constData(), quint32(contents.size()),
+                &errorString)) {
+        qCDebug(DBG_DISK_CACHE) << "Error saving JIT code to" << nativeCodeCacheFilePath
+                                << ":" << errorString;
+    }
+#endif
+}
+
 /*!
 Returns the property cache, if one alread exists.  The cache is not referenced.
 */
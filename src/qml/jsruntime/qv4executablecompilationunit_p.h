@@ -149,6 +149,10 @@ public:
     int totalObjectCount = 0; // Number of objects explicitly instantiated
 
     QVector<QQmlRefPointer<QQmlScriptData>> dependentScripts;
+    // Units generated by Function::compileLazily() for functions of this unit
+    QVector<QQmlRefPointer<ExecutableCompilationUnit>> lazilyCompiledUnits;
+    // Table of functions qmlcachegen compiled to C++, terminated by an entry with index -1
+    const QQmlPrivate::AOTCompiledFunction *aotCompiledFunctions = nullptr;
     ResolvedTypeReferenceMap resolvedTypes;
     ResolvedTypeReference *resolvedType(int id) const { return resolvedTypes.value(id); }
 
@@ -159,6 +163,9 @@ public:
     bool isRegisteredWithEngine = false;
 
     QScopedPointer<CompilationUnitMapper> backingFile;
+    // Cache file the code generated by the JIT is stored in, see saveNativeCodeToDisk()
+    QString nativeCodeCacheFilePath;
+    int nativeCodeFunctionCount = 0;
 
     // --- interface for QQmlPropertyCacheCreator
     using CompiledObject = CompiledData::Object;
@@ -241,12 +248,16 @@ public:
     QV4::Function *linkToEngine(QV4::ExecutionEngine *engine);
     void unlink();
 
+    Heap::RegExp *runtimeRegularExpression(int index);
+
     void markObjects(MarkStack *markStack);
 
-    bool loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString);
+    bool loadFromDisk(const QUrl &url, const QDateTime &sourceTimeStamp, QString *errorString,
+                      bool lazyFunctionCompilation = false);
 
     static QString localCacheFilePath(const QUrl &url);
     bool saveToDisk(const QUrl &unitUrl, QString *errorString);
+    void saveNativeCodeToDisk();
 
     QString bindingValueAsString(const CompiledData::Binding *binding) const;
     QString bindingValueAsScriptString(const CompiledData::Binding *binding) const;
@@ -257,10 +268,17 @@ public:
         return constants[binding->value.constantValueIndex].doubleValue();
     }
 
+    const CompiledData::SimpleBinding *simpleBindingForFunction(int functionIndex) const
+    {
+        return qmlData ? qmlData->simpleBindingForFunction(functionIndex) : nullptr;
+    }
+
     static bool verifyHeader(const CompiledData::Unit *unit, QDateTime expectedSourceTimeStamp,
                              QString *errorString);
 
 protected:
+    void loadNativeCode();
+
     quint32 totalStringCount() const
     { return data->stringTableSize; }
 
@@ -50,6 +50,11 @@
 #include <assembler/MacroAssemblerCodeRef.h>
 #include <private/qv4vme_moth_p.h>
 #include <private/qqmlglobal_p.h>
+#include <private/qqmljsengine_p.h>
+#include <private/qqmljslexer_p.h>
+#include <private/qqmljsparser_p.h>
+#include <private/qqmljsast_p.h>
+#include <private/qv4runtimecodegen_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -73,6 +78,42 @@ ReturnedValue Function::call(const Value *thisObject, const Value *argv, int arg
     return result;
 }
 
+Function *Function::compileLazily(EngineBase *engineBase)
+{
+    Q_ASSERT(isLazy() && !lazilyCompiledFunction);
+    ExecutionEngine *engine = static_cast<ExecutionEngine *>(engineBase);
+    ExecutableCompilationUnit *unit = executableCompilationUnit();
+    const QString source = unit->stringAt(compiledFunction->lazySourceIndex);
+
+    QQmlJS::Engine ee;
+    QQmlJS::Lexer lexer(&ee);
+    lexer.setCode(source, compiledFunction->location.line, false);
+    QQmlJS::Parser parser(&ee);
+
+    QQmlJS::AST::FunctionExpression *fe = parser.parseExpression()
+            ? QQmlJS::AST::cast<QQmlJS::AST::FunctionExpression *>(parser.rootNode())
+            : nullptr;
+    if (!fe) {
+        engine->throwSyntaxError(QLatin1String("Parse error"), sourceFile(),
+                                 compiledFunction->location.line, compiledFunction->location.column);
+        return this;
+    }
+
+    Compiler::Module module(engine->debugger() != nullptr);
+    Compiler::JSUnitGenerator jsGenerator(&module);
+    RuntimeCodegen cg(engine, &jsGenerator, isStrict());
+    cg.generateFromLazyFunction(sourceFile(), unit->finalUrlString(), source, name()->toQString(),
+                                fe, &module);
+    if (engine->hasException)
+        return this;
+
+    QQmlRefPointer<ExecutableCompilationUnit> lazyUnit
+            = ExecutableCompilationUnit::create(cg.generateCompilationUnit());
+    lazilyCompiledFunction = lazyUnit->linkToEngine(engine);
+    unit->lazilyCompiledUnits.append(lazyUnit);
+    return lazilyCompiledFunction;
+}
+
 Function *Function::create(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
                            const CompiledData::Function *function)
 {
@@ -114,6 +155,10 @@ Function::~Function()
         destroyFunctionTable(this, codeRef);
         delete codeRef;
     }
+    if (baselineCodeRef) {
+        destroyFunctionTable(this, baselineCodeRef);
+        delete baselineCodeRef;
+    }
 }
 
 void Function::updateInternalClass(ExecutionEngine *engine, const QList<QByteArray> &parameters)
@@ -63,6 +63,10 @@ QT_BEGIN_NAMESPACE
 
 struct QQmlSourceLocation;
 
+namespace QQmlPrivate {
+struct AOTCompiledFunction;
+}
+
 namespace QV4 {
 
 struct Q_QML_EXPORT FunctionData {
@@ -105,13 +109,24 @@ public:
 
     typedef ReturnedValue (*JittedCode)(CppStackFrame *, ExecutionEngine *);
     JittedCode jittedCode;
+    // Continues a frame the interpreter has suspended at a loop header
+    JittedCode osrEntry = nullptr;
     JSC::MacroAssemblerCodeRef *codeRef;
+    // The baseline code is kept after recompiling, as it may still be running further up the stack
+    JSC::MacroAssemblerCodeRef *baselineCodeRef = nullptr;
 
     // first nArguments names in internalClass are the actual arguments
     Heap::InternalClass *internalClass;
     uint nFormals;
     int interpreterCallCount = 0;
+    int interpreterBackEdgeCount = 0;
+    int baselineCallCount = 0;
     bool isEval = false;
+    bool hasOptimizedCode = false;
+    // For lazy functions, the function compiled from their source on the first call
+    Function *lazilyCompiledFunction = nullptr;
+    // C++ code qmlcachegen generated for this function, tried before the bytecode
+    const QQmlPrivate::AOTCompiledFunction *aotFunction = nullptr;
 
     static Function *create(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
                             const CompiledData::Function *function);
@@ -132,6 +147,10 @@ public:
     inline bool isStrict() const { return compiledFunction->flags & CompiledData::Function::IsStrict; }
     inline bool isArrowFunction() const { return compiledFunction->flags & CompiledData::Function::IsArrowFunction; }
     inline bool isGenerator() const { return compiledFunction->flags & CompiledData::Function::IsGenerator; }
+    inline bool isLazy() const { return compiledFunction->flags & CompiledData::Function::IsLazy; }
+
+    // Returns the function to run in place of a lazy function
+    Function *compileLazily(EngineBase *engine);
 
     QQmlSourceLocation sourceLocation() const;
 
@@ -121,6 +121,7 @@ ReturnedValue GeneratorFunction::virtualCall(const FunctionObject *f, const Valu
     gp->cppFrame.push();
 
     Moth::VME::interpret(&gp->cppFrame, engine, function->codeData);
+    WriteBarrier::markCustom(engine, gp);
     gp->state = GeneratorState::SuspendedStart;
 
     gp->cppFrame.pop();
@@ -228,6 +229,8 @@ ReturnedValue GeneratorObject::resume(ExecutionEngine *engine, const Value &arg)
 
     Scope scope(engine);
     ScopedValue result(scope, Moth::VME::interpret(&gp->cppFrame, engine, code));
+    // the interpreter writes to the frame stored in gp without going through the write barrier
+    WriteBarrier::markCustom(engine, gp);
 
     engine->currentStackFrame = gp->cppFrame.parent;
 
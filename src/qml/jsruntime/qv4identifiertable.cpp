@@ -44,6 +44,77 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+Q_GLOBAL_STATIC(SharedIdentifierTable, sharedIdentifierTable)
+
+SharedIdentifierTable::~SharedIdentifierTable()
+{
+    for (QAtomicPointer<Entry> &entry : entries) {
+        Entry *e = entry.loadAcquire();
+        if (!e)
+            continue;
+        if (!e->text->ref.deref())
+            QStringData::deallocate(e->text);
+        delete e;
+    }
+}
+
+SharedIdentifierTable *SharedIdentifierTable::instance()
+{
+    return sharedIdentifierTable();
+}
+
+const SharedIdentifierTable::Entry *SharedIdentifierTable::insert(const QString &s)
+{
+    if (s.isEmpty() || s.length() > MaxLength)
+        return nullptr;
+
+    uint subtype;
+    const uint hash = String::createHashValue(s.constData(), s.length(), &subtype);
+    if (subtype == Heap::String::StringType_ArrayIndex)
+        return nullptr;
+
+    Entry *newEntry = nullptr;
+    const auto discardNewEntry = [&newEntry]() {
+        if (!newEntry)
+            return;
+        if (!newEntry->text->ref.deref())
+            QStringData::deallocate(newEntry->text);
+        delete newEntry;
+    };
+
+    // The table is never more than about half full, so there always is a free slot to stop at.
+    uint idx = hash % Alloc;
+    while (true) {
+        Entry *e = entries[idx].loadAcquire();
+        if (!e) {
+            if (size.loadAcquire() >= MaxSize) {
+                discardNewEntry();
+                return nullptr;
+            }
+            if (!newEntry) {
+                // Take a copy, the string may point into the mapped file of a compilation unit.
+                QString text(s.constData(), s.length());
+                newEntry = new Entry;
+                newEntry->text = text.data_ptr();
+                newEntry->text->ref.ref();
+                newEntry->hash = hash;
+                newEntry->subtype = subtype;
+            }
+            if (entries[idx].testAndSetOrdered(nullptr, newEntry)) {
+                size.ref();
+                return newEntry;
+            }
+            // Another thread filled the slot in the meantime
+            e = entries[idx].loadAcquire();
+        }
+        if (e->hash == hash && QStringView(e->text->data(), e->text->size) == s) {
+            discardNewEntry();
+            return e;
+        }
+        idx = (idx + 1) % Alloc;
+    }
+}
+
 IdentifierTable::IdentifierTable(ExecutionEngine *engine, int numBits)
     : engine(engine)
     , size(0)
@@ -157,6 +228,32 @@ Heap::String *IdentifierTable::insertString(const QString &s)
     return str;
 }
 
+Heap::String *IdentifierTable::insertSharedString(const QString &s)
+{
+    const SharedIdentifierTable::Entry *shared = SharedIdentifierTable::instance()->insert(s);
+    if (!shared)
+        return nullptr;
+
+    uint idx = shared->hash % alloc;
+    while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
+        if (e->text == shared->text)
+            return static_cast<Heap::String *>(e);
+        // Strings created before, for example by newIdentifier(), have their own copy
+        if (e->stringHash == shared->hash && e->internalClass->vtable->isString && e->toQString() == s)
+            return static_cast<Heap::String *>(e);
+        ++idx;
+        idx %= alloc;
+    }
+
+    shared->text->ref.ref();
+    QStringDataPtr text = { shared->text };
+    Heap::String *str = engine->newString(QString(text));
+    str->stringHash = shared->hash;
+    str->subtype = shared->subtype;
+    addEntry(str);
+    return str;
+}
+
 Heap::Symbol *IdentifierTable::insertSymbol(const QString &s)
 {
     Q_ASSERT(s.at(0) == QLatin1Char('@'));
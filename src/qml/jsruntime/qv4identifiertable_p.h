@@ -60,6 +60,39 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+// The strings of compilation units are the same in all engines of a process. Their text and hash
+// value are stored once in this table, and each engine's IdentifierTable creates its strings from
+// those. Entries are only ever added, never changed or removed, so that the table can be read and
+// extended from any thread without locking. Strings created at run-time are only held by the
+// engine's own table.
+struct Q_QML_PRIVATE_EXPORT SharedIdentifierTable
+{
+    struct Entry
+    {
+        QStringData *text;
+        uint hash;
+        uint subtype;
+    };
+
+    enum {
+        Alloc = 1 << 14,
+        MaxSize = Alloc / 2,
+        MaxLength = 64
+    };
+
+    ~SharedIdentifierTable();
+
+    static SharedIdentifierTable *instance();
+
+    // Returns nullptr for strings that are not shared: array indices, long strings, and new
+    // strings once the table is full.
+    const Entry *insert(const QString &s);
+
+private:
+    QAtomicPointer<Entry> entries[Alloc];
+    QAtomicInt size;
+};
+
 struct Q_QML_PRIVATE_EXPORT IdentifierTable
 {
     ExecutionEngine *engine;
@@ -81,6 +114,9 @@ public:
 
     Heap::String *insertString(const QString &s);
     Heap::Symbol *insertSymbol(const QString &s);
+    // Like insertString(), using the text and hash of the SharedIdentifierTable.
+    // Returns nullptr if the string is not shared.
+    Heap::String *insertSharedString(const QString &s);
 
     PropertyKey asPropertyKey(const Heap::String *str) {
         if (str->identifier.isValid())
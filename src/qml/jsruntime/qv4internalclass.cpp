@@ -158,6 +158,8 @@ void SharedInternalClassDataPrivate<PropertyKey>::grow()
     const uint a = alloc() * 2;
     const uint s = size();
     data = MemberData::allocate(engine, a, data);
+    // data is shared between internal classes and not referenced from any heap object
+    WriteBarrier::markExternallyReferenced(engine, data);
     setSize(s);
     Q_ASSERT(alloc() >= a);
 }
@@ -187,7 +189,7 @@ PropertyKey SharedInternalClassDataPrivate<PropertyKey>::at(uint i)
 void SharedInternalClassDataPrivate<PropertyKey>::set(uint i, PropertyKey t)
 {
     Q_ASSERT(data && i < size());
-    data->values.values[i].rawValueRef() = t.id();
+    data->values.set(engine, i, Value::fromReturnedValue(t.id()));
 }
 
 void SharedInternalClassDataPrivate<PropertyKey>::mark(MarkStack *s)
@@ -530,6 +532,43 @@ Heap::InternalClass *InternalClass::addMemberImpl(PropertyKey identifier, Proper
     return newClass;
 }
 
+Heap::InternalClass *InternalClass::addMembers(const void *memberList, const PropertyKey *identifiers,
+                                               const PropertyAttributes *attributes, uint count)
+{
+    Transition temp = { { PropertyKey::invalid() }, nullptr, Transition::MemberList };
+    temp.memberList = memberList;
+
+    Transition &t = lookupOrInsertTransition(temp);
+    if (t.lookup)
+        return t.lookup;
+
+    // create a new class and add it to the tree
+    Scope scope(engine);
+    Scoped<QV4::InternalClass> ic(scope, engine->newClass(this));
+    InternalClass *newClass = ic->d();
+    for (uint i = 0; i < count; ++i) {
+        const PropertyKey identifier = identifiers[i];
+        PropertyAttributes data = attributes[i];
+        Q_ASSERT(identifier.isStringOrSymbol());
+        Q_ASSERT(!newClass->findEntry(identifier));
+        if (!data.isEmpty())
+            data.resolve();
+
+        PropertyHash::Entry e = { identifier, newClass->size, data.isAccessor() ? newClass->size + 1 : UINT_MAX };
+        newClass->propertyTable.addEntry(e, newClass->size);
+
+        newClass->nameMap.add(newClass->size, identifier);
+        newClass->propertyData.add(newClass->size, data);
+        ++newClass->size;
+        if (data.isAccessor())
+            addDummyEntry(newClass, e);
+    }
+
+    t.lookup = newClass;
+    Q_ASSERT(t.lookup);
+    return newClass;
+}
+
 void InternalClass::removeChildEntry(InternalClass *child)
 {
     Q_ASSERT(engine);
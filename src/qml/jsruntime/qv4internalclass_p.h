@@ -285,6 +285,7 @@ struct InternalClassTransition
         PropertyKey id;
         const VTable *vtable;
         Heap::Object *prototype;
+        const void *memberList;
     };
     Heap::InternalClass *lookup;
     int flags;
@@ -295,7 +296,8 @@ struct InternalClassTransition
         PrototypeChange = 0x201,
         ProtoClass = 0x202,
         Sealed = 0x203,
-        Frozen = 0x204
+        Frozen = 0x204,
+        MemberList = 0x205
     };
 
     bool operator==(const InternalClassTransition &other) const
@@ -338,6 +340,10 @@ struct InternalClass : Base {
     static void addMember(QV4::Object *object, PropertyKey id, PropertyAttributes data, InternalClassEntry *entry);
     Q_REQUIRED_RESULT InternalClass *addMember(PropertyKey identifier, PropertyAttributes data, InternalClassEntry *entry = nullptr);
     Q_REQUIRED_RESULT InternalClass *changeMember(PropertyKey identifier, PropertyAttributes data, InternalClassEntry *entry = nullptr);
+    // Adds all the given members in one step, without creating a class for each of them.
+    // The transition is identified by memberList, which has to denote the same members whenever it's used.
+    Q_REQUIRED_RESULT InternalClass *addMembers(const void *memberList, const PropertyKey *identifiers,
+                                                const PropertyAttributes *attributes, uint count);
     static void changeMember(QV4::Object *object, PropertyKey id, PropertyAttributes data, InternalClassEntry *entry = nullptr);
     static void removeMember(QV4::Object *object, PropertyKey identifier);
     PropertyHash::Entry *findEntry(const PropertyKey id)
@@ -51,6 +51,8 @@
 
 #include <qstack.h>
 #include <qstringlist.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/private/qsimd_p.h>
 
 #include <wtf/MathExtras.h>
 
@@ -122,18 +124,114 @@ enum {
     Quote = 0x22
 };
 
-bool JsonParser::eatSpace()
+static inline bool isJsonSpace(ushort ch)
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
+    return ch == Space || ch == Tab || ch == LineFeed || ch == Return;
+}
+
+// Returns the first character in [ch, end) that isn't JSON whitespace.
+static const QChar *skipSpace(const QChar *ch, const QChar *end)
+{
+    const ushort *p = reinterpret_cast<const ushort *>(ch);
+    const ushort *e = reinterpret_cast<const ushort *>(end);
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi16(Space);
+    const __m128i tab = _mm_set1_epi16(Tab);
+    const __m128i lineFeed = _mm_set1_epi16(LineFeed);
+    const __m128i ret = _mm_set1_epi16(Return);
+    for (; e - p >= 8; p += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i match = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi16(data, space), _mm_cmpeq_epi16(data, tab)),
+                    _mm_or_si128(_mm_cmpeq_epi16(data, lineFeed), _mm_cmpeq_epi16(data, ret)));
+        const uint mask = ~uint(_mm_movemask_epi8(match)) & 0xffff;
+        if (mask)
+            return reinterpret_cast<const QChar *>(p + (qCountTrailingZeroBits(mask) >> 1));
+    }
+#elif defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    for (; e - p >= 8; p += 8) {
+        const uint16x8_t data = vld1q_u16(p);
+        const uint16x8_t match = vorrq_u16(
+                    vorrq_u16(vceqq_u16(data, vdupq_n_u16(Space)), vceqq_u16(data, vdupq_n_u16(Tab))),
+                    vorrq_u16(vceqq_u16(data, vdupq_n_u16(LineFeed)), vceqq_u16(data, vdupq_n_u16(Return))));
+        const quint64 mask = ~vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(match)), 0);
+        if (mask)
+            return reinterpret_cast<const QChar *>(p + (qCountTrailingZeroBits(mask) >> 3));
+    }
+#endif
+    while (p < e && isJsonSpace(*p))
+        ++p;
+    return reinterpret_cast<const QChar *>(p);
+}
+
+// Returns the first character in [ch, end) that ends a run of plain string characters:
+// a quote, a backslash or a control character. Used to scan strings when parsing, and
+// to find the characters that need escaping when stringifying.
+static const QChar *findStringSpecial(const QChar *ch, const QChar *end)
+{
+    const ushort *p = reinterpret_cast<const ushort *>(ch);
+    const ushort *e = reinterpret_cast<const ushort *>(end);
+#if defined(__AVX2__)
+    {
+        const __m256i quote = _mm256_set1_epi16(Quote);
+        const __m256i backslash = _mm256_set1_epi16('\\');
+        const __m256i controlMask = _mm256_set1_epi16(short(0xffe0));
+        for (; e - p >= 16; p += 16) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i match = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi16(data, quote),
+                                        _mm256_cmpeq_epi16(data, backslash)),
+                        _mm256_cmpeq_epi16(_mm256_and_si256(data, controlMask),
+                                           _mm256_setzero_si256()));
+            const uint mask = uint(_mm256_movemask_epi8(match));
+            if (mask)
+                return reinterpret_cast<const QChar *>(p + (qCountTrailingZeroBits(mask) >> 1));
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi16(Quote);
+    const __m128i backslash = _mm_set1_epi16('\\');
+    const __m128i controlMask = _mm_set1_epi16(short(0xffe0));
+    for (; e - p >= 8; p += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // control characters are the ones with none of the bits in 0xffe0 set
+        const __m128i match = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi16(data, quote), _mm_cmpeq_epi16(data, backslash)),
+                    _mm_cmpeq_epi16(_mm_and_si128(data, controlMask), _mm_setzero_si128()));
+        const uint mask = uint(_mm_movemask_epi8(match));
+        if (mask)
+            return reinterpret_cast<const QChar *>(p + (qCountTrailingZeroBits(mask) >> 1));
+    }
+#elif defined(__ARM_NEON__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    for (; e - p >= 8; p += 8) {
+        const uint16x8_t data = vld1q_u16(p);
+        const uint16x8_t match = vorrq_u16(
+                    vorrq_u16(vceqq_u16(data, vdupq_n_u16(Quote)), vceqq_u16(data, vdupq_n_u16('\\'))),
+                    vcltq_u16(data, vdupq_n_u16(Space)));
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(match)), 0);
+        if (mask)
+            return reinterpret_cast<const QChar *>(p + (qCountTrailingZeroBits(mask) >> 3));
+    }
+#endif
+    for (; p < e; ++p) {
+        if (*p == Quote || *p == '\\' || *p < Space)
             break;
+    }
+    return reinterpret_cast<const QChar *>(p);
+}
+
+bool JsonParser::eatSpace()
+{
+    // most tokens are followed by at most a single space, don't bother scanning for those
+    if (json < end && json->unicode() > Space)
+        return true;
+    while (json < end && json->unicode() == Space) {
         ++json;
+        if (json < end && json->unicode() > Space)
+            return true;
     }
+    json = skipSpace(json, end);
     return (json < end);
 }
 
@@ -172,6 +270,7 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     eatSpace();
 
     Scope scope(engine);
+    shapeClasses = scope.alloc(2 * ShapeCacheSize);
     ScopedValue v(scope);
     if (!parseValue(v)) {
 #ifdef PARSER_DEBUG
@@ -249,9 +348,17 @@ bool JsonParser::parseMember(Object *o)
     BEGIN << "parseMember";
     Scope scope(engine);
 
+    // Keys without escape sequences are only turned into a QString if the shape cache misses.
+    const QChar *keyBegin = json;
+    const QChar *keyEnd = findStringSpecial(json, end);
     QString key;
-    if (!parseString(&key))
-        return false;
+    if (keyEnd < end && *keyEnd == Quote) {
+        json = keyEnd + 1;
+    } else {
+        keyBegin = keyEnd = nullptr;
+        if (!parseString(&key))
+            return false;
+    }
     QChar token = nextToken();
     if (token != NameSeparator) {
         lastError = QJsonParseError::MissingNameSeparator;
@@ -261,19 +368,69 @@ bool JsonParser::parseMember(Object *o)
     if (!parseValue(val))
         return false;
 
+    if (keyBegin) {
+        if (addCachedMember(o, keyBegin, int(keyEnd - keyBegin), val)) {
+            END;
+            return true;
+        }
+        key = QString(keyBegin, int(keyEnd - keyBegin));
+    } else if (addCachedMember(o, key.constData(), key.size(), val)) {
+        END;
+        return true;
+    }
+
     ScopedString s(scope, engine->newString(key));
     PropertyKey skey = s->toPropertyKey();
     if (skey.isArrayIndex()) {
         o->put(skey.asArrayIndex(), val);
     } else {
         // avoid trouble with properties named __proto__
+        Heap::InternalClass *from = o->internalClass();
         o->insertMember(s, val);
+        cacheMember(from, o->internalClass(), skey);
     }
 
     END;
     return true;
 }
 
+static inline uint shapeCacheIndex(const Heap::InternalClass *ic, uint size)
+{
+    const quintptr p = quintptr(ic);
+    return uint((p >> 5) ^ (p >> 11)) & (size - 1);
+}
+
+// Adds the member if a previous object took the same transition for the same key.
+bool JsonParser::addCachedMember(Object *o, const QChar *key, int length, const Value &val)
+{
+    Heap::InternalClass *from = o->internalClass();
+    const uint i = shapeCacheIndex(from, ShapeCacheSize);
+    if (shapeClasses[2 * i].heapObject() != from)
+        return false;
+
+    const ShapeCacheEntry &entry = shapes[i];
+    const Heap::StringOrSymbol *name = entry.key.asStringOrSymbol();
+    if (name->text->size != length || memcmp(name->text->data(), key, length * sizeof(QChar))) {
+        return false;
+    }
+
+    o->setInternalClass(static_cast<Heap::InternalClass *>(shapeClasses[2 * i + 1].heapObject()));
+    o->setProperty(entry.index, val);
+    return true;
+}
+
+void JsonParser::cacheMember(Heap::InternalClass *from, Heap::InternalClass *to, PropertyKey key)
+{
+    // only plain additions, not redefinitions of a duplicate key
+    if (to == from || to->size != from->size + 1 || !key.isString())
+        return;
+
+    const uint i = shapeCacheIndex(from, ShapeCacheSize);
+    shapeClasses[2 * i] = Value::fromHeapObject(from);
+    shapeClasses[2 * i + 1] = Value::fromHeapObject(to);
+    shapes[i] = { key, from->size };
+}
+
 /*
     array = begin-array [ value *( value-separator value ) ] end-array
 */
@@ -472,6 +629,22 @@ bool JsonParser::parseNumber(Value *val)
             ++json;
     }
 
+    // Short integers don't need to go through QString
+    const int digits = int(json - start) - (*start == '-' ? 1 : 0);
+    if (isInt && digits > 0 && digits <= 9) {
+        int n = 0;
+        for (const QChar *ch = json - digits; ch < json; ++ch)
+            n = n * 10 + (ch->unicode() - '0');
+        if (*start == '-')
+            n = -n;
+        if (n < (1<<25) && n > -(1<<25))
+            *val = Value::fromInt32(n);
+        else
+            *val = Value::fromDouble(n);
+        END;
+        return true;
+    }
+
     QString number(start, json - start);
     DEBUG << "numberstring" << number;
 
@@ -585,6 +758,14 @@ bool JsonParser::parseString(QString *string)
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
+        const QChar *run = findStringSpecial(json, end);
+        if (run != json) {
+            string->append(json, int(run - json));
+            json = run;
+            if (json >= end)
+                break;
+        }
+
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -638,21 +819,38 @@ struct Stringify
 
     Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0) {}
 
-    QString Str(const QString &key, const Value &v);
-    QString JA(Object *a);
-    QString JO(Object *o);
-
-    QString makeMember(const QString &key, const Value &v);
+    // The functions below append to the result instead of returning partial strings.
+    // Str() returns false, without appending anything, if the value is not serializable.
+    bool Str(QString &out, const Value &key, const Value &v);
+    void JA(QString &out, Object *a);
+    void JO(QString &out, Object *o);
+
+    void appendMember(QString &out, int start, const Value &key, const Value &v);
+    void appendNewline(QString &out, const QString &indentation) const
+    {
+        if (!gap.isEmpty()) {
+            out += QLatin1Char('\n');
+            out += indentation;
+        }
+    }
 };
 
-static QString quote(const QString &str)
+static void quote(QString &product, const QString &str)
 {
-    QString product;
-    const int length = str.length();
-    product.reserve(length + 2);
+    const QChar *begin = str.constData();
+    const QChar *end = begin + str.length();
+    product.reserve(product.size() + str.length() + 2);
     product += QLatin1Char('"');
-    for (int i = 0; i < length; ++i) {
-        QChar c = str.at(i);
+    for (const QChar *ch = begin; ch < end; ++ch) {
+        const QChar *run = findStringSpecial(ch, end);
+        if (run != ch) {
+            product.append(ch, int(run - ch));
+            ch = run;
+            if (ch == end)
+                break;
+        }
+
+        QChar c = *ch;
         switch (c.unicode()) {
         case '"':
             product += QLatin1String("\\\"");
@@ -676,20 +874,16 @@ static QString quote(const QString &str)
             product += QLatin1String("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QLatin1String("\\u00");
-                product += (c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0')) +
-                        QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            Q_ASSERT(c.unicode() <= 0x1f);
+            product += QLatin1String("\\u00");
+            product += (c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0')) +
+                    QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
         }
     }
     product += QLatin1Char('"');
-    return product;
 }
 
-QString Stringify::Str(const QString &key, const Value &v)
+bool Stringify::Str(QString &out, const Value &key, const Value &v)
 {
     Scope scope(v4);
 
@@ -701,7 +895,7 @@ QString Stringify::Str(const QString &key, const Value &v)
         if (!!toJSON) {
             JSCallData jsCallData(scope, 1);
             *jsCallData->thisObject = value;
-            jsCallData->args[0] = v4->newString(key);
+            jsCallData->args[0] = key.toString(v4);
             value = toJSON->call(jsCallData);
         }
     }
@@ -710,7 +904,7 @@ QString Stringify::Str(const QString &key, const Value &v)
         ScopedObject holder(scope, v4->newObject());
         holder->put(scope.engine->id_empty(), value);
         JSCallData jsCallData(scope, 2);
-        jsCallData->args[0] = v4->newString(key);
+        jsCallData->args[0] = key.toString(v4);
         jsCallData->args[1] = value;
         *jsCallData->thisObject = holder;
         value = replacerFunction->call(jsCallData);
@@ -726,64 +920,76 @@ QString Stringify::Str(const QString &key, const Value &v)
             value = Encode(b->value());
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        out += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        out += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(out, value->stringValue()->toQString());
+        return true;
+    }
 
     if (value->isNumber()) {
         double d = value->toNumber();
-        return std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        if (std::isfinite(d))
+            out += value->toQString();
+        else
+            out += QLatin1String("null");
+        return true;
     }
 
     if (const QV4::VariantObject *v = value->as<QV4::VariantObject>()) {
-        return quote(v->d()->data().toString());
+        quote(out, v->d()->data().toString());
+        return true;
     }
 
     o = value->asReturnedValue();
     if (o) {
         if (!o->as<FunctionObject>()) {
-            if (o->isArrayLike()) {
-                return JA(o.getPointer());
-            } else {
-                return JO(o);
-            }
+            if (o->isArrayLike())
+                JA(out, o.getPointer());
+            else
+                JO(out, o);
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, const Value &v)
+void Stringify::appendMember(QString &out, int start, const Value &key, const Value &v)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + QLatin1Char(':');
-        if (!gap.isEmpty())
-            member += QLatin1Char(' ');
-        member += strP;
-        return member;
-    }
-    return QString();
+    const int rollback = out.size();
+    if (rollback != start)
+        out += QLatin1Char(',');
+    appendNewline(out, indent);
+    quote(out, key.toQString());
+    out += QLatin1Char(':');
+    if (!gap.isEmpty())
+        out += QLatin1Char(' ');
+    if (!Str(out, key, v))
+        out.truncate(rollback);
 }
 
-QString Stringify::JO(Object *o)
+void Stringify::JO(QString &out, Object *o)
 {
     if (stackContains(o)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(v4);
 
-    QString result;
     stack.push(o);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    out += QLatin1Char('{');
+    const int start = out.size();
     if (!propertyListSize) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
@@ -793,10 +999,7 @@ QString Stringify::JO(Object *o)
             name = it.nextPropertyNameAsString(val);
             if (name->isNull())
                 break;
-            QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            appendMember(out, start, name, val);
         }
     } else {
         ScopedValue v(scope);
@@ -808,70 +1011,51 @@ QString Stringify::JO(Object *o)
             v = o->get(s, &exists);
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            appendMember(out, start, *s, v);
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('{') + partial.join(QLatin1Char(',')) + QLatin1Char('}');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("{\n") + indent + partial.join(separator) + QLatin1Char('\n')
-                 + stepback + QLatin1Char('}');
-    }
+    if (out.size() != start)
+        appendNewline(out, stepback);
+    out += QLatin1Char('}');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(Object *a)
+void Stringify::JA(QString &out, Object *a)
 {
     if (stackContains(a)) {
         v4->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    out += QLatin1Char('[');
     uint len = a->getLength();
     ScopedValue v(scope);
+    ScopedValue index(scope);
     for (uint i = 0; i < len; ++i) {
+        if (i)
+            out += QLatin1Char(',');
+        appendNewline(out, indent);
         bool exists;
         v = a->get(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
-    }
-
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = QLatin1Char('[') + partial.join(QLatin1Char(',')) + QLatin1Char(']');
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("[\n") + indent + partial.join(separator) + QLatin1Char('\n') + stepback + QLatin1Char(']');
+        index = Value::fromUInt32(i);
+        if (!exists || !Str(out, index, v))
+            out += QLatin1String("null");
     }
+    if (len)
+        appendNewline(out, stepback);
+    out += QLatin1Char(']');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -951,8 +1135,8 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
 
 
     ScopedValue arg0(scope, argc ? argv[0] : Value::undefinedValue());
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.engine->hasException)
+    QString result;
+    if (!stringify.Str(result, *scope.engine->id_empty(), arg0) || scope.engine->hasException)
         RETURN_UNDEFINED();
     return Encode(scope.engine->newString(result));
 }
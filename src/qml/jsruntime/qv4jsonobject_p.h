@@ -127,6 +127,9 @@ private:
     bool parseValue(Value *val);
     bool parseNumber(Value *val);
 
+    bool addCachedMember(Object *o, const QChar *key, int length, const Value &val);
+    void cacheMember(Heap::InternalClass *from, Heap::InternalClass *to, PropertyKey key);
+
     ExecutionEngine *engine;
     const QChar *head;
     const QChar *json;
@@ -134,6 +137,18 @@ private:
 
     int nestingLevel;
     QJsonParseError::ParseError lastError;
+
+    // Objects in a JSON document usually share their layout. Remember which internal class
+    // adding a key leads to, so that repeated keys skip the identifier lookup and the
+    // transition search. The classes are stored in values on the JS stack, so that they
+    // can't be collected while they are in the cache.
+    enum { ShapeCacheSize = 64 };
+    struct ShapeCacheEntry {
+        PropertyKey key;
+        uint index;
+    };
+    Value *shapeClasses = nullptr; // from and to class for each entry
+    ShapeCacheEntry shapes[ShapeCacheSize];
 };
 
 }
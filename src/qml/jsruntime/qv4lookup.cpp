@@ -40,12 +40,112 @@
 #include "qv4functionobject_p.h"
 #include "qv4jscall_p.h"
 #include "qv4string_p.h"
+#include "qv4qobjectwrapper_p.h"
+#include "qv4qmlcontext_p.h"
 #include <private/qv4identifiertable_p.h>
+#include <private/qqmlvaluetypewrapper_p.h>
 
 QT_BEGIN_NAMESPACE
 
 using namespace QV4;
 
+void PolymorphicLookup::releasePropertyCaches()
+{
+    for (uint i = 0; i < nEntries; ++i) {
+        if (entries[i].kind == QObjectProperty)
+            entries[i].propertyCache->release();
+    }
+}
+
+static PolymorphicLookup::Entry dataEntry(Heap::InternalClass *ic, PolymorphicLookup::Kind kind, uint offset)
+{
+    return { ic, kind, offset, nullptr, nullptr };
+}
+
+// Converts a property index, as stored by setter0setter0, to an entry
+static PolymorphicLookup::Entry indexEntry(Heap::InternalClass *ic, uint index)
+{
+    const uint nInline = ic->vtable->nInlineProperties;
+    if (index < nInline)
+        return dataEntry(ic, PolymorphicLookup::InlineProperty, index + ic->vtable->inlinePropertyOffset);
+    return dataEntry(ic, PolymorphicLookup::MemberDataProperty, index - nInline);
+}
+
+// Takes over the property cache of a resolved lookup
+static bool getterEntry(const Lookup &l, PolymorphicLookup::Entry *entry)
+{
+    if (l.getter == Lookup::getter0Inline) {
+        *entry = dataEntry(l.objectLookup.ic, PolymorphicLookup::InlineProperty, l.objectLookup.offset);
+        return true;
+    }
+    if (l.getter == Lookup::getter0MemberData) {
+        *entry = dataEntry(l.objectLookup.ic, PolymorphicLookup::MemberDataProperty, l.objectLookup.offset);
+        return true;
+    }
+    if (l.getter == QObjectWrapper::lookupGetter) {
+        *entry = { l.qobjectLookup.ic, PolymorphicLookup::QObjectProperty, 0,
+                   l.qobjectLookup.propertyCache, l.qobjectLookup.propertyData };
+        return true;
+    }
+    return false;
+}
+
+static bool setterEntry(const Lookup &l, PolymorphicLookup::Entry *entry)
+{
+    if (l.setter == Lookup::setter0Inline) {
+        *entry = dataEntry(l.objectLookup.ic, PolymorphicLookup::InlineProperty, l.objectLookup.offset);
+        return true;
+    }
+    if (l.setter == Lookup::setter0MemberData) {
+        *entry = dataEntry(l.objectLookup.ic, PolymorphicLookup::MemberDataProperty, l.objectLookup.offset);
+        return true;
+    }
+    return false;
+}
+
+void Lookup::initPolymorphic(ExecutionEngine *engine, const PolymorphicLookup::Entry *entries, uint nEntries)
+{
+    PolymorphicLookup *cache = new PolymorphicLookup;
+    for (uint i = 0; i < nEntries; ++i)
+        cache->append(entries[i]);
+    clear();
+    polymorphicLookup.cache = cache;
+    ++engine->lookupStatistics.polymorphicLookups;
+    engine->lookupStatistics.polymorphicEntries += nEntries;
+}
+
+void Lookup::releasePropertyCaches()
+{
+    if (getter == getterPolymorphic || setter == setterPolymorphic) {
+        polymorphicLookup.cache->releasePropertyCaches();
+        delete polymorphicLookup.cache;
+        polymorphicLookup.cache = nullptr;
+        return;
+    }
+
+    if (getter == QObjectWrapper::lookupGetter) {
+        if (QQmlPropertyCache *pc = qobjectLookup.propertyCache)
+            pc->release();
+        qobjectLookup.propertyCache = nullptr;
+    } else if (getter == QQmlValueTypeWrapper::lookupGetter) {
+        if (QQmlPropertyCache *pc = qgadgetLookup.propertyCache)
+            pc->release();
+        qgadgetLookup.propertyCache = nullptr;
+    }
+
+    if (qmlContextPropertyGetter == QQmlContextWrapper::lookupScopeObjectProperty
+            || qmlContextPropertyGetter == QQmlContextWrapper::lookupContextObjectProperty) {
+        if (QQmlPropertyCache *pc = qobjectLookup.propertyCache)
+            pc->release();
+        qobjectLookup.propertyCache = nullptr;
+    } else if (qmlContextPropertyGetter == QQmlContextWrapper::lookupIdObjectInParentContext
+               || qmlContextPropertyGetter == QQmlContextWrapper::lookupContextPropertyInParentContext
+               || qmlContextPropertyGetter == QQmlContextWrapper::lookupContextObjectPropertyInParentContext) {
+        delete qmlParentContextLookup.cache;
+        qmlParentContextLookup.cache = nullptr;
+    }
+}
+
 
 void Lookup::resolveProtoGetter(PropertyKey name, const Heap::Object *proto)
 {
@@ -185,6 +285,13 @@ ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const
             return result;
         }
 
+        PolymorphicLookup::Entry entries[2];
+        if (getterEntry(first, &entries[0]) && getterEntry(second, &entries[1])) {
+            l->initPolymorphic(engine, entries, 2);
+            l->getter = getterPolymorphic;
+            return result;
+        }
+        second.releasePropertyCaches();
     }
 
     l->getter = getterFallback;
@@ -237,6 +344,18 @@ ReturnedValue Lookup::getterProto(Lookup *l, ExecutionEngine *engine, const Valu
     return getterTwoClasses(l, engine, object);
 }
 
+static ReturnedValue getterTwoClassesMiss(Lookup *l, ExecutionEngine *engine, const Value &object,
+                                          PolymorphicLookup::Kind kind, PolymorphicLookup::Kind kind2)
+{
+    const PolymorphicLookup::Entry entries[] = {
+        dataEntry(l->objectLookupTwoClasses.ic, kind, l->objectLookupTwoClasses.offset),
+        dataEntry(l->objectLookupTwoClasses.ic2, kind2, l->objectLookupTwoClasses.offset2)
+    };
+    l->initPolymorphic(engine, entries, 2);
+    l->getter = Lookup::getterPolymorphic;
+    return Lookup::getterPolymorphic(l, engine, object);
+}
+
 ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     // we can safely cast to a QV4::Object here. If object is actually a string,
@@ -248,8 +367,7 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterTwoClassesMiss(l, engine, object, PolymorphicLookup::InlineProperty, PolymorphicLookup::InlineProperty);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -263,8 +381,7 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterTwoClassesMiss(l, engine, object, PolymorphicLookup::InlineProperty, PolymorphicLookup::MemberDataProperty);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -278,8 +395,7 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterTwoClassesMiss(l, engine, object, PolymorphicLookup::MemberDataProperty, PolymorphicLookup::MemberDataProperty);
 }
 
 ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -371,6 +487,74 @@ ReturnedValue Lookup::getterIndexed(Lookup *l, ExecutionEngine *engine, const Va
 
 }
 
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const PolymorphicLookup *cache = l->polymorphicLookup.cache;
+        for (uint i = 0; i < cache->nEntries; ++i) {
+            const PolymorphicLookup::Entry &entry = cache->entries[i];
+            if (entry.ic != o->internalClass)
+                continue;
+            switch (entry.kind) {
+            case PolymorphicLookup::InlineProperty:
+                ++engine->lookupStatistics.polymorphicHits;
+                return o->inlinePropertyDataWithOffset(entry.offset)->asReturnedValue();
+            case PolymorphicLookup::MemberDataProperty:
+                ++engine->lookupStatistics.polymorphicHits;
+                return o->memberData->values.data()[entry.offset].asReturnedValue();
+            case PolymorphicLookup::QObjectProperty: {
+                QObject *qobj = static_cast<Heap::QObjectWrapper *>(o)->object();
+                if (QQmlData::wasDeleted(qobj))
+                    return Encode::undefined();
+                QQmlData *ddata = QQmlData::get(qobj, /*create*/false);
+                if (ddata && ddata->propertyCache == entry.propertyCache) {
+                    ++engine->lookupStatistics.polymorphicHits;
+                    return QObjectWrapper::getProperty(engine, qobj, entry.propertyData);
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    Lookup resolved;
+    resolved.clear();
+    resolved.getter = getterGeneric;
+    resolved.nameIndex = l->nameIndex;
+
+    const Object *obj = object.as<Object>();
+    if (!obj) {
+        // Don't give up on the shapes seen so far because of a primitive value
+        return resolved.resolvePrimitiveGetter(engine, object);
+    }
+
+    if (l->polymorphicLookup.cache->isFull()) {
+        l->releasePropertyCaches();
+        l->getter = getterFallback;
+        ++engine->lookupStatistics.megamorphicLookups;
+        return getterFallback(l, engine, object);
+    }
+
+    ReturnedValue result = resolved.resolveGetter(engine, obj);
+    PolymorphicLookup::Entry entry;
+    if (l->getter != getterPolymorphic || l->polymorphicLookup.cache->isFull()) {
+        // resolving may have run JavaScript that used this lookup in the meantime
+        resolved.releasePropertyCaches();
+    } else if (getterEntry(resolved, &entry)) {
+        l->polymorphicLookup.cache->append(entry);
+        ++engine->lookupStatistics.polymorphicEntries;
+    } else if (resolved.getter != getterGeneric) {
+        resolved.releasePropertyCaches();
+        l->releasePropertyCaches();
+        l->getter = getterFallback;
+        ++engine->lookupStatistics.megamorphicLookups;
+    }
+    return result;
+}
+
 ReturnedValue Lookup::primitiveGetterProto(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     if (object.type() == l->primitiveLookup.type && !object.isObject()) {
@@ -459,7 +643,6 @@ bool Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, co
 bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
     Lookup first = *l;
-    Lookup second = *l;
 
     if (object.isObject()) {
         if (!l->resolveSetter(engine, static_cast<Object *>(&object), value)) {
@@ -468,10 +651,12 @@ bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object,
         }
 
         if (l->setter == Lookup::setter0MemberData || l->setter == Lookup::setter0Inline) {
+            Heap::InternalClass *ic2 = l->objectLookup.ic;
+            const uint index2 = l->objectLookup.index;
             l->objectLookupTwoClasses.ic = first.objectLookup.ic;
-            l->objectLookupTwoClasses.ic2 = second.objectLookup.ic;
+            l->objectLookupTwoClasses.ic2 = ic2;
             l->objectLookupTwoClasses.offset = first.objectLookup.index;
-            l->objectLookupTwoClasses.offset2 = second.objectLookup.index;
+            l->objectLookupTwoClasses.offset2 = index2;
             l->setter = setter0setter0;
             return true;
         }
@@ -528,8 +713,60 @@ bool Lookup::setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, c
         }
     }
 
-    l->setter = setterFallback;
-    return setterFallback(l, engine, object, value);
+    const PolymorphicLookup::Entry entries[] = {
+        indexEntry(l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset),
+        indexEntry(l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2)
+    };
+    l->initPolymorphic(engine, entries, 2);
+    l->setter = setterPolymorphic;
+    return setterPolymorphic(l, engine, object, value);
+}
+
+bool Lookup::setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const PolymorphicLookup *cache = l->polymorphicLookup.cache;
+        for (uint i = 0; i < cache->nEntries; ++i) {
+            const PolymorphicLookup::Entry &entry = cache->entries[i];
+            if (entry.ic != o->internalClass)
+                continue;
+            ++engine->lookupStatistics.polymorphicHits;
+            if (entry.kind == PolymorphicLookup::InlineProperty)
+                o->setInlinePropertyWithOffset(engine, entry.offset, value);
+            else
+                o->memberData->values.set(engine, entry.offset, value);
+            return true;
+        }
+    }
+
+    if (!object.isObject() || l->polymorphicLookup.cache->isFull()) {
+        l->releasePropertyCaches();
+        l->setter = setterFallback;
+        ++engine->lookupStatistics.megamorphicLookups;
+        return setterFallback(l, engine, object, value);
+    }
+
+    Lookup resolved;
+    resolved.clear();
+    resolved.setter = setterGeneric;
+    resolved.nameIndex = l->nameIndex;
+    const bool result = resolved.resolveSetter(engine, static_cast<Object *>(&object), value);
+
+    // storing the value may have run JavaScript that used this lookup in the meantime
+    if (l->setter != setterPolymorphic || l->polymorphicLookup.cache->isFull())
+        return result;
+
+    PolymorphicLookup::Entry entry;
+    if (setterEntry(resolved, &entry)) {
+        l->polymorphicLookup.cache->append(entry);
+        ++engine->lookupStatistics.polymorphicEntries;
+    } else {
+        l->releasePropertyCaches();
+        l->setter = setterFallback;
+        ++engine->lookupStatistics.megamorphicLookups;
+    }
+    return result;
 }
 
 bool Lookup::setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
@@ -61,6 +61,48 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+struct ParentContextLookup;
+
+// Holds the shapes seen by a lookup that has seen more than two of them. The fast paths of
+// the lookup check the entries in order, a miss adds an entry as long as there is room.
+struct PolymorphicLookup
+{
+    enum { MaxEntries = 4 };
+
+    enum Kind : uint {
+        InlineProperty,
+        MemberDataProperty,
+        QObjectProperty
+    };
+
+    struct Entry {
+        Heap::InternalClass *ic;
+        Kind kind;
+        uint offset;
+        // only used for QObjectProperty, the property cache is ref-counted
+        QQmlPropertyCache *propertyCache;
+        QQmlPropertyData *propertyData;
+    };
+
+    Entry entries[MaxEntries];
+    uint nEntries = 0;
+
+    bool isFull() const { return nEntries == MaxEntries; }
+    void append(const Entry &entry)
+    {
+        Q_ASSERT(!isFull());
+        entries[nEntries++] = entry;
+    }
+
+    void markObjects(MarkStack *stack)
+    {
+        for (uint i = 0; i < nEntries; ++i)
+            entries[i].ic->mark(stack);
+    }
+
+    void releasePropertyCaches();
+};
+
 struct Q_QML_PRIVATE_EXPORT Lookup {
     union {
         ReturnedValue (*getter)(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -106,6 +148,12 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             const Value *data;
             quintptr type;
         } primitiveLookup;
+        struct {
+            // keep the first two entries null, the cache marks the internal classes
+            quintptr unused;
+            quintptr unused2;
+            PolymorphicLookup *cache;
+        } polymorphicLookup;
         struct {
             Heap::InternalClass *newClass;
             quintptr protoId;
@@ -144,6 +192,11 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             quintptr unused2;
             int objectId;
         } qmlContextIdObjectLookup;
+        struct {
+            quintptr unused1;
+            quintptr unused2;
+            ParentContextLookup *cache;
+        } qmlParentContextLookup;
         struct {
             // Same as protoLookup, as used for global lookups
             quintptr reserved1;
@@ -187,6 +240,7 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static ReturnedValue getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterIndexed(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
 
     static ReturnedValue primitiveGetterProto(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue primitiveGetterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -203,10 +257,18 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static bool setter0MemberData(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0Inline(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static bool setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool arrayLengthSetter(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
 
+    void initPolymorphic(ExecutionEngine *engine, const PolymorphicLookup::Entry *entries, uint nEntries);
+    void releasePropertyCaches();
+
     void markObjects(MarkStack *stack) {
+        if (getter == getterPolymorphic || setter == setterPolymorphic) {
+            polymorphicLookup.cache->markObjects(stack);
+            return;
+        }
         if (markDef.h1 && !(reinterpret_cast<quintptr>(markDef.h1) & 1))
             markDef.h1->mark(stack);
         if (markDef.h2 && !(reinterpret_cast<quintptr>(markDef.h2) & 1))
@@ -499,6 +499,8 @@ bool Object::internalPut(PropertyKey id, const Value &value, Value *receiver)
                         return false;
                 } else {
                     propertyIndex.set(scope.engine, value);
+                    if (id.isArrayIndex())
+                        d()->arrayData->updateElementKind(value);
                 }
                 return true;
             }
@@ -706,9 +708,10 @@ void Object::copyArrayData(Object *other)
             Heap::ArrayData *dd = d()->arrayData;
             dd->values.size = other->d()->arrayData->values.size;
             dd->offset = other->d()->arrayData->offset;
+            dd->elementKind = other->d()->arrayData->elementKind;
         }
-        // ### need a write barrier
         memcpy(d()->arrayData->values.values, other->d()->arrayData->values.values, other->d()->arrayData->values.alloc*sizeof(Value));
+        WriteBarrier::markCustom(engine(), d()->arrayData);
     }
     setArrayLengthUnchecked(other->getLength());
 }
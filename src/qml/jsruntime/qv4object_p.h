@@ -172,6 +172,8 @@ struct Q_QML_EXPORT Object: Managed {
         return vtable()->getOwnProperty(this, id, p);
     }
 
+    // Writing an array element through the returned index needs to update the element kind of
+    // the array data, like internalPut() does.
     PropertyIndex getValueOrSetter(PropertyKey id, PropertyAttributes *attrs);
 
     bool hasProperty(PropertyKey id) const {
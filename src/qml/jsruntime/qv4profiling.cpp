@@ -40,6 +40,9 @@
 #include "qv4profiling_p.h"
 #include <private/qv4mm_p.h>
 #include <private/qv4string_p.h>
+#include <private/qv4stackframe_p.h>
+
+#include <QtCore/qbuffer.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -69,14 +72,54 @@ Profiler::Profiler(QV4::ExecutionEngine *engine) : featuresEnabled(0), m_engine(
     static const int metatypes[] = {
         qRegisterMetaType<QVector<QV4::Profiling::FunctionCallProperties> >(),
         qRegisterMetaType<QVector<QV4::Profiling::MemoryAllocationProperties> >(),
+        qRegisterMetaType<QVector<QV4::Profiling::FunctionLocation> >(),
+        qRegisterMetaType<QVector<QByteArray> >(),
         qRegisterMetaType<FunctionLocationHash>()
     };
     Q_UNUSED(metatypes);
+
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue("QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL",
+                                                      &ok);
+    m_samplingInterval = (ok && interval > 0) ? size_t(interval) : 64 * 1024;
     m_timer.start();
 }
 
+void Profiler::sampleAllocationSite(qint64 timestamp)
+{
+    // Attribute everything allocated since the last sample to the current JavaScript frame.
+    // Allocations from C++ without a JavaScript caller are dropped.
+    const qint64 size = qint64(m_sampledBytes);
+    m_sampledBytes = 0;
+
+    const CppStackFrame *frame = m_engine->currentStackFrame;
+    if (!frame || !frame->v4Function)
+        return;
+
+    const Function *function = frame->v4Function;
+    MemoryAllocationProperties sample = {timestamp, size, SampledAllocation};
+    m_memory_data.append(sample);
+    m_allocationSites.append(FunctionLocation(function->name()->toQString(),
+                                              function->sourceFile(), frame->lineNumber()));
+}
+
+void Profiler::takeHeapSnapshot()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (m_engine->memoryManager->writeHeapSnapshot(&buffer) < 0)
+        return;
+
+    MemoryAllocationProperties snapshot = {m_timer.nsecsElapsed(), buffer.data().size(),
+                                           HeapSnapshot};
+    m_memory_data.append(snapshot);
+    m_heapSnapshots.append(buffer.data());
+}
+
 void Profiler::stopProfiling()
 {
+    if (featuresEnabled & (1 << FeatureHeapSnapshot))
+        takeHeapSnapshot();
     featuresEnabled = 0;
     reportData();
     m_sentLocations.clear();
@@ -108,9 +151,11 @@ void Profiler::reportData()
         }
     }
 
-    emit dataReady(locations, properties, m_memory_data);
+    emit dataReady(locations, properties, m_memory_data, m_allocationSites, m_heapSnapshots);
     m_data.clear();
     m_memory_data.clear();
+    m_allocationSites.clear();
+    m_heapSnapshots.clear();
 }
 
 void Profiler::startProfiling(quint64 features)
@@ -133,6 +178,7 @@ void Profiler::startProfiling(quint64 features)
             m_memory_data.append(large);
         }
 
+        m_sampledBytes = 0;
         featuresEnabled = features;
     }
 }
@@ -96,13 +96,16 @@ namespace Profiling {
 
 enum Features {
     FeatureFunctionCall,
-    FeatureMemoryAllocation
+    FeatureMemoryAllocation,
+    FeatureHeapSnapshot
 };
 
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    SampledAllocation, // size is the number of bytes allocated since the previous sample
+    HeapSnapshot       // size is the length of the snapshot data
 };
 
 struct FunctionCallProperties {
@@ -230,6 +233,10 @@ public:
         if (size) {
             MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), (qint64)size, type};
             m_memory_data.append(allocation);
+            if ((featuresEnabled & (1 << FeatureHeapSnapshot)) && type != HeapPage
+                    && (m_sampledBytes += size) >= m_samplingInterval) {
+                sampleAllocationSite(allocation.timestamp);
+            }
             return true;
         } else {
             return false;
@@ -255,16 +262,27 @@ public:
     void setTimer(const QElapsedTimer &timer) { m_timer = timer; }
 
 signals:
+    // The allocation sites and heap snapshots belong to the SampledAllocation and HeapSnapshot
+    // entries in the memory data, in the same order.
     void dataReady(const QV4::Profiling::FunctionLocationHash &,
                    const QVector<QV4::Profiling::FunctionCallProperties> &,
-                   const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                   const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                   const QVector<QV4::Profiling::FunctionLocation> &,
+                   const QVector<QByteArray> &);
 
 private:
+    void sampleAllocationSite(qint64 timestamp);
+    void takeHeapSnapshot();
+
     QV4::ExecutionEngine *m_engine;
     QElapsedTimer m_timer;
     QVector<FunctionCall> m_data;
     QVector<MemoryAllocationProperties> m_memory_data;
+    QVector<FunctionLocation> m_allocationSites;
+    QVector<QByteArray> m_heapSnapshots;
     QHash<quintptr, SentMarker> m_sentLocations;
+    size_t m_sampledBytes = 0;
+    size_t m_samplingInterval;
 
     friend class FunctionCallProfiler;
 };
@@ -311,6 +329,7 @@ QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QV4::Profiling::FunctionLocationHash)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionCallProperties>)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::MemoryAllocationProperties>)
+Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionLocation>)
 
 #endif // QT_CONFIG(qml_debug)
 
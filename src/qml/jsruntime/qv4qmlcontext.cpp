@@ -78,9 +78,61 @@ void Heap::QQmlContextWrapper::destroy()
     Object::destroy();
 }
 
+ParentContextLookup::~ParentContextLookup()
+{
+    if (propertyCache)
+        propertyCache->release();
+}
+
+// Sets up a lookup for a name found in context, which is above the parent of expressionContext
+static ParentContextLookup *cacheInParentContext(QV4::Lookup *lookup, QQmlContextData *expressionContext,
+                                                 QQmlContextData *context,
+                                                 ReturnedValue (*getter)(Lookup *, ExecutionEngine *, Value *))
+{
+    ParentContextLookup *cache = new ParentContextLookup;
+    cache->parentContext = expressionContext->parent;
+    cache->nameGeneration = expressionContext->nameGeneration + context->nameGeneration;
+    for (QQmlContextData *c = expressionContext->parent; c != context; c = c->parent) {
+        cache->nameGeneration += c->nameGeneration;
+        ++cache->depth;
+    }
+
+    lookup->clear();
+    lookup->qmlParentContextLookup.cache = cache;
+    lookup->qmlContextPropertyGetter = getter;
+    return cache;
+}
+
+static ReturnedValue idObjectValue(QV4::ExecutionEngine *v4, QQmlContextData *context, int objectId,
+                                   QQmlEnginePrivate *ep)
+{
+    if (ep->propertyCapture)
+        ep->propertyCapture->captureProperty(&context->idValues[objectId].bindings);
+    return QV4::QObjectWrapper::wrap(v4, context->idValues[objectId]);
+}
+
+static ReturnedValue contextPropertyValue(QV4::ExecutionEngine *v4, QQmlContextData *context, int propertyIdx,
+                                          QQmlEnginePrivate *ep)
+{
+    QQmlContextPrivate *cp = context->asQQmlContextPrivate();
+
+    if (ep->propertyCapture)
+        ep->propertyCapture->captureProperty(context->asQQmlContext(), -1, propertyIdx + cp->notifyIndex);
+
+    const QVariant &value = cp->propertyValues.at(propertyIdx);
+    if (value.userType() == qMetaTypeId<QList<QObject*> >()) {
+        QQmlListProperty<QObject> prop(context->asQQmlContext(), (void*) qintptr(propertyIdx),
+                                       QQmlContextPrivate::context_count,
+                                       QQmlContextPrivate::context_at);
+        return QmlListWrapper::create(v4, prop, qMetaTypeId<QQmlListProperty<QObject> >());
+    }
+    return v4->fromVariant(cp->propertyValues.at(propertyIdx));
+}
+
 static OptionalReturnedValue searchContextProperties(QV4::ExecutionEngine *v4, QQmlContextData *context, String *name,
                                                      bool *hasProperty, Value *base, QV4::Lookup *lookup,
-                                                     QV4::Lookup *originalLookup, QQmlEnginePrivate *ep)
+                                                     QV4::Lookup *originalLookup, QQmlContextData *expressionContext,
+                                                     QQmlEnginePrivate *ep)
 {
     const QV4::IdentifierHash &properties = context->propertyNames();
     if (properties.count() == 0)
@@ -100,29 +152,20 @@ static OptionalReturnedValue searchContextProperties(QV4::ExecutionEngine *v4, Q
             lookup->qmlContextPropertyGetter = QQmlContextWrapper::lookupIdObject;
             return OptionalReturnedValue(lookup->qmlContextPropertyGetter(lookup, v4, base));
         } else if (originalLookup) {
-            originalLookup->qmlContextPropertyGetter = QQmlContextWrapper::lookupInParentContextHierarchy;
+            cacheInParentContext(originalLookup, expressionContext, context,
+                                 QQmlContextWrapper::lookupIdObjectInParentContext)->index = propertyIdx;
         }
 
-        if (ep->propertyCapture)
-            ep->propertyCapture->captureProperty(&context->idValues[propertyIdx].bindings);
-        return OptionalReturnedValue(QV4::QObjectWrapper::wrap(v4, context->idValues[propertyIdx]));
+        return OptionalReturnedValue(idObjectValue(v4, context, propertyIdx, ep));
     }
 
-    QQmlContextPrivate *cp = context->asQQmlContextPrivate();
-
-    if (ep->propertyCapture)
-        ep->propertyCapture->captureProperty(context->asQQmlContext(), -1, propertyIdx + cp->notifyIndex);
-
-    const QVariant &value = cp->propertyValues.at(propertyIdx);
     if (hasProperty)
         *hasProperty = true;
-    if (value.userType() == qMetaTypeId<QList<QObject*> >()) {
-        QQmlListProperty<QObject> prop(context->asQQmlContext(), (void*) qintptr(propertyIdx),
-                                       QQmlContextPrivate::context_count,
-                                       QQmlContextPrivate::context_at);
-        return OptionalReturnedValue(QmlListWrapper::create(v4, prop, qMetaTypeId<QQmlListProperty<QObject> >()));
+    if (!lookup && originalLookup) {
+        cacheInParentContext(originalLookup, expressionContext, context,
+                             QQmlContextWrapper::lookupContextPropertyInParentContext)->index = propertyIdx;
     }
-    return OptionalReturnedValue(v4->fromVariant(cp->propertyValues.at(propertyIdx)));
+    return OptionalReturnedValue(contextPropertyValue(v4, context, propertyIdx, ep));
 }
 
 ReturnedValue QQmlContextWrapper::getPropertyAndBase(const QQmlContextWrapper *resource, PropertyKey id, const Value *receiver, bool *hasProperty, Value *base, Lookup *lookup)
@@ -273,8 +316,12 @@ ReturnedValue QQmlContextWrapper::getPropertyAndBase(const QQmlContextWrapper *r
         contextGetterFunction = QQmlContextWrapper::lookupScopeObjectProperty;
     }
 
+    // Names found further up are cached as long as the objects in between can't grow new properties
+    Lookup *parentContextLookup = originalLookup;
+
     while (context) {
-        if (auto property = searchContextProperties(v4, context, name, hasProperty, base, lookup, originalLookup, ep))
+        if (auto property = searchContextProperties(v4, context, name, hasProperty, base, lookup, parentContextLookup,
+                                                    expressionContext, ep))
             return *property;
 
         // Search scope object
@@ -334,12 +381,25 @@ ReturnedValue QQmlContextWrapper::getPropertyAndBase(const QQmlContextWrapper *r
                             lookup->qmlContextPropertyGetter = contextGetterFunction;
                         }
                     } else if (originalLookup) {
-                        originalLookup->qmlContextPropertyGetter = lookupInParentContextHierarchy;
+                        QQmlData *ddata = QQmlData::get(context->contextObject, false);
+                        if (parentContextLookup && ddata && ddata->propertyCache) {
+                            ParentContextLookup *cache = cacheInParentContext(
+                                        originalLookup, expressionContext, context,
+                                        lookupContextObjectPropertyInParentContext);
+                            cache->propertyCache = ddata->propertyCache;
+                            cache->propertyCache->addref();
+                            cache->propertyData = propertyData;
+                        } else {
+                            originalLookup->qmlContextPropertyGetter = lookupInParentContextHierarchy;
+                        }
                     }
                 }
 
                 return result->asReturnedValue();
             }
+
+            if (QQmlPropertyCache::isDynamicMetaObject(context->contextObject->metaObject()))
+                parentContextLookup = nullptr;
         }
 
         context = context->parent;
@@ -636,7 +696,8 @@ ReturnedValue QQmlContextWrapper::lookupInParentContextHierarchy(Lookup *l, Exec
     ScopedValue result(scope);
 
     for (context = context->parent; context; context = context->parent) {
-        if (auto property = searchContextProperties(engine, context, name, nullptr, base, nullptr, nullptr, ep))
+        if (auto property = searchContextProperties(engine, context, name, nullptr, base, nullptr, nullptr,
+                                                    nullptr, ep))
             return *property;
 
         // Search context object
@@ -663,6 +724,103 @@ ReturnedValue QQmlContextWrapper::lookupInParentContextHierarchy(Lookup *l, Exec
     return Encode::undefined();
 }
 
+// Returns the context a ParentContextLookup was resolved to, if the path to it is still the same
+// and no names were added on the way since
+static QQmlContextData *cachedParentContext(Lookup *l, QQmlContextData *context)
+{
+    const ParentContextLookup *cache = l->qmlParentContextLookup.cache;
+    if (!context->parent || context->parent != cache->parentContext.contextData())
+        return nullptr;
+
+    // Generations only ever grow, so any change on the path changes their sum.
+    quint32 nameGeneration = context->nameGeneration;
+    context = context->parent;
+    for (int i = 0; context && i < cache->depth; ++i) {
+        nameGeneration += context->nameGeneration;
+        context = context->parent;
+    }
+    if (!context || nameGeneration + context->nameGeneration != cache->nameGeneration)
+        return nullptr;
+    return context;
+}
+
+static ReturnedValue revertParentContextLookup(Lookup *l, ExecutionEngine *engine, Value *base)
+{
+    delete l->qmlParentContextLookup.cache;
+    l->clear();
+    l->qmlContextPropertyGetter = QQmlContextWrapper::resolveQmlContextPropertyLookupGetter;
+    return QQmlContextWrapper::resolveQmlContextPropertyLookupGetter(l, engine, base);
+}
+
+ReturnedValue QQmlContextWrapper::lookupIdObjectInParentContext(Lookup *l, ExecutionEngine *engine, Value *base)
+{
+    Scope scope(engine);
+    Scoped<QmlContext> qmlContext(scope, engine->qmlContext());
+    if (!qmlContext)
+        return QV4::Encode::null();
+
+    QQmlContextData *context = qmlContext->qmlContext();
+    if (!context)
+        return QV4::Encode::null();
+
+    context = cachedParentContext(l, context);
+    const int objectId = l->qmlParentContextLookup.cache->index;
+    if (!context || objectId >= context->idValueCount)
+        return revertParentContextLookup(l, engine, base);
+
+    return idObjectValue(engine, context, objectId, QQmlEnginePrivate::get(engine->qmlEngine()));
+}
+
+ReturnedValue QQmlContextWrapper::lookupContextPropertyInParentContext(Lookup *l, ExecutionEngine *engine, Value *base)
+{
+    Scope scope(engine);
+    Scoped<QmlContext> qmlContext(scope, engine->qmlContext());
+    if (!qmlContext)
+        return QV4::Encode::undefined();
+
+    QQmlContextData *context = qmlContext->qmlContext();
+    if (!context)
+        return QV4::Encode::undefined();
+
+    context = cachedParentContext(l, context);
+    const int propertyIdx = l->qmlParentContextLookup.cache->index;
+    if (!context || propertyIdx >= context->asQQmlContextPrivate()->propertyValues.count())
+        return revertParentContextLookup(l, engine, base);
+
+    return contextPropertyValue(engine, context, propertyIdx, QQmlEnginePrivate::get(engine->qmlEngine()));
+}
+
+ReturnedValue QQmlContextWrapper::lookupContextObjectPropertyInParentContext(Lookup *l, ExecutionEngine *engine,
+                                                                           Value *base)
+{
+    Scope scope(engine);
+    Scoped<QmlContext> qmlContext(scope, engine->qmlContext());
+    if (!qmlContext)
+        return QV4::Encode::undefined();
+
+    QQmlContextData *context = qmlContext->qmlContext();
+    if (!context)
+        return QV4::Encode::undefined();
+
+    context = cachedParentContext(l, context);
+    QObject *contextObject = context ? context->contextObject : nullptr;
+    if (!contextObject)
+        return revertParentContextLookup(l, engine, base);
+
+    if (QQmlData::wasDeleted(contextObject))
+        return QV4::Encode::undefined();
+
+    const ParentContextLookup *cache = l->qmlParentContextLookup.cache;
+    QQmlData *ddata = QQmlData::get(contextObject, false);
+    if (!ddata || ddata->propertyCache != cache->propertyCache)
+        return revertParentContextLookup(l, engine, base);
+
+    if (base)
+        *base = QV4::QObjectWrapper::wrap(engine, contextObject);
+
+    return QV4::QObjectWrapper::getProperty(engine, contextObject, cache->propertyData);
+}
+
 ReturnedValue QQmlContextWrapper::lookupType(Lookup *l, ExecutionEngine *engine, Value *base)
 {
     Scope scope(engine);
@@ -90,6 +90,20 @@ DECLARE_HEAP_OBJECT(QmlContext, ExecutionContext) {
 
 }
 
+// Remembers where a name was found above the QML context a lookup is used in. The path
+// through the context hierarchy is the same as long as that context has the same parent.
+struct ParentContextLookup
+{
+    QQmlGuardedContextData parentContext;
+    int depth = 0; // of the context the name was found in, above parentContext
+    int index = -1; // id or context property index
+    quint32 nameGeneration = 0; // sum of the contexts' generations along the path
+    QQmlPropertyCache *propertyCache = nullptr; // ref-counted
+    QQmlPropertyData *propertyData = nullptr;
+
+    ~ParentContextLookup();
+};
+
 struct Q_QML_EXPORT QQmlContextWrapper : Object
 {
     V4_OBJECT2(QQmlContextWrapper, Object)
@@ -112,6 +126,9 @@ struct Q_QML_EXPORT QQmlContextWrapper : Object
     static ReturnedValue lookupContextObjectProperty(Lookup *l, ExecutionEngine *engine, Value *base);
     static ReturnedValue lookupInGlobalObject(Lookup *l, ExecutionEngine *engine, Value *base);
     static ReturnedValue lookupInParentContextHierarchy(Lookup *l, ExecutionEngine *engine, Value *base);
+    static ReturnedValue lookupIdObjectInParentContext(Lookup *l, ExecutionEngine *engine, Value *base);
+    static ReturnedValue lookupContextPropertyInParentContext(Lookup *l, ExecutionEngine *engine, Value *base);
+    static ReturnedValue lookupContextObjectPropertyInParentContext(Lookup *l, ExecutionEngine *engine, Value *base);
     static ReturnedValue lookupType(Lookup *l, ExecutionEngine *engine, Value *base);
 };
 
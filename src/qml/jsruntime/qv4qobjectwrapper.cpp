@@ -885,6 +885,16 @@ ReturnedValue QObjectWrapper::virtualResolveLookupGetter(const Object *object, E
 ReturnedValue QObjectWrapper::lookupGetter(Lookup *lookup, ExecutionEngine *engine, const Value &object)
 {
     const auto revertLookup = [lookup, engine, &object]() {
+        if (object.as<Object>()) {
+            // Another type of object, remember both
+            const PolymorphicLookup::Entry entry = {
+                lookup->qobjectLookup.ic, PolymorphicLookup::QObjectProperty, 0,
+                lookup->qobjectLookup.propertyCache, lookup->qobjectLookup.propertyData
+            };
+            lookup->initPolymorphic(engine, &entry, 1);
+            lookup->getter = Lookup::getterPolymorphic;
+            return Lookup::getterPolymorphic(lookup, engine, object);
+        }
         lookup->qobjectLookup.propertyCache->release();
         lookup->qobjectLookup.propertyCache = nullptr;
         lookup->getter = Lookup::getterGeneric;
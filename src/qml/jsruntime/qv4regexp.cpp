@@ -40,9 +40,12 @@
 #include "qv4regexp_p.h"
 #include "qv4engine_p.h"
 #include "qv4scopedvalue_p.h"
+#include "qv4executableallocator_p.h"
 #include <private/qv4mm_p.h>
 #include <runtime/VM.h>
 
+#include <QtCore/qmutex.h>
+
 using namespace QV4;
 
 static JSC::RegExpFlags jscFlags(uint flags)
@@ -61,6 +64,136 @@ static JSC::RegExpFlags jscFlags(uint flags)
     return jscFlags;
 }
 
+static JSC::Yarr::BytecodePattern *compileByteCode(ExecutionEngine *engine, const QString &pattern, uint flags)
+{
+    JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
+    JSC::Yarr::YarrPattern yarrPattern(WTF::String(pattern), jscFlags(flags), error);
+
+    // As we successfully parsed the pattern before, we should still be able to.
+    Q_ASSERT(error == JSC::Yarr::ErrorCode::NoError);
+
+    return JSC::Yarr::byteCompile(yarrPattern, engine->bumperPointerAllocator).release();
+}
+
+namespace {
+
+// Engines that may not JIT must not pick up code compiled by one that may,
+// so the JIT decision is part of the key.
+struct SharedRegExpCodeKey
+{
+    SharedRegExpCodeKey(const QString &pattern, uint flags, bool jit)
+        : key(pattern, flags), jit(jit)
+    { }
+
+    bool operator==(const SharedRegExpCodeKey &other) const
+    { return jit == other.jit && key == other.key; }
+
+    RegExpCacheKey key;
+    bool jit;
+};
+
+inline uint qHash(const SharedRegExpCodeKey &key, uint seed = 0) Q_DECL_NOTHROW
+{ return qHash(key.key, seed) ^ uint(key.jit); }
+
+struct SharedRegExpCodeRegistry
+{
+    QMutex mutex;
+    QHash<SharedRegExpCodeKey, SharedRegExpCode *> code;
+
+    // Holds the JIT code of all engines, so that it stays valid as long as
+    // any engine that may be using it is alive.
+    ExecutableAllocator *allocator = nullptr;
+    int allocatorRefCount = 0;
+};
+
+}
+
+Q_GLOBAL_STATIC(SharedRegExpCodeRegistry, sharedRegExpCodeRegistry)
+
+SharedRegExpCode *SharedRegExpCode::get(ExecutionEngine *engine, const QString &pattern, uint flags,
+                                        JSC::Yarr::BytecodePattern **byteCode)
+{
+    SharedRegExpCodeRegistry *registry = sharedRegExpCodeRegistry();
+    const bool jit = engine->canJIT();
+    const SharedRegExpCodeKey key(pattern, flags, jit);
+
+    {
+        QMutexLocker locker(&registry->mutex);
+        if (SharedRegExpCode *code = registry->code.value(key)) {
+            ++code->refCount;
+            return code;
+        }
+    }
+
+    // Compile outside of the lock, so that engines on other threads are not
+    // held up. If another thread wins the race, its result is used instead.
+    SharedRegExpCode *code = new SharedRegExpCode(pattern, flags, jit);
+    JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
+    JSC::Yarr::YarrPattern yarrPattern(WTF::String(pattern), jscFlags(flags), error);
+    if (error == JSC::Yarr::ErrorCode::NoError) {
+        code->valid = true;
+        code->subPatternCount = yarrPattern.m_numSubpatterns;
+#if ENABLE(YARR_JIT)
+        if (!yarrPattern.m_containsBackreferences && jit) {
+            JSC::VM *vm = static_cast<JSC::VM *>(engine);
+            JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, vm, code->jitCode);
+        }
+#endif
+        // Save the caller from parsing the pattern a second time.
+        if (!code->hasValidJITCode())
+            *byteCode = JSC::Yarr::byteCompile(yarrPattern, engine->bumperPointerAllocator).release();
+    }
+
+    QMutexLocker locker(&registry->mutex);
+    SharedRegExpCode *&entry = registry->code[key];
+    if (entry) {
+        ++entry->refCount;
+        locker.unlock();
+        delete code;
+        return entry;
+    }
+    entry = code;
+    return code;
+}
+
+void SharedRegExpCode::release()
+{
+    if (sharedRegExpCodeRegistry.isDestroyed())
+        return;
+
+    SharedRegExpCodeRegistry *registry = sharedRegExpCodeRegistry();
+    QMutexLocker locker(&registry->mutex);
+    if (--refCount)
+        return;
+    registry->code.remove(SharedRegExpCodeKey(pattern, flags, jit));
+    locker.unlock();
+    delete this;
+}
+
+ExecutableAllocator *SharedRegExpCode::acquireAllocator()
+{
+    SharedRegExpCodeRegistry *registry = sharedRegExpCodeRegistry();
+    QMutexLocker locker(&registry->mutex);
+    if (!registry->allocatorRefCount++)
+        registry->allocator = new ExecutableAllocator;
+    return registry->allocator;
+}
+
+void SharedRegExpCode::releaseAllocator()
+{
+    // Engines destroyed during static destruction leak the allocator.
+    if (sharedRegExpCodeRegistry.isDestroyed())
+        return;
+
+    SharedRegExpCodeRegistry *registry = sharedRegExpCodeRegistry();
+    QMutexLocker locker(&registry->mutex);
+    if (--registry->allocatorRefCount)
+        return;
+    Q_ASSERT(registry->code.isEmpty());
+    delete registry->allocator;
+    registry->allocator = nullptr;
+}
+
 RegExpCache::~RegExpCache()
 {
     for (RegExpCache::Iterator it = begin(), e = end(); it != e; ++it) {
@@ -96,18 +229,8 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
             return ret;
 
         // JIT failed. We need byteCode to run the interpreter.
-        if (!priv->byteCode) {
-            JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
-            JSC::Yarr::YarrPattern yarrPattern(WTF::String(*priv->pattern), jscFlags(priv->flags),
-                                               error);
-
-            // As we successfully parsed the pattern before, we should still be able to.
-            Q_ASSERT(error == JSC::Yarr::ErrorCode::NoError);
-
-            priv->byteCode = JSC::Yarr::byteCompile(
-                                     yarrPattern,
-                                     priv->internalClass->engine->bumperPointerAllocator).release();
-        }
+        if (!priv->byteCode)
+            priv->byteCode = compileByteCode(priv->internalClass->engine, *priv->pattern, priv->flags);
     }
 #endif // ENABLE(YARR_JIT)
 
@@ -213,25 +336,16 @@ void Heap::RegExp::init(ExecutionEngine *engine, const QString &pattern, uint fl
 
     valid = false;
 
-    JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
-    JSC::Yarr::YarrPattern yarrPattern(WTF::String(pattern), jscFlags(flags), error);
-    if (error != JSC::Yarr::ErrorCode::NoError)
+    sharedCode = SharedRegExpCode::get(engine, pattern, flags, &byteCode);
+    if (!sharedCode->valid)
         return;
-    subPatternCount = yarrPattern.m_numSubpatterns;
-#if ENABLE(YARR_JIT)
-    if (!yarrPattern.m_containsBackreferences && engine->canJIT()) {
-        jitCode = new JSC::Yarr::YarrCodeBlock;
-        JSC::VM *vm = static_cast<JSC::VM *>(engine);
-        JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, vm, *jitCode);
-    }
-#else
-    Q_UNUSED(engine)
-#endif
+    subPatternCount = sharedCode->subPatternCount;
     if (hasValidJITCode()) {
         valid = true;
         return;
     }
-    byteCode = JSC::Yarr::byteCompile(yarrPattern, internalClass->engine->bumperPointerAllocator).release();
+    if (!byteCode)
+        byteCode = compileByteCode(engine, pattern, flags);
     if (byteCode)
         valid = true;
 }
@@ -242,9 +356,8 @@ void Heap::RegExp::destroy()
         RegExpCacheKey key(this);
         cache->remove(key);
     }
-#if ENABLE(YARR_JIT)
-    delete jitCode;
-#endif
+    if (sharedCode)
+        sharedCode->release();
     delete byteCode;
     delete pattern;
     Base::destroy();
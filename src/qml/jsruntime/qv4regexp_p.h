@@ -73,25 +73,52 @@ namespace QV4 {
 struct ExecutionEngine;
 struct RegExpCacheKey;
 
-namespace Heap {
+// The result of parsing and JIT compiling a pattern, shared by all engines in
+// the process that agree on whether to JIT. The byte code is not part of it, as the Yarr interpreter
+// allocates from the bump pointer allocator of the engine running it.
+struct SharedRegExpCode
+{
+    static SharedRegExpCode *get(ExecutionEngine *engine, const QString &pattern, uint flags,
+                                 JSC::Yarr::BytecodePattern **byteCode);
+    void release();
 
-struct RegExp : Base {
-    void init(ExecutionEngine *engine, const QString& pattern, uint flags);
-    void destroy();
+    static ExecutableAllocator *acquireAllocator();
+    static void releaseAllocator();
 
-    QString *pattern;
-    JSC::Yarr::BytecodePattern *byteCode;
-#if ENABLE(YARR_JIT)
-    JSC::Yarr::YarrCodeBlock *jitCode;
-#endif
     bool hasValidJITCode() const {
 #if ENABLE(YARR_JIT)
-        return jitCode && !jitCode->failureReason().has_value() && jitCode->has16BitCode();
+        return !jitCode.failureReason().has_value() && jitCode.has16BitCode();
 #else
         return false;
 #endif
     }
 
+    QString pattern;
+    uint flags = 0;
+    bool jit = false;
+    int subPatternCount = 0;
+    int refCount = 1; // protected by the registry's mutex
+    bool valid = false;
+#if ENABLE(YARR_JIT)
+    JSC::Yarr::YarrCodeBlock jitCode;
+#endif
+
+private:
+    SharedRegExpCode(const QString &pattern, uint flags, bool jit)
+        : pattern(pattern), flags(flags), jit(jit) {}
+};
+
+namespace Heap {
+
+struct RegExp : Base {
+    void init(ExecutionEngine *engine, const QString& pattern, uint flags);
+    void destroy();
+
+    QString *pattern;
+    JSC::Yarr::BytecodePattern *byteCode;
+    SharedRegExpCode *sharedCode;
+    bool hasValidJITCode() const { return sharedCode && sharedCode->hasValidJITCode(); }
+
     bool ignoreCase() const { return flags & CompiledData::RegExp::RegExp_IgnoreCase; }
     bool multiLine() const { return flags & CompiledData::RegExp::RegExp_Multiline; }
     bool global() const { return flags & CompiledData::RegExp::RegExp_Global; }
@@ -120,7 +147,7 @@ struct RegExp : public Managed
     QString pattern() const { return *d()->pattern; }
     JSC::Yarr::BytecodePattern *byteCode() { return d()->byteCode; }
 #if ENABLE(YARR_JIT)
-    JSC::Yarr::YarrCodeBlock *jitCode() const { return d()->jitCode; }
+    JSC::Yarr::YarrCodeBlock *jitCode() const { return d()->sharedCode ? &d()->sharedCode->jitCode : nullptr; }
 #endif
     RegExpCache *cache() const { return d()->cache; }
     int subPatternCount() const { return d()->subPatternCount; }
@@ -613,8 +613,7 @@ QV4::ReturnedValue RuntimeHelpers::addHelper(ExecutionEngine *engine, const Valu
             return sright->asReturnedValue();
         if (!sright->d()->length())
             return sleft->asReturnedValue();
-        MemoryManager *mm = engine->memoryManager;
-        return (mm->alloc<ComplexString>(sleft->d(), sright->d()))->asReturnedValue();
+        return String::concat(engine, sleft, sright);
     }
     double x = RuntimeHelpers::toNumber(pleft);
     double y = RuntimeHelpers::toNumber(pright);
@@ -1925,9 +1924,9 @@ QV4::ReturnedValue Runtime::CreateRestParameter::call(ExecutionEngine *engine, i
 
 ReturnedValue Runtime::RegexpLiteral::call(ExecutionEngine *engine, int id)
 {
-    const auto val
-            = engine->currentStackFrame->v4Function->compilationUnit->runtimeRegularExpressions[id];
-    Heap::RegExpObject *ro = engine->newRegExpObject(Value::fromStaticValue(val).as<RegExp>());
+    Scope scope(engine);
+    Scoped<RegExp> re(scope, engine->currentStackFrame->v4Function->compilationUnit->runtimeRegularExpression(id));
+    Heap::RegExpObject *ro = engine->newRegExpObject(re);
     return ro->asReturnedValue();
 }
 
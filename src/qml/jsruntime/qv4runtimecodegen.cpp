@@ -67,6 +67,29 @@ void RuntimeCodegen::generateFromFunctionExpression(const QString &fileName,
     _module->rootContext = _module->functions.at(index);
 }
 
+void RuntimeCodegen::generateFromLazyFunction(const QString &fileName, const QString &finalUrl,
+                                              const QString &sourceCode, const QString &name,
+                                              AST::FunctionExpression *ast,
+                                              Compiler::Module *module)
+{
+    _module = module;
+    _module->fileName = fileName;
+    _module->finalUrl = finalUrl;
+    _context = nullptr;
+
+    Compiler::ScanFunctions scan(this, sourceCode, Compiler::ContextType::Global);
+    // The enclosing scopes are only known at run-time, so resolve free names there, as in eval
+    scan.enterEnvironment(nullptr, Compiler::ContextType::Eval, QString());
+    scan(ast);
+    scan.leaveEnvironment();
+
+    if (hasError())
+        return;
+
+    int index = defineFunction(name, ast, ast->formals, ast->body);
+    _module->rootContext = _module->functions.at(index);
+}
+
 void RuntimeCodegen::throwSyntaxError(const AST::SourceLocation &loc, const QString &detail)
 {
     if (hasError())
@@ -69,6 +69,11 @@ public:
                                         QQmlJS::AST::FunctionExpression *ast,
                                         Compiler::Module *module);
 
+    void generateFromLazyFunction(const QString &fileName, const QString &finalUrl,
+                                  const QString &sourceCode, const QString &name,
+                                  QQmlJS::AST::FunctionExpression *ast,
+                                  Compiler::Module *module);
+
     void throwSyntaxError(const QQmlJS::AST::SourceLocation &loc, const QString &detail) override;
     void throwReferenceError(const QQmlJS::AST::SourceLocation &loc, const QString &detail) override;
 
@@ -142,6 +142,7 @@ ReturnedValue WeakSetPrototype::method_add(const FunctionObject *b, const Value
         return scope.engine->throwTypeError();
 
     that->d()->esTable->set(argv[0], Value::undefinedValue());
+    WriteBarrier::markCustom(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
@@ -230,6 +231,7 @@ ReturnedValue SetPrototype::method_add(const FunctionObject *b, const Value *thi
         return scope.engine->throwTypeError();
 
     that->d()->esTable->set(argv[0], Value::undefinedValue());
+    WriteBarrier::markCustom(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
@@ -80,6 +80,10 @@ struct Q_QML_EXPORT CppStackFrame {
     void init(EngineBase *engine, Function *v4Function, const Value *argv, int argc, bool callerCanHandleTailCall = false) {
         this->engine = engine;
 
+        if (Q_UNLIKELY(v4Function && v4Function->compiledFunction && v4Function->isLazy())) {
+            v4Function = v4Function->lazilyCompiledFunction ? v4Function->lazilyCompiledFunction
+                                                            : v4Function->compileLazily(engine);
+        }
         this->v4Function = v4Function;
         originalArguments = argv;
         originalArgumentsCount = argc;
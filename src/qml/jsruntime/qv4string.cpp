@@ -43,7 +43,10 @@
 #include "qv4runtime_p.h"
 #include "qv4objectproto_p.h"
 #include "qv4stringobject_p.h"
+#include "qv4scopedvalue_p.h"
+#include <private/qv4mm_p.h>
 #include <QtCore/QHash>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/private/qnumeric_p.h>
 
 using namespace QV4;
@@ -116,6 +119,7 @@ void Heap::ComplexString::init(String *l, String *r)
         largestSubLength = qMax(largestSubLength, static_cast<ComplexString *>(right)->largestSubLength);
     else
         largestSubLength = qMax(largestSubLength, right->length());
+    depth = qMax(ropeDepth(left), ropeDepth(right)) + 1;
 
     // make sure we don't get excessive depth in our strings
     if (len > 256 && len >= 2*largestSubLength)
@@ -132,6 +136,7 @@ void Heap::ComplexString::init(Heap::String *ref, int from, int len)
     left = ref;
     this->from = from;
     this->len = len;
+    depth = 0;
 }
 
 void Heap::StringOrSymbol::destroy()
@@ -190,10 +195,12 @@ void Heap::String::simplifyString() const
 
 bool Heap::String::startsWithUpper() const
 {
-    if (subtype == StringType_AddedString)
-        return static_cast<const Heap::ComplexString *>(this)->left->startsWithUpper();
-
     const Heap::String *str = this;
+    while (str->subtype == StringType_AddedString)
+        str = static_cast<const Heap::ComplexString *>(str)->left;
+    if (str != this)
+        return str->startsWithUpper();
+
     int offset = 0;
     if (subtype == StringType_SubString) {
         const ComplexString *cs = static_cast<const Heap::ComplexString *>(this);
@@ -234,6 +241,83 @@ void Heap::String::append(const String *data, QChar *ch)
     }
 }
 
+ReturnedValue String::concat(ExecutionEngine *engine, const String *left, const String *right)
+{
+    Scope scope(engine);
+    Heap::String *l = left->d();
+    Heap::String *r = right->d();
+
+    // Short results are cheaper to copy than to keep as a rope.
+    if (l->length() + r->length() <= Heap::ComplexString::ShortStringLength)
+        return engine->newString(l->toQString() + r->toQString())->asReturnedValue();
+
+    // Appending a short piece to a rope: merge it into the rope's rightmost leaf instead of
+    // growing the tree by one node per piece.
+    if (l->subtype == Heap::String::StringType_AddedString
+            && r->length() < Heap::ComplexString::ShortStringLength) {
+        Heap::ComplexString *cs = static_cast<Heap::ComplexString *>(l);
+        if (cs->right->length() + r->length() <= Heap::ComplexString::ShortStringLength) {
+            ScopedString leaf(scope, engine->newString(cs->right->toQString() + r->toQString()));
+            return engine->memoryManager->alloc<ComplexString>(cs->left, leaf->d())->asReturnedValue();
+        }
+    }
+
+    // Keep the left spine of ropes built by repeated appending shallow: collapse the pieces
+    // appended since the last long prefix into a single leaf. The tail is never longer than
+    // the prefix it is split from, so every character is only copied a logarithmic number
+    // of times.
+    if (Heap::ComplexString::ropeDepth(l) >= Heap::ComplexString::MaxRopeDepth) {
+        QVarLengthArray<Heap::String *, Heap::ComplexString::MaxRopeDepth> pieces;
+        Heap::String *prefix = l;
+        int tailLength = r->length();
+        while (prefix->subtype == Heap::String::StringType_AddedString) {
+            Heap::ComplexString *cs = static_cast<Heap::ComplexString *>(prefix);
+            if (tailLength + cs->right->length() > cs->left->length())
+                break;
+            tailLength += cs->right->length();
+            pieces.append(cs->right);
+            prefix = cs->left;
+        }
+
+        if (!pieces.isEmpty()) {
+            QString tail;
+            tail.reserve(tailLength);
+            for (int i = pieces.size() - 1; i >= 0; --i)
+                tail += pieces.at(i)->toQString();
+            tail += r->toQString();
+            ScopedString leaf(scope, engine->newString(tail));
+            return engine->memoryManager->alloc<ComplexString>(prefix, leaf->d())->asReturnedValue();
+        }
+    }
+
+    // Likewise for the right spine of ropes built by repeated prepending.
+    if (Heap::ComplexString::ropeDepth(r) >= Heap::ComplexString::MaxRopeDepth) {
+        QVarLengthArray<Heap::String *, Heap::ComplexString::MaxRopeDepth> pieces;
+        Heap::String *suffix = r;
+        int headLength = l->length();
+        while (suffix->subtype == Heap::String::StringType_AddedString) {
+            Heap::ComplexString *cs = static_cast<Heap::ComplexString *>(suffix);
+            if (headLength + cs->left->length() > cs->right->length())
+                break;
+            headLength += cs->left->length();
+            pieces.append(cs->left);
+            suffix = cs->right;
+        }
+
+        if (!pieces.isEmpty()) {
+            QString head;
+            head.reserve(headLength);
+            head += l->toQString();
+            for (Heap::String *piece : qAsConst(pieces))
+                head += piece->toQString();
+            ScopedString leaf(scope, engine->newString(head));
+            return engine->memoryManager->alloc<ComplexString>(leaf->d(), suffix)->asReturnedValue();
+        }
+    }
+
+    return engine->memoryManager->alloc<ComplexString>(l, r)->asReturnedValue();
+}
+
 void Heap::StringOrSymbol::createHashValue() const
 {
     if (!text) {
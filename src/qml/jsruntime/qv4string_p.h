@@ -125,6 +125,9 @@ struct Q_QML_PRIVATE_EXPORT String : StringOrSymbol {
     inline bool isEqualTo(const String *other) const {
         if (this == other)
             return true;
+        // ropes know their length, so this can fail without flattening either side
+        if (length() != other->length())
+            return false;
         if (hashValue() != other->hashValue())
             return false;
         Q_ASSERT(subtype < StringType_Complex);
@@ -144,6 +147,16 @@ private:
 Q_STATIC_ASSERT(std::is_trivial< String >::value);
 
 struct ComplexString : String {
+    enum {
+        // Concatenations up to this length are copied into a flat string right away,
+        // and short pieces appended to a rope are merged into its rightmost leaf.
+        ShortStringLength = 64,
+        // Concatenating to a rope deeper than this collapses the short pieces along its left spine
+        // (when appending) or right spine (when prepending) into a single leaf. Ropes of other
+        // shapes can still grow deeper, flattening them doesn't recurse.
+        MaxRopeDepth = 256
+    };
+
     void init(String *l, String *n);
     void init(String *ref, int from, int len);
     mutable String *left;
@@ -153,6 +166,11 @@ struct ComplexString : String {
         int from;
     };
     int len;
+    int depth;
+
+    static int ropeDepth(const String *s) {
+        return s->subtype == StringType_AddedString ? static_cast<const ComplexString *>(s)->depth : 0;
+    }
 };
 Q_STATIC_ASSERT(std::is_trivial< ComplexString >::value);
 
@@ -230,6 +248,9 @@ struct Q_QML_PRIVATE_EXPORT String : public StringOrSymbol {
 
     bool startsWithUpper() const { return d()->startsWithUpper(); }
 
+    // Concatenates two non-empty strings, as a rope if the result is long enough.
+    static ReturnedValue concat(ExecutionEngine *engine, const String *left, const String *right);
+
 protected:
     static bool virtualIsEqualTo(Managed *that, Managed *o);
     static qint64 virtualGetLength(const Managed *m);
@@ -417,6 +417,42 @@ static bool compareEqualInt(QV4::Value &accumulator, QV4::Value lhs, int rhs)
         } \
     } while (false)
 
+#if QT_CONFIG(qml_jit)
+// Returns the entry point to continue the current frame in JIT code, if a loop has been running
+// long enough. We can only switch when the frame has no active exception handler, as the
+// interpreter stores bytecode addresses in the unwind fields, while the JIT stores machine code.
+static Function::JittedCode osrEntryOnBackEdge(CppStackFrame *frame, ExecutionEngine *engine)
+{
+    if (!engine->osrEnabled())
+        return nullptr;
+
+    Function *function = frame->v4Function;
+    if (++function->interpreterBackEdgeCount < engine->osrBackEdgeThreshold())
+        return nullptr;
+    function->interpreterBackEdgeCount = 0;
+
+    if (frame->unwindHandler || frame->unwindLabel || engine->debugger()
+            || function->isGenerator() || !engine->canJIT()) {
+        return nullptr;
+    }
+
+    if (function->jittedCode == nullptr)
+        QV4::JIT::BaselineJIT(function).generate();
+    return function->osrEntry;
+}
+
+#define CHECK_BACK_EDGE(offset) \
+    if (offset < 0) { \
+        if (Function::JittedCode osrEntry = osrEntryOnBackEdge(frame, engine)) { \
+            STORE_IP(); \
+            STORE_ACC(); \
+            return osrEntry(frame, engine); \
+        } \
+    }
+#else
+#define CHECK_BACK_EDGE(offset)
+#endif // QT_CONFIG(qml_jit)
+
 ReturnedValue VME::exec(CppStackFrame *frame, ExecutionEngine *engine)
 {
     qt_v4ResolvePendingBreakpointsHook();
@@ -437,6 +473,11 @@ ReturnedValue VME::exec(CppStackFrame *frame, ExecutionEngine *engine)
                 QV4::JIT::BaselineJIT(function).generate();
             else
                 ++function->interpreterCallCount;
+        } else if (!function->hasOptimizedCode) {
+            if (engine->canOptimize(function))
+                QV4::JIT::BaselineJIT(function, /*useTypeFeedback*/ true).generate();
+            else
+                ++function->baselineCallCount;
         }
     }
 #endif // QT_CONFIG(qml_jit)
@@ -986,6 +1027,7 @@ QV4::ReturnedValue VME::interpret(CppStackFrame *frame, ExecutionEngine *engine,
 
     MOTH_BEGIN_INSTR(Jump)
         code += offset;
+        CHECK_BACK_EDGE(offset);
     MOTH_END_INSTR(Jump)
 
     MOTH_BEGIN_INSTR(JumpTrue)
@@ -994,8 +1036,10 @@ QV4::ReturnedValue VME::interpret(CppStackFrame *frame, ExecutionEngine *engine,
             takeJump = ACC.int_32();
         else
             takeJump = ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            CHECK_BACK_EDGE(offset);
+        }
     MOTH_END_INSTR(JumpTrue)
 
     MOTH_BEGIN_INSTR(JumpFalse)
@@ -1004,8 +1048,10 @@ QV4::ReturnedValue VME::interpret(CppStackFrame *frame, ExecutionEngine *engine,
             takeJump = !ACC.int_32();
         else
             takeJump = !ACC.toBoolean();
-        if (takeJump)
+        if (takeJump) {
             code += offset;
+            CHECK_BACK_EDGE(offset);
+        }
     MOTH_END_INSTR(JumpFalse)
 
     MOTH_BEGIN_INSTR(JumpNoException)
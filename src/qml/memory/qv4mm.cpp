@@ -54,8 +54,14 @@
 #include "StdLibExtras.h"
 
 #include <QElapsedTimer>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMap>
 #include <QScopedValueRollback>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 
 #include <iostream>
 #include <cstdlib>
@@ -64,6 +70,8 @@
 #include "qv4mapobject_p.h"
 #include "qv4setobject_p.h"
 #include "qv4writebarrier_p.h"
+#include "qv4stackframe_p.h"
+#include "qv4functionobject_p.h"
 
 //#define MM_STATS
 
@@ -107,7 +115,10 @@ namespace QV4 {
 
 enum {
     MinSlotsGCLimit = QV4::Chunk::AvailableSlots*16,
-    GCOverallocation = 200 /* Max overallocation by the GC in % */
+    GCOverallocation = 200, /* Max overallocation by the GC in % */
+    DefaultNurserySize = 4*1024*1024, /* Bytes allocated between two minor collections */
+    MaxMinorGCs = 32, /* Minor collections before a full collection is forced */
+    DefaultIncrementalGCSliceTime = 1000 /* Time in us spent marking per incremental slice */
 };
 
 struct MemorySegment {
@@ -370,6 +381,41 @@ bool Chunk::sweep(ExecutionEngine *engine)
     return hasUsedSlots;
 }
 
+bool Chunk::sweepConcurrently(bool keepBlackBits, size_t *freedSlots)
+{
+    bool hasUsedSlots = false;
+    bool lastSlotFree = false;
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
+        Q_ASSERT((toFree & objectBitmap[i]) == toFree); // check all black objects are marked as being used
+        quintptr e = extendsBitmap[i];
+        if (lastSlotFree)
+            e &= (e + 1); // clear all lowest extent bits
+        while (toFree) {
+            uint index = qCountTrailingZeroBits(toFree);
+            quintptr bit = (static_cast<quintptr>(1) << index);
+
+            toFree ^= bit; // mask out freed slot
+
+            // remove all extends slots that have been freed, see sweep()
+            quintptr mask = (bit << 1) - 1;
+            quintptr result = (e | mask) + 1;
+            Q_ASSERT(qCountTrailingZeroBits(result) - index != 0); // ensure we freed something
+            result |= mask;
+            e &= result;
+        }
+        *freedSlots += qPopulationCount((objectBitmap[i] | extendsBitmap[i]) - (blackBitmap[i] | e));
+        objectBitmap[i] = blackBitmap[i];
+        if (!keepBlackBits)
+            blackBitmap[i] = 0;
+        hasUsedSlots |= (objectBitmap[i] != 0);
+        extendsBitmap[i] = e;
+        lastSlotFree = !((objectBitmap[i]|extendsBitmap[i]) >> (sizeof(quintptr)*8 - 1));
+        Q_ASSERT((objectBitmap[i] & extendsBitmap[i]) == 0);
+    }
+    return hasUsedSlots;
+}
+
 void Chunk::freeAll(ExecutionEngine *engine)
 {
     //    DEBUG << "sweeping chunk" << this << (*freeList);
@@ -642,6 +688,108 @@ void BlockAllocator::sweep()
     chunks.erase(firstEmptyChunk, chunks.end());
 }
 
+struct BlockAllocator::ConcurrentSweep : public QRunnable
+{
+    ConcurrentSweep(std::vector<Chunk *> &&chunks, bool keepBlackBits)
+        : chunks(std::move(chunks)), keepBlackBits(keepBlackBits)
+    {
+        setAutoDelete(false);
+        memset(freeBins, 0, sizeof(freeBins));
+        memset(lastInBin, 0, sizeof(lastInBin));
+    }
+
+    void run() override
+    {
+        firstEmptyChunk = std::partition(chunks.begin(), chunks.end(), [this](Chunk *c) {
+            return c->sweepConcurrently(keepBlackBits, &freedSlots);
+        });
+
+        std::for_each(chunks.begin(), firstEmptyChunk, [this](Chunk *c) {
+            c->sortIntoBins(freeBins, NumBins);
+            usedSlots += c->nUsedSlots();
+        });
+
+        // remember the ends of the free lists, so that they can be merged cheaply
+        for (uint i = 0; i < NumBins; ++i) {
+            for (HeapItem *h = freeBins[i]; h; h = h->freeData.next)
+                lastInBin[i] = h;
+        }
+
+        done.release();
+    }
+
+    std::vector<Chunk *> chunks;
+    std::vector<Chunk *>::iterator firstEmptyChunk;
+    HeapItem *freeBins[NumBins];
+    HeapItem *lastInBin[NumBins];
+    size_t usedSlots = 0;
+    size_t freedSlots = 0;
+    bool keepBlackBits;
+    QSemaphore done;
+};
+
+BlockAllocator::~BlockAllocator()
+{
+    Q_ASSERT(!concurrentSweep);
+}
+
+void BlockAllocator::startConcurrentSweep(bool keepBlackBits)
+{
+    Q_ASSERT(!concurrentSweep);
+
+    nextFree = nullptr;
+    nFree = 0;
+    memset(freeBins, 0, sizeof(freeBins));
+    usedSlotsAfterLastSweep = 0;
+    if (chunks.empty())
+        return;
+
+    // The mutator may set gray bits from now on. Clear the old ones here, so that the worker
+    // doesn't have to touch them.
+    for (Chunk *c : chunks)
+        memset(c->grayBitmap, 0, sizeof(c->grayBitmap));
+
+    // Allocations continue in new chunks until the swept ones get picked up again
+    concurrentSweep.reset(new ConcurrentSweep(std::move(chunks), keepBlackBits));
+    chunks.clear();
+    QThreadPool::globalInstance()->start(concurrentSweep.get());
+}
+
+bool BlockAllocator::finishConcurrentSweep(bool wait)
+{
+    if (!concurrentSweep)
+        return true;
+
+    ConcurrentSweep *sweep = concurrentSweep.get();
+    if (wait) {
+        // don't wait for a busy thread pool to pick it up
+        if (QThreadPool::globalInstance()->tryTake(sweep))
+            sweep->run();
+        sweep->done.acquire();
+    } else if (!sweep->done.tryAcquire()) {
+        return false;
+    }
+
+    Q_V4_PROFILE_DEALLOC(engine, sweep->freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+
+    for (uint i = 0; i < NumBins; ++i) {
+        if (!sweep->freeBins[i])
+            continue;
+        sweep->lastInBin[i]->freeData.next = freeBins[i];
+        freeBins[i] = sweep->freeBins[i];
+    }
+    usedSlotsAfterLastSweep += sweep->usedSlots;
+
+    chunks.insert(chunks.end(), sweep->chunks.begin(), sweep->firstEmptyChunk);
+    std::for_each(sweep->firstEmptyChunk, sweep->chunks.end(), [this](Chunk *c) {
+        Q_V4_PROFILE_DEALLOC(engine, Chunk::DataSize, Profiling::HeapPage);
+        chunkAllocator->free(c);
+    });
+
+    concurrentSweep.reset();
+    return true;
+}
+
 void BlockAllocator::freeAll()
 {
     for (auto c : chunks)
@@ -660,9 +808,11 @@ void BlockAllocator::resetBlackBits()
 
 void BlockAllocator::collectGrayItems(MarkStack *markStack)
 {
-    for (auto c : chunks)
+    for (auto c : chunks) {
         c->collectGrayItems(markStack);
-
+        if (markStack->top >= markStack->limit)
+            markStack->drain();
+    }
 }
 
 HeapItem *HugeItemAllocator::allocate(size_t size) {
@@ -712,11 +862,13 @@ static void freeHugeChunk(ChunkAllocator *chunkAllocator, const HugeItemAllocato
 #endif
 }
 
-void HugeItemAllocator::sweep(ClassDestroyStatsCallback classCountPtr)
+void HugeItemAllocator::sweep(ClassDestroyStatsCallback classCountPtr, bool keepBlackBits)
 {
-    auto isBlack = [this, classCountPtr] (const HugeChunk &c) {
+    auto isBlack = [this, classCountPtr, keepBlackBits] (const HugeChunk &c) {
         bool b = c.chunk->first()->isBlack();
-        Chunk::clearBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase());
+        Chunk::clearBit(c.chunk->grayBitmap, c.chunk->first() - c.chunk->realBase());
+        if (!keepBlackBits)
+            Chunk::clearBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase());
         if (!b) {
             Q_V4_PROFILE_DEALLOC(engine, c.size, Profiling::LargeItem);
             freeHugeChunk(chunkAllocator, c, classCountPtr);
@@ -736,14 +888,20 @@ void HugeItemAllocator::resetBlackBits()
 
 void HugeItemAllocator::collectGrayItems(MarkStack *markStack)
 {
-    for (auto c : chunks)
+    for (auto c : chunks) {
+        const size_t index = c.chunk->first() - c.chunk->realBase();
         // Correct for a Steele type barrier
-        if (Chunk::testBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase()) &&
-            Chunk::testBit(c.chunk->grayBitmap, c.chunk->first() - c.chunk->realBase())) {
+        if (Chunk::testBit(c.chunk->blackBitmap, index) &&
+            Chunk::testBit(c.chunk->grayBitmap, index)) {
             HeapItem *i = c.chunk->first();
             Heap::Base *b = *i;
-            b->mark(markStack);
+            // the item is already black, so Base::mark() would not rescan it
+            markStack->push(b);
+            if (markStack->top >= markStack->limit)
+                markStack->drain();
         }
+        Chunk::clearBit(c.chunk->grayBitmap, index);
+    }
 }
 
 void HugeItemAllocator::freeAll()
@@ -760,6 +918,7 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , chunkAllocator(new ChunkAllocator)
     , blockAllocator(chunkAllocator, engine)
     , icAllocator(chunkAllocator, engine)
+    , plainAllocator(chunkAllocator, engine)
     , hugeItemAllocator(chunkAllocator, engine)
     , m_persistentValues(new PersistentValueStorage(engine))
     , m_weakValues(new PersistentValueStorage(engine))
@@ -767,13 +926,35 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , aggressiveGC(!qEnvironmentVariableIsEmpty("QV4_MM_AGGRESSIVE_GC"))
     , gcStats(lcGcStats().isDebugEnabled())
     , gcCollectorStats(lcGcAllocatorStats().isDebugEnabled())
+    , generationalGC(!qEnvironmentVariableIsEmpty(QV4_MM_GENERATIONAL_GC))
+    , incrementalGC(!qEnvironmentVariableIsEmpty(QV4_MM_INCREMENTAL_GC))
+    // the allocator statistics expect to see all chunks right after the sweep
+    , concurrentSweep(!qEnvironmentVariableIsEmpty(QV4_MM_CONCURRENT_SWEEP) && !gcCollectorStats)
 {
 #ifdef V4_USE_VALGRIND
     VALGRIND_CREATE_MEMPOOL(this, 0, true);
 #endif
     memset(statistics.allocations, 0, sizeof(statistics.allocations));
-    if (gcStats)
+    if (gcStats) {
         blockAllocator.allocationStats = statistics.allocations;
+        plainAllocator.allocationStats = statistics.allocations;
+    }
+
+    if (generationalGC) {
+        bool ok = false;
+        int nurserySize = qEnvironmentVariableIntValue(QV4_MM_NURSERY_SIZE, &ok);
+        if (!ok || nurserySize <= 0)
+            nurserySize = DefaultNurserySize;
+        nurserySlots = align(std::size_t(nurserySize)) >> Chunk::SlotSizeShift;
+        engine->writeBarrierActive = true;
+    }
+
+    if (incrementalGC) {
+        bool ok = false;
+        incrementalGCSliceTime = qEnvironmentVariableIntValue(QV4_MM_INCREMENTAL_GC_SLICE, &ok);
+        if (!ok || incrementalGCSliceTime <= 0)
+            incrementalGCSliceTime = DefaultIncrementalGCSliceTime;
+    }
 }
 
 Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
@@ -790,7 +971,7 @@ Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
     return *m;
 }
 
-Heap::Base *MemoryManager::allocData(std::size_t size)
+Heap::Base *MemoryManager::allocData(std::size_t size, const VTable *vtable)
 {
 #ifdef MM_STATS
     lastAllocRequestedSlots = size >> Chunk::SlotSizeShift;
@@ -800,7 +981,10 @@ Heap::Base *MemoryManager::allocData(std::size_t size)
     Q_ASSERT(size >= Chunk::SlotSize);
     Q_ASSERT(size % Chunk::SlotSize == 0);
 
-    HeapItem *m = allocate(&blockAllocator, size);
+    // Keep objects that need to be destroyed apart from the others, so that the chunks of the
+    // latter can be swept without calling back into the objects.
+    BlockAllocator *allocator = (concurrentSweep && !vtable->destroy) ? &plainAllocator : &blockAllocator;
+    HeapItem *m = allocate(allocator, size);
     memset(m, 0, size);
     return *m;
 }
@@ -812,7 +996,7 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
 
     Heap::Object *o;
     if (nMembers <= vtable->nInlineProperties) {
-        o = static_cast<Heap::Object *>(allocData(size));
+        o = static_cast<Heap::Object *>(allocData(size, vtable));
     } else {
         // Allocate both in one go through the block allocator
         nMembers -= vtable->nInlineProperties;
@@ -820,10 +1004,10 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
         size_t totalSize = size + memberSize;
         Heap::MemberData *m;
         if (totalSize > Chunk::DataSize) {
-            o = static_cast<Heap::Object *>(allocData(size));
+            o = static_cast<Heap::Object *>(allocData(size, vtable));
             m = hugeItemAllocator.allocate(memberSize)->as<Heap::MemberData>();
         } else {
-            HeapItem *mh = reinterpret_cast<HeapItem *>(allocData(totalSize));
+            HeapItem *mh = reinterpret_cast<HeapItem *>(allocData(totalSize, vtable));
             Heap::Base *b = *mh;
             o = static_cast<Heap::Object *>(b);
             mh += (size >> Chunk::SlotSizeShift);
@@ -857,6 +1041,11 @@ MarkStack::MarkStack(ExecutionEngine *engine)
 
 void MarkStack::drain()
 {
+    if (Q_UNLIKELY(retainers)) {
+        drainRecordingRetainers();
+        return;
+    }
+
     while (top > base) {
         Heap::Base *h = pop();
         ++markStackSize;
@@ -865,6 +1054,53 @@ void MarkStack::drain()
     }
 }
 
+void MarkStack::recordRetainers()
+{
+    if (!pushedFrom)
+        pushedFrom = base;
+    if (current) {
+        for (Heap::Base **it = pushedFrom; it < top; ++it)
+            retainers->insert(*it, current);
+    }
+    pushedFrom = top;
+}
+
+void MarkStack::drainRecordingRetainers()
+{
+    // Everything between pushedFrom and top was pushed by the object being scanned when we
+    // were entered, or from the roots if there is none. markObjects() may call drain() again
+    // if the stack runs full, so the outer state has to be restored afterwards.
+    recordRetainers();
+    Heap::Base *outer = current;
+    while (top > base) {
+        Heap::Base *h = pop();
+        ++markStackSize;
+        Q_ASSERT(h);
+        current = h;
+        pushedFrom = top;
+        h->internalClass->vtable->markObjects(h, this);
+        recordRetainers();
+    }
+    current = outer;
+    pushedFrom = top;
+}
+
+bool MarkStack::drain(QDeadlineTimer deadline)
+{
+    enum { DeadlineCheckInterval = 256 };
+    do {
+        for (int i = 0; i < DeadlineCheckInterval; ++i) {
+            if (top == base)
+                return true;
+            Heap::Base *h = pop();
+            ++markStackSize;
+            Q_ASSERT(h);
+            h->internalClass->vtable->markObjects(h, this);
+        }
+    } while (!deadline.hasExpired());
+    return top == base;
+}
+
 void MemoryManager::collectRoots(MarkStack *markStack)
 {
     engine->markObjects(markStack);
@@ -910,13 +1146,26 @@ void MemoryManager::collectRoots(MarkStack *markStack)
     }
 }
 
-void MemoryManager::mark()
+void MemoryManager::collectGrayItems(MarkStack *markStack)
+{
+    blockAllocator.collectGrayItems(markStack);
+    icAllocator.collectGrayItems(markStack);
+    plainAllocator.collectGrayItems(markStack);
+    hugeItemAllocator.collectGrayItems(markStack);
+}
+
+void MemoryManager::mark(GCType type)
 {
     markStackSize = 0;
 
     MarkStack markStack(engine);
     collectRoots(&markStack);
 
+    // Old objects are black already and won't be traced from the roots again. The ones that
+    // were modified since the last collection might point to young objects, though.
+    if (type == MinorGC)
+        collectGrayItems(&markStack);
+
     markStack.drain();
 }
 
@@ -992,19 +1241,57 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
     if (!lastSweep) {
         engine->identifierTable->sweep();
         blockAllocator.sweep(/*classCountPtr*/);
-        hugeItemAllocator.sweep(classCountPtr);
+        hugeItemAllocator.sweep(classCountPtr, /*keepBlackBits*/ generationalGC);
         icAllocator.sweep(/*classCountPtr*/);
+        if (concurrentSweep)
+            plainAllocator.startConcurrentSweep(/*keepBlackBits*/ generationalGC);
     }
 }
 
 bool MemoryManager::shouldRunGC() const
 {
-    size_t total = blockAllocator.totalSlots() + icAllocator.totalSlots();
+    size_t total = blockAllocator.totalSlots() + icAllocator.totalSlots() + plainAllocator.totalSlots();
     if (total > MinSlotsGCLimit && usedSlotsAfterLastFullSweep * GCOverallocation < total * 100)
         return true;
     return false;
 }
 
+MemoryManager::GCType MemoryManager::nextGCType() const
+{
+    if (!generationalGC || minorGCsSinceLastFullGC >= MaxMinorGCs)
+        return FullGC;
+
+    // Everything surviving a minor collection gets promoted. Once the old generation has grown
+    // too much compared to the last full collection, we need to get rid of its garbage, too.
+    if (usedSlotsAfterLastFullSweep > MinSlotsGCLimit
+            && usedSlotsAfterLastFullSweep * 100 > usedSlotsAfterLastFullGC * GCOverallocation) {
+        return FullGC;
+    }
+    return MinorGC;
+}
+
+void MemoryManager::resetBlackBits()
+{
+    blockAllocator.resetBlackBits();
+    hugeItemAllocator.resetBlackBits();
+    icAllocator.resetBlackBits();
+    plainAllocator.resetBlackBits();
+}
+
+bool MemoryManager::finishConcurrentSweep(bool wait)
+{
+    const size_t usedSlots = plainAllocator.usedSlotsAfterLastSweep;
+    if (!plainAllocator.finishConcurrentSweep(wait))
+        return false;
+
+    // the slots surviving in the chunks swept by the worker weren't known yet in finishCollection()
+    const size_t survivors = plainAllocator.usedSlotsAfterLastSweep - usedSlots;
+    usedSlotsAfterLastFullSweep += survivors;
+    if (generationalGC && !minorGCsSinceLastFullGC)
+        usedSlotsAfterLastFullGC += survivors;
+    return true;
+}
+
 static size_t dumpBins(BlockAllocator *b, const char *title)
 {
     const QLoggingCategory &stats = lcGcAllocatorStats();
@@ -1034,7 +1321,7 @@ static size_t dumpBins(BlockAllocator *b, const char *title)
     return totalSlotMem*Chunk::SlotSize;
 }
 
-void MemoryManager::runGC()
+void MemoryManager::runGC(GCType type)
 {
     if (gcBlocked) {
 //        qDebug() << "Not running GC.";
@@ -1044,13 +1331,26 @@ void MemoryManager::runGC()
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
 
+    finishConcurrentSweep(/*wait*/true);
+
+    if (incrementalMarkStack) {
+        // complete the collection in progress instead of starting over
+        finishIncrementalGC();
+        return;
+    }
+
+    if (!generationalGC)
+        type = FullGC;
+    else if (type == FullGC)
+        resetBlackBits(); // forget about the old generation
+
     if (gcStats) {
         statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
         statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
     }
 
     if (!gcCollectorStats) {
-        mark();
+        mark(type);
         sweep();
     } else {
         bool triggeredByUnmanagedHeap = (unmanagedHeapSize > unmanagedHeapSizeGCLimit);
@@ -1062,6 +1362,8 @@ void MemoryManager::runGC()
 
         const QLoggingCategory &stats = lcGcAllocatorStats();
         qDebug(stats) << "========== GC ==========";
+        if (generationalGC)
+            qDebug(stats) << "    Collecting" << (type == MinorGC ? "young generation" : "full heap");
 #ifdef MM_STATS
         qDebug(stats) << "    Triggered by alloc request of" << lastAllocRequestedSlots << "slots.";
         qDebug(stats) << "    Allocations since last GC" << allocationCount;
@@ -1075,7 +1377,7 @@ void MemoryManager::runGC()
 
         QElapsedTimer t;
         t.start();
-        mark();
+        mark(type);
         qint64 markTime = t.nsecsElapsed()/1000;
         t.restart();
         sweep(false, increaseFreedCountForClass);
@@ -1129,6 +1431,11 @@ void MemoryManager::runGC()
         qDebug(stats) << "======== End GC ========";
     }
 
+    finishCollection(type);
+}
+
+void MemoryManager::finishCollection(GCType type)
+{
     if (gcStats)
         statistics.maxUsedMem = qMax(statistics.maxUsedMem, getUsedMem() + getLargeItemsMem());
 
@@ -1140,22 +1447,119 @@ void MemoryManager::runGC()
                  == icAllocator.usedMem() + dumpBins(&icAllocator, nullptr));
     }
 
-    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep
+            + plainAllocator.usedSlotsAfterLastSweep;
 
-    // reset all black bits
-    blockAllocator.resetBlackBits();
-    hugeItemAllocator.resetBlackBits();
-    icAllocator.resetBlackBits();
+    slotsAllocatedSinceLastGC = 0;
+    if (generationalGC) {
+        // keep the black bits, survivors form the old generation now
+        if (type == FullGC) {
+            usedSlotsAfterLastFullGC = usedSlotsAfterLastFullSweep;
+            minorGCsSinceLastFullGC = 0;
+        } else {
+            ++minorGCsSinceLastFullGC;
+        }
+    } else {
+        // reset all black bits
+        resetBlackBits();
+    }
+}
+
+bool MemoryManager::shouldStartIncrementalGC() const
+{
+    // Start marking well before an allocation would trigger a non-incremental collection
+    if (unmanagedHeapSize * 2 > unmanagedHeapSizeGCLimit)
+        return true;
+    const size_t liveSlots = qMax(usedSlotsAfterLastFullSweep, size_t(MinSlotsGCLimit));
+    return slotsAllocatedSinceLastGC * 2 > liveSlots;
+}
+
+void MemoryManager::startIncrementalGC()
+{
+    if (!incrementalGC || incrementalMarkStack || gcBlocked)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+
+    finishConcurrentSweep(/*wait*/true);
+
+    // incremental collections are always full ones
+    if (generationalGC)
+        resetBlackBits();
+
+    engine->writeBarrierActive = true;
+    markStackSize = 0;
+    incrementalMarkStack.reset(new MarkStack(engine));
+    collectRoots(incrementalMarkStack.get());
+}
+
+bool MemoryManager::runIncrementalGCSlice(qint64 budgetInUs)
+{
+    if (!incrementalGC || gcBlocked)
+        return false;
+
+    if (!incrementalMarkStack) {
+        if (!shouldStartIncrementalGC())
+            return false;
+        startIncrementalGC();
+    }
+
+    if (budgetInUs < 0)
+        budgetInUs = incrementalGCSliceTime;
+    QDeadlineTimer deadline;
+    deadline.setPreciseRemainingTime(0, budgetInUs * 1000, Qt::PreciseTimer);
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    if (!incrementalMarkStack->drain(deadline) || deadline.hasExpired())
+        return true;
+
+    // Marking is done, finish in this slice as there is some time left
+    finishIncrementalGC();
+    return false;
+}
+
+void MemoryManager::finishIncrementalGC()
+{
+    Q_ASSERT(gcBlocked);
+    Q_ASSERT(incrementalMarkStack);
+
+    QElapsedTimer t;
+    if (gcCollectorStats)
+        t.start();
+
+    // The mutator ran since marking started. Pick up what was stored to the roots or to
+    // already marked objects in the meantime.
+    MarkStack *markStack = incrementalMarkStack.get();
+    collectRoots(markStack);
+    collectGrayItems(markStack);
+    markStack->drain();
+    incrementalMarkStack.reset();
+    engine->writeBarrierActive = generationalGC;
+
+    if (gcCollectorStats) {
+        const QLoggingCategory &stats = lcGcAllocatorStats();
+        qDebug(stats) << "Finished incremental GC, remark took" << t.nsecsElapsed()/1000 << "us.";
+        qDebug(stats) << "   " << markStackSize << "objects marked";
+        t.restart();
+        sweep(false, increaseFreedCountForClass);
+        qDebug(stats) << "Sweeped object in" << t.nsecsElapsed()/1000 << "us.";
+    } else {
+        sweep();
+    }
+
+    finishCollection(FullGC);
 }
 
 size_t MemoryManager::getUsedMem() const
 {
-    return blockAllocator.usedMem() + icAllocator.usedMem();
+    // chunks that are still being swept concurrently are not included
+    return blockAllocator.usedMem() + icAllocator.usedMem() + plainAllocator.usedMem();
 }
 
 size_t MemoryManager::getAllocatedMem() const
 {
-    return blockAllocator.allocatedMem() + icAllocator.allocatedMem() + hugeItemAllocator.usedMem();
+    return blockAllocator.allocatedMem() + icAllocator.allocatedMem() + plainAllocator.allocatedMem()
+            + hugeItemAllocator.usedMem();
 }
 
 size_t MemoryManager::getLargeItemsMem() const
@@ -1179,12 +1583,18 @@ MemoryManager::~MemoryManager()
 {
     delete m_persistentValues;
 
+    finishConcurrentSweep(/*wait*/true);
     dumpStats();
 
+    // In generational mode the black bits denote old objects, and an incremental collection
+    // might be in progress. Everything has to go now.
+    incrementalMarkStack.reset();
+    resetBlackBits();
     sweep(/*lastSweep*/true);
     blockAllocator.freeAll();
     hugeItemAllocator.freeAll();
     icAllocator.freeAll();
+    plainAllocator.freeAll();
 
     delete m_weakValues;
 #ifdef V4_USE_VALGRIND
@@ -1210,6 +1620,138 @@ void MemoryManager::dumpStats() const
     qDebug(stats) << "     >=" << ((BlockAllocator::NumBins - 1) << Chunk::SlotSizeShift) << " bytes: " << statistics.allocations[BlockAllocator::NumBins - 1];
 }
 
+namespace {
+struct HeapSnapshotWriter
+{
+    HeapSnapshotWriter(QIODevice *device, const QHash<Heap::Base *, Heap::Base *> &retainers)
+        : device(device), retainers(retainers)
+    {}
+
+    QIODevice *device;
+    const QHash<Heap::Base *, Heap::Base *> &retainers;
+    qint64 objects = 0;
+    qint64 bytes = 0;
+
+    static QString id(const void *p)
+    {
+        return p ? QStringLiteral("0x") + QString::number(quintptr(p), 16) : QString();
+    }
+
+    void writeLine(const QJsonObject &record)
+    {
+        device->write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+        device->write("\n", 1);
+    }
+
+    void writeObject(Heap::Base *b, size_t size)
+    {
+        const VTable *vtable = b->internalClass->vtable;
+        QJsonObject record;
+        record.insert(QStringLiteral("id"), id(b));
+        record.insert(QStringLiteral("type"), QString::fromLatin1(vtable->className));
+        record.insert(QStringLiteral("size"), qint64(size));
+        record.insert(QStringLiteral("class"), id(b->internalClass.get()));
+        Heap::Base *retainer = retainers.value(b);
+        record.insert(QStringLiteral("retainer"), retainer ? QJsonValue(id(retainer))
+                                                           : QJsonValue(QJsonValue::Null));
+
+        if (vtable->isString) {
+            // Don't flatten complex strings, that would allocate while we walk the heap.
+            const Heap::String *s = static_cast<const Heap::String *>(b);
+            if (s->subtype < Heap::String::StringType_Complex)
+                record.insert(QStringLiteral("value"), s->toQString().left(64));
+        } else if (vtable->isFunctionObject) {
+            const Heap::FunctionObject *f = static_cast<const Heap::FunctionObject *>(b);
+            if (const Function *function = f->function) {
+                record.insert(QStringLiteral("function"), function->name()->toQString());
+                record.insert(QStringLiteral("file"), function->sourceFile());
+                record.insert(QStringLiteral("line"),
+                              int(function->compiledFunction->location.line));
+            }
+        }
+
+        writeLine(record);
+        ++objects;
+        bytes += size;
+    }
+
+    void writeChunk(Chunk *c)
+    {
+        for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+            quintptr live = c->objectBitmap[i] & c->blackBitmap[i];
+            while (live) {
+                const uint bit = qCountTrailingZeroBits(live);
+                live &= live - 1;
+                const size_t index = i * Chunk::Bits + bit;
+                size_t end = index + 1;
+                while (end < Chunk::NumSlots && Chunk::testBit(c->extendsBitmap, end))
+                    ++end;
+                writeObject(*(c->realBase() + index), (end - index) * Chunk::SlotSize);
+            }
+        }
+    }
+
+    void writeChunks(const BlockAllocator &allocator)
+    {
+        for (Chunk *c : allocator.chunks)
+            writeChunk(c);
+    }
+};
+}
+
+qint64 MemoryManager::writeHeapSnapshot(QIODevice *device)
+{
+    if (gcBlocked)
+        return -1;
+
+    runGC(FullGC);
+    finishConcurrentSweep(/*wait*/true);
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+
+    // Everything that survived the collection is reachable. Mark it once more, this time
+    // remembering who pushed what.
+    QHash<Heap::Base *, Heap::Base *> retainers;
+    resetBlackBits();
+    {
+        MarkStack markStack(engine);
+        markStack.retainers = &retainers;
+        collectRoots(&markStack);
+        markStack.drain();
+    }
+
+    HeapSnapshotWriter writer(device, retainers);
+    QJsonObject header;
+    header.insert(QStringLiteral("snapshot"), 1);
+    header.insert(QStringLiteral("slotSize"), int(Chunk::SlotSize));
+    header.insert(QStringLiteral("usedMem"), qint64(getUsedMem()));
+    header.insert(QStringLiteral("largeItemsMem"), qint64(getLargeItemsMem()));
+    header.insert(QStringLiteral("unmanagedHeapSize"), qint64(unmanagedHeapSize));
+    writer.writeLine(header);
+
+    writer.writeChunks(icAllocator);
+    writer.writeChunks(blockAllocator);
+    writer.writeChunks(plainAllocator);
+    for (const HugeItemAllocator::HugeChunk &c : hugeItemAllocator.chunks) {
+        HeapItem *item = c.chunk->first();
+        if (item->isBlack())
+            writer.writeObject(*item, c.size);
+    }
+
+    QJsonObject trailer;
+    trailer.insert(QStringLiteral("end"), true);
+    trailer.insert(QStringLiteral("objects"), writer.objects);
+    trailer.insert(QStringLiteral("bytes"), writer.bytes);
+    writer.writeLine(trailer);
+
+    // In generational mode the black bits now describe the old generation again, exactly as
+    // after the full collection above.
+    if (!generationalGC)
+        resetBlackBits();
+
+    return writer.objects;
+}
+
 void MemoryManager::collectFromJSStack(MarkStack *markStack) const
 {
     Value *v = engine->jsStackBase;
@@ -1223,6 +1765,22 @@ void MemoryManager::collectFromJSStack(MarkStack *markStack) const
         }
         ++v;
     }
+
+    if (!generationalGC && !isIncrementalGCRunning())
+        return;
+
+    // Running generators keep their JS frame inside the (possibly old or already marked)
+    // GeneratorObject, and the interpreter writes to it without a barrier.
+    for (CppStackFrame *f = engine->currentStackFrame; f; f = f->parent) {
+        Value *frame = reinterpret_cast<Value *>(f->jsFrame);
+        if (!frame || (frame >= engine->jsStackBase && frame < top) || !f->v4Function)
+            continue;
+        Value *end = frame + f->requiredJSStackFrameSize();
+        for (v = frame; v < end; ++v) {
+            if (Managed *m = v->managed())
+                m->mark(markStack);
+        }
+    }
 }
 
 } // namespace QV4
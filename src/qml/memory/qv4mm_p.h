@@ -57,15 +57,23 @@
 #include <private/qv4object_p.h>
 #include <private/qv4mmdefs_p.h>
 #include <QVector>
+#include <memory>
 
 #define QV4_MM_MAXBLOCK_SHIFT "QV4_MM_MAXBLOCK_SHIFT"
 #define QV4_MM_MAX_CHUNK_SIZE "QV4_MM_MAX_CHUNK_SIZE"
 #define QV4_MM_STATS "QV4_MM_STATS"
+#define QV4_MM_GENERATIONAL_GC "QV4_MM_GENERATIONAL_GC"
+#define QV4_MM_NURSERY_SIZE "QV4_MM_NURSERY_SIZE"
+#define QV4_MM_INCREMENTAL_GC "QV4_MM_INCREMENTAL_GC"
+#define QV4_MM_INCREMENTAL_GC_SLICE "QV4_MM_INCREMENTAL_GC_SLICE"
+#define QV4_MM_CONCURRENT_SWEEP "QV4_MM_CONCURRENT_SWEEP"
 
 #define MM_DEBUG 0
 
 QT_BEGIN_NAMESPACE
 
+class QIODevice;
+
 namespace QV4 {
 
 struct ChunkAllocator;
@@ -77,6 +85,7 @@ struct BlockAllocator {
     {
         memset(freeBins, 0, sizeof(freeBins));
     }
+    ~BlockAllocator();
 
     enum { NumBins = 8 };
 
@@ -105,6 +114,16 @@ struct BlockAllocator {
     void resetBlackBits();
     void collectGrayItems(MarkStack *markStack);
 
+    // Hands all chunks over to a worker thread for sweeping, allocations continue in new chunks.
+    // Only valid if none of the objects in this allocator needs a destroy() call. The freed
+    // slots are added to the bins in finishConcurrentSweep(), which returns false if the worker
+    // isn't done yet and wait is false.
+    void startConcurrentSweep(bool keepBlackBits);
+    bool finishConcurrentSweep(bool wait);
+
+    struct ConcurrentSweep;
+    std::unique_ptr<ConcurrentSweep> concurrentSweep;
+
     // bump allocations
     HeapItem *nextFree = nullptr;
     size_t nFree = 0;
@@ -122,7 +141,7 @@ struct HugeItemAllocator {
     {}
 
     HeapItem *allocate(size_t size);
-    void sweep(ClassDestroyStatsCallback classCountPtr);
+    void sweep(ClassDestroyStatsCallback classCountPtr, bool keepBlackBits = false);
     void freeAll();
     void resetBlackBits();
     void collectGrayItems(MarkStack *markStack);
@@ -164,7 +183,8 @@ public:
     {
         Q_STATIC_ASSERT(std::is_trivial< typename ManagedType::Data >::value);
         size = align(size);
-        typename ManagedType::Data *d = static_cast<typename ManagedType::Data *>(allocData(size));
+        typename ManagedType::Data *d = static_cast<typename ManagedType::Data *>(
+                    allocData(size, ManagedType::staticVTable()));
         d->internalClass.set(engine, ic);
         Q_ASSERT(d->internalClass && d->internalClass->vtable);
         Q_ASSERT(ic->vtable == ManagedType::staticVTable());
@@ -255,10 +275,32 @@ public:
         return t->d();
     }
 
-    void runGC();
+    enum GCType {
+        FullGC,
+        MinorGC
+    };
+
+    // Explicit requests (gc(), QJSEngine::collectGarbage()) always run a full collection.
+    void runGC(GCType type = FullGC);
+
+    // Incremental mode: marking is split into slices of limited duration, driven by the
+    // application's idle time (e.g. by the render loop between two frames). A negative budget
+    // uses the configured slice time. Returns true if a collection is still in progress.
+    bool runIncrementalGCSlice(qint64 budgetInUs = -1);
+    void startIncrementalGC();
+    bool isIncrementalGCRunning() const { return incrementalMarkStack != nullptr; }
+
+    // Picks up the results of a concurrent sweep. Returns false if it is still running and
+    // wait is false.
+    bool finishConcurrentSweep(bool wait);
 
     void dumpStats() const;
 
+    // Runs a full collection and writes every live object to device, one JSON object per line:
+    // address, type, size in bytes, InternalClass and the first object found to retain it.
+    // Returns the number of objects written, or -1 if a collection is in progress.
+    qint64 writeHeapSnapshot(QIODevice *device);
+
     size_t getUsedMem() const;
     size_t getAllocatedMem() const;
     size_t getLargeItemsMem() const;
@@ -280,7 +322,7 @@ public:
 protected:
     /// expects size to be aligned
     Heap::Base *allocString(std::size_t unmanagedSize);
-    Heap::Base *allocData(std::size_t size);
+    Heap::Base *allocData(std::size_t size, const VTable *vtable);
     Heap::Object *allocObjectWithMemberData(const QV4::VTable *vtable, uint nMembers);
 
 private:
@@ -289,22 +331,36 @@ private:
     };
 
     void collectFromJSStack(MarkStack *markStack) const;
-    void mark();
+    void mark(GCType type);
     void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
     bool shouldRunGC() const;
+    GCType nextGCType() const;
+    bool shouldStartIncrementalGC() const;
+    void finishIncrementalGC();
+    void finishCollection(GCType type);
     void collectRoots(MarkStack *markStack);
+    void collectGrayItems(MarkStack *markStack);
+    void resetBlackBits();
 
     HeapItem *allocate(BlockAllocator *allocator, std::size_t size)
     {
         bool didGCRun = false;
         if (aggressiveGC) {
-            runGC();
+            runGC(nextGCType());
             didGCRun = true;
         }
 
+        if (usesWriteBarrier()) {
+            slotsAllocatedSinceLastGC += size >> Chunk::SlotSizeShift;
+            if (generationalGC && !didGCRun && slotsAllocatedSinceLastGC > nurserySlots) {
+                runGC(nextGCType());
+                didGCRun = true;
+            }
+        }
+
         if (unmanagedHeapSize > unmanagedHeapSizeGCLimit) {
             if (!didGCRun)
-                runGC();
+                runGC(nextGCType());
 
             if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
                 // more than 75% full, raise limit
@@ -324,8 +380,13 @@ private:
         if (HeapItem *m = allocator->allocate(size))
             return m;
 
+        if (allocator->concurrentSweep && finishConcurrentSweep(/*wait*/false)) {
+            if (HeapItem *m = allocator->allocate(size))
+                return m;
+        }
+
         if (!didGCRun && shouldRunGC())
-            runGC();
+            runGC(nextGCType());
 
         return allocator->allocate(size, true);
     }
@@ -335,6 +396,8 @@ public:
     ChunkAllocator *chunkAllocator;
     BlockAllocator blockAllocator;
     BlockAllocator icAllocator;
+    // Objects without a destroy() callback, when sweeping concurrently
+    BlockAllocator plainAllocator;
     HugeItemAllocator hugeItemAllocator;
     PersistentValueStorage *m_persistentValues;
     PersistentValueStorage *m_weakValues;
@@ -346,10 +409,29 @@ public:
     std::size_t unmanagedHeapSizeGCLimit;
     std::size_t usedSlotsAfterLastFullSweep = 0;
 
+    // Generational mode: mark bits are kept after a collection, so that all surviving objects
+    // are considered old. Minor collections only trace objects allocated since the last
+    // collection, starting from the roots and the old objects recorded by the write barrier.
+    std::size_t nurserySlots = 0;
+    std::size_t slotsAllocatedSinceLastGC = 0;
+    std::size_t usedSlotsAfterLastFullGC = 0;
+    uint minorGCsSinceLastFullGC = 0;
+
+    // Incremental mode: the mark stack survives between two slices, and the write barrier
+    // records black objects modified in the meantime. Those and the roots are rescanned in
+    // one go before sweeping.
+    std::unique_ptr<MarkStack> incrementalMarkStack;
+    qint64 incrementalGCSliceTime = 0;
+
     bool gcBlocked = false;
     bool aggressiveGC = false;
     bool gcStats = false;
     bool gcCollectorStats = false;
+    bool generationalGC = false;
+    bool incrementalGC = false;
+    bool concurrentSweep = false;
+
+    bool usesWriteBarrier() const { return generationalGC || incrementalGC; }
 
     int allocationCount = 0;
     size_t lastAllocRequestedSlots = 0;
@@ -53,6 +53,8 @@
 #include <private/qv4global_p.h>
 #include <private/qv4runtimeapi_p.h>
 #include <QtCore/qalgorithms.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qhash.h>
 #include <qdebug.h>
 
 QT_BEGIN_NAMESPACE
@@ -190,6 +192,9 @@ struct Chunk {
     void resetBlackBits();
     void collectGrayItems(QV4::MarkStack *markStack);
     bool sweep(ExecutionEngine *engine);
+    // Like sweep(), but doesn't access the objects or the gray bits. Only valid for chunks where
+    // none of the objects needs a destroy() call. Can run on a different thread than the mutator.
+    bool sweepConcurrently(bool keepBlackBits, size_t *freedSlots);
     void freeAll(ExecutionEngine *engine);
 
     void sortIntoBins(HeapItem **bins, uint nBins);
@@ -285,7 +290,19 @@ struct MarkStack {
         return *top;
     }
     void drain();
+    // drains until the deadline expires, returns true if the stack is empty
+    bool drain(QDeadlineTimer deadline);
 
+    // Only set while writing a heap snapshot. Records for each marked object the object that
+    // caused it to be pushed. Objects pushed directly from the roots have no entry.
+    QHash<Heap::Base *, Heap::Base *> *retainers = nullptr;
+
+private:
+    void drainRecordingRetainers();
+    void recordRetainers();
+
+    Heap::Base *current = nullptr;
+    Heap::Base **pushedFrom = nullptr;
 };
 
 // Some helper to automate the generation of our
@@ -51,15 +51,17 @@
 //
 
 #include <private/qv4global_p.h>
+#include <private/qv4enginebase_p.h>
+#include <private/qv4mmdefs_p.h>
 
 QT_BEGIN_NAMESPACE
 
-#define WRITEBARRIER_none 1
+#define WRITEBARRIER_steele 1
+#define WRITEBARRIER_none -1
 
 #define WRITEBARRIER(x) (1/WRITEBARRIER_##x == 1)
 
 namespace QV4 {
-struct EngineBase;
 
 namespace WriteBarrier {
 
@@ -77,13 +79,75 @@ enum NewValueType {
 // ### this needs to be filled with a real memory fence once marking is concurrent
 Q_ALWAYS_INLINE void fence() {}
 
-#if WRITEBARRIER(none)
+#if WRITEBARRIER(steele)
+
+template <NewValueType type>
+static Q_CONSTEXPR inline bool isRequired() {
+    return type != Primitive;
+}
+
+// The barrier is only active while the memory manager needs to know about modified objects,
+// i.e. when running in generational mode. Modified objects get their gray bit set, and
+// the collector rescans all objects that are both black and gray.
+Q_ALWAYS_INLINE void markDirty(Heap::Base *base)
+{
+    HeapItem *h = reinterpret_cast<HeapItem *>(base);
+    Chunk *c = h->chunk();
+    Chunk::setBit(c->grayBitmap, h - c->realBase());
+}
+
+inline void markCustom(EngineBase *engine, Heap::Base *base)
+{
+    if (Q_UNLIKELY(engine->writeBarrierActive)) {
+        fence();
+        markDirty(base);
+    }
+}
+
+// Marks a newly allocated object that is only referenced from memory the collector does not
+// see through the barrier (e.g. shared InternalClass data). The object is treated as old and
+// will be rescanned by the next collection.
+inline void markExternallyReferenced(EngineBase *engine, Heap::Base *base)
+{
+    if (Q_UNLIKELY(engine->writeBarrierActive)) {
+        HeapItem *h = reinterpret_cast<HeapItem *>(base);
+        Chunk *c = h->chunk();
+        Chunk::setBit(c->blackBitmap, h - c->realBase());
+        markDirty(base);
+    }
+}
+
+inline void write(EngineBase *engine, Heap::Base *base, ReturnedValue *slot, ReturnedValue value)
+{
+    *slot = value;
+    markCustom(engine, base);
+}
+
+inline void write(EngineBase *engine, Heap::Base *base, Heap::Base **slot, Heap::Base *value)
+{
+    *slot = value;
+    markCustom(engine, base);
+}
+
+#elif WRITEBARRIER(none)
 
 template <NewValueType type>
 static Q_CONSTEXPR inline bool isRequired() {
     return false;
 }
 
+inline void markCustom(EngineBase *engine, Heap::Base *base)
+{
+    Q_UNUSED(engine);
+    Q_UNUSED(base);
+}
+
+inline void markExternallyReferenced(EngineBase *engine, Heap::Base *base)
+{
+    Q_UNUSED(engine);
+    Q_UNUSED(base);
+}
+
 inline void write(EngineBase *engine, Heap::Base *base, ReturnedValue *slot, ReturnedValue value)
 {
     Q_UNUSED(engine);
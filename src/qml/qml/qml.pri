@@ -7,6 +7,7 @@ SOURCES += \
     $$PWD/qqmlscriptblob.cpp \
     $$PWD/qqmlscriptdata.cpp \
     $$PWD/qqmltypedata.cpp \
+    $$PWD/qqmltypeloaderparsejob.cpp \
     $$PWD/qqmltypeloaderqmldircontent.cpp \
     $$PWD/qqmltypeloaderthread.cpp \
     $$PWD/qqmlvmemetaobject.cpp \
@@ -75,6 +76,7 @@ HEADERS += \
     $$PWD/qqmlscriptblob_p.h \
     $$PWD/qqmlscriptdata_p.h \
     $$PWD/qqmltypedata_p.h \
+    $$PWD/qqmltypeloaderparsejob_p.h \
     $$PWD/qqmltypeloaderqmldircontent_p.h \
     $$PWD/qqmltypeloaderthread_p.h \
     $$PWD/qqmlvmemetaobject_p.h \
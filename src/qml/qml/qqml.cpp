@@ -41,11 +41,17 @@
 
 #include <QtQml/qqmlprivate.h>
 
+#include <private/qqmlcontext_p.h>
 #include <private/qqmlengine_p.h>
+#include <private/qqmljavascriptexpression_p.h>
 #include <private/qqmlmetatype_p.h>
 #include <private/qqmlmetatypedata_p.h>
+#include <private/qqmlproperty_p.h>
+#include <private/qqmlpropertycache_p.h>
 #include <private/qqmltype_p_p.h>
 #include <private/qqmltypemodule_p_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4scopedvalue_p.h>
 
 #include <QtCore/qmutex.h>
 
@@ -314,4 +320,289 @@ void QQmlPrivate::qmlunregister(RegistrationType type, quintptr data)
     }
 }
 
+static QQmlPropertyData *findAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext,
+                                         QObject *object, uint nameIndex, QQmlPropertyData *local)
+{
+    if (!object || QQmlData::wasDeleted(object))
+        return nullptr;
+
+    QV4::Scope scope(aotContext->engine->handle());
+    QV4::ScopedString nameString(scope, aotContext->compilationUnit->runtimeStrings[nameIndex]);
+    QV4::String *name = nameString.getPointer();
+
+    QQmlData *ddata = QQmlData::get(object, false);
+    if (ddata && ddata->propertyCache)
+        return ddata->propertyCache->property(name, object, aotContext->qmlContext);
+    return QQmlPropertyCache::property(aotContext->engine, object, name, aotContext->qmlContext,
+                                       *local);
+}
+
+// Methods, var properties and properties hidden by the imported version are left to the bytecode.
+static bool isAOTAccessible(QObject *object, QQmlPropertyData *property)
+{
+    if (property->isFunction() || property->isVarProperty())
+        return false;
+    if (!property->hasRevision())
+        return true;
+    QQmlData *ddata = QQmlData::get(object, false);
+    return !ddata || !ddata->propertyCache || ddata->propertyCache->isAllowedInRevision(property);
+}
+
+// Looks up a name in the same order as QQmlContextWrapper, but only considers ids and the
+// properties of scope and context objects. On success, property is null if the name is an id.
+static bool lookupAOTName(const QQmlPrivate::AOTCompiledContext *aotContext, uint nameIndex,
+                          QObject **object, QQmlPropertyData **property, QQmlPropertyData *local)
+{
+    QObject *scopeObject = aotContext->qmlScopeObject;
+    if (scopeObject && QQmlPropertyCache::isDynamicMetaObject(scopeObject->metaObject()))
+        return false;
+
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(aotContext->qmlContext->engine);
+    QV4::Scope scope(aotContext->engine->handle());
+    QV4::ScopedString name(scope, aotContext->compilationUnit->runtimeStrings[nameIndex]);
+
+    for (QQmlContextData *context = aotContext->qmlContext; context; context = context->parent) {
+        const QV4::IdentifierHash &properties = context->propertyNames();
+        const int propertyIdx = properties.count() ? properties.value(name) : -1;
+        if (propertyIdx != -1) {
+            if (propertyIdx >= context->idValueCount)
+                return false; // context property
+
+            if (ep->propertyCapture)
+                ep->propertyCapture->captureProperty(&context->idValues[propertyIdx].bindings);
+            *object = context->idValues[propertyIdx];
+            *property = nullptr;
+            return *object != nullptr;
+        }
+
+        for (QObject *candidate : { scopeObject, context->contextObject }) {
+            if (QQmlPropertyData *candidateProperty = findAOTProperty(aotContext, candidate,
+                                                                      nameIndex, local)) {
+                *object = candidate;
+                *property = candidateProperty;
+                return true;
+            }
+        }
+        scopeObject = nullptr;
+    }
+
+    return false;
+}
+
+static void captureAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                               QQmlPropertyData *property)
+{
+    QQmlData::flushPendingBinding(object, QQmlPropertyIndex(property->coreIndex()));
+
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(aotContext->qmlContext->engine);
+    if (ep->propertyCapture && !property->isConstant())
+        ep->propertyCapture->captureProperty(object, property->coreIndex(), property->notifyIndex());
+}
+
+static bool readAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                            QQmlPropertyData *property, QObject **value)
+{
+    if (!isAOTAccessible(object, property) || !property->isQObject())
+        return false;
+    captureAOTProperty(aotContext, object, property);
+    *value = nullptr;
+    property->readProperty(object, value);
+    return true;
+}
+
+static bool readAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                            QQmlPropertyData *property, double *value)
+{
+    if (!isAOTAccessible(object, property))
+        return false;
+
+    switch (property->propType()) {
+    case QMetaType::Int: {
+        int v = 0;
+        captureAOTProperty(aotContext, object, property);
+        property->readProperty(object, &v);
+        *value = v;
+        return true;
+    }
+    case QMetaType::UInt: {
+        uint v = 0;
+        captureAOTProperty(aotContext, object, property);
+        property->readProperty(object, &v);
+        *value = v;
+        return true;
+    }
+    case QMetaType::Float: {
+        float v = 0;
+        captureAOTProperty(aotContext, object, property);
+        property->readProperty(object, &v);
+        *value = v;
+        return true;
+    }
+    case QMetaType::Double:
+        captureAOTProperty(aotContext, object, property);
+        property->readProperty(object, value);
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool readAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                            QQmlPropertyData *property, bool *value)
+{
+    if (!isAOTAccessible(object, property) || property->propType() != QMetaType::Bool)
+        return false;
+    captureAOTProperty(aotContext, object, property);
+    property->readProperty(object, value);
+    return true;
+}
+
+static bool readAOTProperty(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                            QQmlPropertyData *property, QString *value)
+{
+    if (!isAOTAccessible(object, property) || property->propType() != QMetaType::QString)
+        return false;
+    captureAOTProperty(aotContext, object, property);
+    property->readProperty(object, value);
+    return true;
+}
+
+template<typename T>
+static bool lookupAOTValue(const QQmlPrivate::AOTCompiledContext *aotContext, uint nameIndex,
+                           T *value)
+{
+    QObject *object = nullptr;
+    QQmlPropertyData *property = nullptr;
+    QQmlPropertyData local;
+    if (!lookupAOTName(aotContext, nameIndex, &object, &property, &local) || !property)
+        return false;
+    return readAOTProperty(aotContext, object, property, value);
+}
+
+template<typename T>
+static bool loadAOTValue(const QQmlPrivate::AOTCompiledContext *aotContext, QObject *object,
+                         uint nameIndex, T *value)
+{
+    QQmlPropertyData local;
+    QQmlPropertyData *property = findAOTProperty(aotContext, object, nameIndex, &local);
+    return property && readAOTProperty(aotContext, object, property, value);
+}
+
+// Mirrors QV4::QObjectWrapper::setProperty: the assignment replaces any binding on the property.
+template<typename T>
+static bool storeAOTValue(QObject *object, QQmlPropertyData *property, T value)
+{
+    QQmlPropertyPrivate::removeBinding(object, QQmlPropertyIndex(property->coreIndex()));
+    property->writeProperty(object, &value, {});
+    return true;
+}
+
+static QQmlPropertyData *findAOTStoreTarget(const QQmlPrivate::AOTCompiledContext *aotContext,
+                                            QObject *object, uint nameIndex,
+                                            QQmlPropertyData *local)
+{
+    QQmlPropertyData *property = findAOTProperty(aotContext, object, nameIndex, local);
+    if (!property || !isAOTAccessible(object, property) || !property->isWritable())
+        return nullptr;
+    return property;
+}
+
+bool QQmlPrivate::AOTCompiledContext::lookupObject(uint nameIndex, QObject **value) const
+{
+    QObject *object = nullptr;
+    QQmlPropertyData *property = nullptr;
+    QQmlPropertyData local;
+    if (!lookupAOTName(this, nameIndex, &object, &property, &local))
+        return false;
+    if (!property) {
+        *value = object;
+        return true;
+    }
+    return readAOTProperty(this, object, property, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::lookupNumber(uint nameIndex, double *value) const
+{
+    return lookupAOTValue(this, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::lookupBool(uint nameIndex, bool *value) const
+{
+    return lookupAOTValue(this, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::lookupString(uint nameIndex, QString *value) const
+{
+    return lookupAOTValue(this, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::lookupPropertyOwner(uint nameIndex, QObject **owner) const
+{
+    QQmlPropertyData *property = nullptr;
+    QQmlPropertyData local;
+    return lookupAOTName(this, nameIndex, owner, &property, &local) && property;
+}
+
+bool QQmlPrivate::AOTCompiledContext::loadObject(QObject *object, uint nameIndex,
+                                                 QObject **value) const
+{
+    return loadAOTValue(this, object, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::loadNumber(QObject *object, uint nameIndex,
+                                                 double *value) const
+{
+    return loadAOTValue(this, object, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::loadBool(QObject *object, uint nameIndex, bool *value) const
+{
+    return loadAOTValue(this, object, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::loadString(QObject *object, uint nameIndex,
+                                                 QString *value) const
+{
+    return loadAOTValue(this, object, nameIndex, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::storeNumber(QObject *object, uint nameIndex,
+                                                  double value) const
+{
+    QQmlPropertyData local;
+    QQmlPropertyData *property = findAOTStoreTarget(this, object, nameIndex, &local);
+    if (!property)
+        return false;
+
+    switch (property->propType()) {
+    case QMetaType::Int:
+        return storeAOTValue<int>(object, property, value);
+    case QMetaType::Float:
+        return storeAOTValue<float>(object, property, value);
+    case QMetaType::Double:
+        return storeAOTValue<double>(object, property, value);
+    default:
+        return false;
+    }
+}
+
+bool QQmlPrivate::AOTCompiledContext::storeBool(QObject *object, uint nameIndex, bool value) const
+{
+    QQmlPropertyData local;
+    QQmlPropertyData *property = findAOTStoreTarget(this, object, nameIndex, &local);
+    if (!property || property->propType() != QMetaType::Bool)
+        return false;
+    return storeAOTValue(object, property, value);
+}
+
+bool QQmlPrivate::AOTCompiledContext::storeString(QObject *object, uint nameIndex,
+                                                  const QString &value) const
+{
+    QQmlPropertyData local;
+    QQmlPropertyData *property = findAOTStoreTarget(this, object, nameIndex, &local);
+    if (!property || property->propType() != QMetaType::QString)
+        return false;
+    return storeAOTValue(object, property, value);
+}
+
 QT_END_NAMESPACE
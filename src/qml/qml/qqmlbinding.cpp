@@ -47,6 +47,7 @@
 #include <private/qqmlexpression_p.h>
 #include <private/qqmlscriptstring_p.h>
 #include <private/qqmlbuiltinfunctions_p.h>
+#include <private/qqmlglobal_p.h>
 #include <private/qqmlvmemetaobject_p.h>
 #include <private/qqmlvaluetypewrapper_p.h>
 #include <private/qv4qmlcontext_p.h>
@@ -60,6 +61,8 @@
 
 QT_BEGIN_NAMESPACE
 
+DEFINE_BOOL_CONFIG_OPTION(qmlDisableSimpleBindings, QML_DISABLE_SIMPLE_BINDINGS)
+
 QQmlBinding *QQmlBinding::create(const QQmlPropertyData *property, const QQmlScriptString &script, QObject *obj, QQmlContext *ctxt)
 {
     QQmlBinding *b = newBinding(QQmlEnginePrivate::get(ctxt), property);
@@ -143,6 +146,18 @@ QQmlBinding *QQmlBinding::create(const QQmlPropertyData *property, QV4::Function
     return b;
 }
 
+QQmlBinding *QQmlBinding::createSimpleBinding(const QQmlPropertyData *property, QV4::Function *function,
+                                              const QV4::CompiledData::SimpleBinding *simpleBinding,
+                                              QObject *obj, QQmlContextData *ctxt, QV4::ExecutionContext *scope)
+{
+    QQmlBinding *b = create(property, function, obj, ctxt, scope);
+
+    if (!qmlDisableSimpleBindings())
+        b->m_simpleBinding = simpleBinding;
+
+    return b;
+}
+
 QQmlBinding::~QQmlBinding()
 {
     delete m_sourceLocation;
@@ -243,7 +258,12 @@ protected:
 
         bool isUndefined = false;
 
-        QV4::ScopedValue result(scope, evaluate(&isUndefined));
+        QV4::ScopedValue result(scope);
+        // Leave the evaluation to the function while a debugger may want to step through it
+        if (m_simpleBinding && !scope.engine->debugger() && evaluateSimpleBinding(scope, result))
+            isUndefined = result->isUndefined();
+        else
+            result = evaluate(&isUndefined);
 
         bool error = false;
         if (!watcher.wasDeleted() && isAddedToObject() && !hasError())
@@ -267,8 +287,143 @@ protected:
     }
 
     virtual bool write(const QV4::Value &result, bool isUndefined, QQmlPropertyData::WriteFlags flags) = 0;
+
+private:
+    bool evaluateSimpleBinding(QV4::Scope &scope, QV4::ScopedValue &result);
 };
 
+// Looks up a name in the same order as QQmlContextWrapper, but only considers ids and the
+// properties of scope and context objects. Everything else is left to the binding's function.
+static bool lookupSimpleBindingName(QV4::ExecutionEngine *v4, QQmlEnginePrivate *ep, QQmlContextData *context,
+                                    QObject *scopeObject, QV4::String *name, QV4::ScopedValue &result)
+{
+    if (scopeObject && QQmlPropertyCache::isDynamicMetaObject(scopeObject->metaObject()))
+        return false;
+
+    for (; context; context = context->parent) {
+        const QV4::IdentifierHash &properties = context->propertyNames();
+        const int propertyIdx = properties.count() ? properties.value(name) : -1;
+        if (propertyIdx != -1) {
+            if (propertyIdx >= context->idValueCount)
+                return false; // context property
+
+            if (ep->propertyCapture)
+                ep->propertyCapture->captureProperty(&context->idValues[propertyIdx].bindings);
+            result = QV4::QObjectWrapper::wrap(v4, context->idValues[propertyIdx]);
+            return true;
+        }
+
+        for (QObject *object : { scopeObject, context->contextObject }) {
+            if (!object)
+                continue;
+            bool hasProperty = false;
+            result = QV4::QObjectWrapper::getQmlProperty(v4, context, object, name,
+                                                         QV4::QObjectWrapper::CheckRevision, &hasProperty);
+            if (hasProperty)
+                return true;
+        }
+        scopeObject = nullptr;
+    }
+
+    return false;
+}
+
+// Evaluates the expression described by m_simpleBinding without calling the binding's function,
+// capturing the same dependencies. Returns false if the expression needs the full JavaScript
+// semantics, for example because an object is null or an operand isn't a number. The function
+// then runs as usual and reports any errors.
+bool QQmlNonbindingBinding::evaluateSimpleBinding(QV4::Scope &scope, QV4::ScopedValue &result)
+{
+    QV4::ExecutionEngine *v4 = scope.engine;
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(context()->engine);
+    QV4::Function *v4Function = function();
+    const QV4::CompiledData::SimpleBinding *simpleBinding = m_simpleBinding;
+
+    DeleteWatcher watcher(this);
+
+    QQmlPropertyCapture capture(context()->engine, this, &watcher);
+    QQmlPropertyCapture *lastPropertyCapture = ep->propertyCapture;
+    ep->propertyCapture = notifyOnValueChanged() ? &capture : nullptr;
+
+    if (notifyOnValueChanged())
+        capture.guards.copyAndClearPrepend(activeGuards);
+
+    QV4::ScopedString name(scope, v4Function->runtimeString(simpleBinding->objectNameIndex));
+    bool ok = lookupSimpleBindingName(v4, ep, context(), scopeObject(), name, result);
+
+    if (ok && simpleBinding->hasProperty()) {
+        QV4::Scoped<QV4::QObjectWrapper> object(scope, result);
+        ok = false;
+        if (object) {
+            name = v4Function->runtimeString(simpleBinding->propertyNameIndex);
+            result = object->getQmlProperty(context(), name, QV4::QObjectWrapper::IgnoreRevision,
+                                            &ok, /*includeImports*/ true);
+        }
+    }
+
+    if (scope.hasException()) {
+        scope.engine->catchException();
+        ok = false;
+    }
+
+    if (ok) {
+        switch (simpleBinding->operation) {
+        case QV4::CompiledData::SimpleBinding::Copy:
+            break;
+        case QV4::CompiledData::SimpleBinding::Not:
+            result = QV4::Encode(!result->toBoolean());
+            break;
+        default: {
+            if (!result->isNumber()) {
+                ok = false;
+                break;
+            }
+            const double lhs = result->asDouble();
+            const double rhs = v4Function->executableCompilationUnit()->constants[simpleBinding->constantIndex].doubleValue();
+            switch (simpleBinding->operation) {
+            case QV4::CompiledData::SimpleBinding::Add:
+                result = QV4::Encode(lhs + rhs);
+                break;
+            case QV4::CompiledData::SimpleBinding::Subtract:
+                result = QV4::Encode(lhs - rhs);
+                break;
+            case QV4::CompiledData::SimpleBinding::Multiply:
+                result = QV4::Encode(lhs * rhs);
+                break;
+            case QV4::CompiledData::SimpleBinding::Divide:
+                result = QV4::Encode(lhs / rhs);
+                break;
+            default:
+                ok = false;
+                break;
+            }
+            break;
+        }
+        }
+    }
+
+    if (capture.errorString) {
+        for (int ii = 0; ii < capture.errorString->count(); ++ii)
+            qWarning("%s", qPrintable(capture.errorString->at(ii)));
+        delete capture.errorString;
+        capture.errorString = nullptr;
+    }
+
+    while (QQmlJavaScriptExpressionGuard *g = capture.guards.takeFirst())
+        g->Delete();
+
+    ep->propertyCapture = lastPropertyCapture;
+
+    // Reading the properties may have deleted the binding. Don't fall back to the function then.
+    if (watcher.wasDeleted())
+        return true;
+
+    if (ok && hasDelayedError())
+        delayedError()->clearError();
+
+    return ok;
+}
+
 template<int StaticPropType>
 class GenericBinding: public QQmlNonbindingBinding
 {
@@ -528,6 +683,18 @@ QString QQmlBinding::expressionIdentifier() const
 
 void QQmlBinding::expressionChanged()
 {
+    if (!m_targetIndex.hasValueTypeIndex()) {
+        QObject *target = targetObject();
+        QQmlData *data = target ? QQmlData::get(target) : nullptr;
+        if (Q_UNLIKELY(data && data->deferBindingUpdates)) {
+            // Disabling drops the guards, so that no further changes are tracked until the
+            // binding is evaluated again.
+            setEnabled(false);
+            data->setPendingBindingBit(target, m_targetIndex.coreIndex());
+            return;
+        }
+    }
+
     update();
 }
 
@@ -80,6 +80,9 @@ public:
                                const QString &url = QString(), quint16 lineNumber = 0);
     static QQmlBinding *create(const QQmlPropertyData *property, QV4::Function *function,
                                QObject *obj, QQmlContextData *ctxt, QV4::ExecutionContext *scope);
+    static QQmlBinding *createSimpleBinding(const QQmlPropertyData *property, QV4::Function *function,
+                                            const QV4::CompiledData::SimpleBinding *simpleBinding,
+                                            QObject *obj, QQmlContextData *ctxt, QV4::ExecutionContext *scope);
     static QQmlBinding *createTranslationBinding(const QQmlRefPointer<QV4::ExecutableCompilationUnit> &unit, const QV4::CompiledData::Binding *binding,
                                                  QObject *obj, QQmlContextData *ctxt);
     ~QQmlBinding() override;
@@ -133,6 +136,8 @@ protected:
 
     QV4::ReturnedValue evaluate(bool *isUndefined);
 
+    const QV4::CompiledData::SimpleBinding *m_simpleBinding = nullptr; // evaluated without calling the function when set
+
 private:
     inline bool updatingFlag() const;
     inline void setUpdatingFlag(bool);
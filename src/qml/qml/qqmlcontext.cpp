@@ -282,6 +282,7 @@ void QQmlContext::setContextObject(QObject *object)
     }
 
     data->contextObject = object;
+    ++data->nameGeneration;
     data->refreshExpressions();
 }
 
@@ -311,6 +312,7 @@ void QQmlContext::setContextProperty(const QString &name, const QVariant &value)
     if (idx == -1) {
         properties.add(name, data->idValueCount + d->propertyValues.count());
         d->propertyValues.append(value);
+        ++data->nameGeneration;
 
         data->refreshExpressions();
     } else {
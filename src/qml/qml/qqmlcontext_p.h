@@ -171,6 +171,10 @@ public:
     const QV4::IdentifierHash &propertyNames() const;
     QV4::IdentifierHash &detachedPropertyNames();
 
+    // Incremented when a name is added to this context or its context object is replaced, so that
+    // cached lookups of names found in parent contexts notice they might be shadowed now.
+    quint32 nameGeneration = 0;
+
     // Context object
     QObject *contextObject;
 
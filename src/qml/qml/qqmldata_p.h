@@ -159,7 +159,13 @@ public:
     quint32 hasInterceptorMetaObject:1;
     quint32 hasVMEMetaObject:1;
     quint32 parentFrozen:1;
-    quint32 dummy:6;
+    /*
+     * deferBindingUpdates postpones the re-evaluation of bindings on this object when their
+     * dependencies change. The bindings are marked pending instead, and evaluated when they
+     * are read or when flushPendingBindings() is called.
+     */
+    quint32 deferBindingUpdates:1;
+    quint32 dummy:5;
 
     // When bindingBitsSize < sizeof(ptr), we store the binding bit flags inside
     // bindingBitsValue. When we need more than sizeof(ptr) bits, we allocated
@@ -274,6 +280,7 @@ public:
     static void setQueuedForDeletion(QObject *);
 
     static inline void flushPendingBinding(QObject *, QQmlPropertyIndex propertyIndex);
+    void flushPendingBindings(QObject *);
 
     static QQmlPropertyCache *ensurePropertyCache(QJSEngine *engine, QObject *object)
     {
@@ -69,6 +69,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qvarlengtharray.h>
 #include <private/qthread_p.h>
 
 #if QT_CONFIG(qml_network)
@@ -640,8 +641,9 @@ QQmlEnginePrivate::QQmlEnginePrivate(QQmlEngine *e)
 #endif
   outputWarningsToMsgLog(true),
   cleanup(nullptr), erroredBindings(nullptr), inProgressCreations(0),
+  propertyUpdateBatchDepth(0),
 #if QT_CONFIG(qml_worker_script)
-  workerScriptEngine(nullptr),
+  workerScriptEnginePool(nullptr),
 #endif
   activeObjectCreator(nullptr),
 #if QT_CONFIG(qml_network)
@@ -720,6 +722,7 @@ QQmlData::QQmlData()
     : ownedByQml1(false), ownMemory(true), indestructible(true), explicitIndestructibleSet(false),
       hasTaintedV4Object(false), isQueuedForDeletion(false), rootObjectInCreation(false),
       hasInterceptorMetaObject(false), hasVMEMetaObject(false), parentFrozen(false),
+      deferBindingUpdates(false),
       bindingBitsArraySize(InlineBindingArraySize), notifyList(nullptr),
       bindings(nullptr), signalHandlers(nullptr), nextContextObject(nullptr), prevContextObject(nullptr),
       lineNumber(0), columnNumber(0), jsEngineId(0),
@@ -900,6 +903,20 @@ void QQmlData::flushPendingBindingImpl(QQmlPropertyIndex index)
                             QQmlPropertyData::DontRemoveBinding);
 }
 
+void QQmlData::flushPendingBindings(QObject *object)
+{
+    // Evaluating a binding may add or remove others
+    QVarLengthArray<int, 16> pendingIndexes;
+    for (QQmlAbstractBinding *b = bindings; b; b = b->nextBinding()) {
+        const QQmlPropertyIndex index = b->targetPropertyIndex();
+        if (!index.hasValueTypeIndex() && hasPendingBindingBit(index.coreIndex()))
+            pendingIndexes.append(index.coreIndex());
+    }
+
+    for (int coreIndex : qAsConst(pendingIndexes))
+        flushPendingBinding(object, QQmlPropertyIndex(coreIndex));
+}
+
 QQmlData::DeferredData::DeferredData()
 {
 }
@@ -1019,6 +1036,14 @@ QQmlEngine::~QQmlEngine()
 
     delete d->rootContext;
     d->rootContext = nullptr;
+
+    // Expressions that outlive the engine must not try to remove themselves from the batch
+    for (QQmlJavaScriptExpression *expression : qAsConst(d->batchedExpressions)) {
+        if (expression)
+            expression->setInPropertyUpdateBatch(false);
+    }
+    d->batchedExpressions.clear();
+    d->batchedExpressionIndexes.clear();
 }
 
 /*! \fn void QQmlEngine::quit()
@@ -1083,6 +1108,104 @@ void QQmlEngine::trimComponentCache()
     d->typeLoader.trimCache();
 }
 
+/*!
+  \since 6.0
+
+  Starts a batch of property updates.
+
+  Until the matching call to endPropertyUpdateBatch(), bindings are not re-evaluated when
+  the properties they depend on change. Instead, they are evaluated when the batch
+  ends. This is useful when a C++ backend updates many properties at once, and bindings
+  depend on several of them.
+
+  Batches can be nested. The bindings are only evaluated when the outermost batch ends.
+
+  \note Bindings observe the old values of their dependencies until the batch ends.
+
+  \sa endPropertyUpdateBatch()
+ */
+void QQmlEngine::beginPropertyUpdateBatch()
+{
+    Q_D(QQmlEngine);
+    ++d->propertyUpdateBatchDepth;
+}
+
+/*!
+  \since 6.0
+
+  Ends a batch of property updates started with beginPropertyUpdateBatch().
+
+  If this ends the outermost batch, every binding whose dependencies changed during
+  the batch is evaluated. The bindings are evaluated in the order their dependencies
+  changed, followed by the bindings depending on the properties those change, and so on.
+  A binding that depends on several of the properties changed during the batch is
+  evaluated once, after all of them. A binding reached through chains of bindings of
+  different lengths is evaluated again each time one of its dependencies changes after
+  it was first evaluated.
+
+  \sa beginPropertyUpdateBatch()
+ */
+void QQmlEngine::endPropertyUpdateBatch()
+{
+    Q_D(QQmlEngine);
+    if (d->propertyUpdateBatchDepth <= 0) {
+        qWarning("QQmlEngine::endPropertyUpdateBatch: No batch of property updates was started");
+        return;
+    }
+
+    // Changes caused by the evaluated bindings are batched as well
+    if (d->propertyUpdateBatchDepth == 1)
+        d->flushBatchedExpressions();
+    --d->propertyUpdateBatchDepth;
+}
+
+void QQmlEnginePrivate::queueBatchedExpression(QQmlJavaScriptExpression *expression)
+{
+    if (expression->isInPropertyUpdateBatch()) {
+        // An expression that changes again after it was evaluated in this batch is updated
+        // right away, as outside of a batch. This way binding loops are still detected.
+        if (!flushedExpressions.isEmpty() && flushedExpressions.contains(expression))
+            expression->expressionChanged();
+        return;
+    }
+
+    expression->setInPropertyUpdateBatch(true);
+    batchedExpressionIndexes.insert(expression, batchedExpressions.count());
+    batchedExpressions.append(expression);
+}
+
+void QQmlEnginePrivate::removeBatchedExpression(QQmlJavaScriptExpression *expression)
+{
+    const auto it = batchedExpressionIndexes.constFind(expression);
+    if (it != batchedExpressionIndexes.cend()) {
+        batchedExpressions[*it] = nullptr;
+        batchedExpressionIndexes.erase(it);
+    }
+    flushedExpressions.remove(expression);
+}
+
+void QQmlEnginePrivate::flushBatchedExpressions()
+{
+    // The expressions are evaluated in the order they were first invalidated. The changes
+    // they cause append the expressions depending on them to the list, so that an expression
+    // depending on several changed properties sees all of them updated. Evaluated expressions
+    // stay marked until the end, so that they can remove themselves when deleted.
+    for (int i = 0; i < batchedExpressions.count(); ++i) {
+        QQmlJavaScriptExpression *expression = batchedExpressions.at(i);
+        if (!expression)
+            continue;
+        batchedExpressions[i] = nullptr;
+        batchedExpressionIndexes.remove(expression);
+        flushedExpressions.insert(expression);
+        expression->expressionChanged();
+    }
+
+    batchedExpressions.clear();
+    for (QQmlJavaScriptExpression *expression : qAsConst(flushedExpressions))
+        expression->setInPropertyUpdateBatch(false);
+    flushedExpressions.clear();
+}
+
 /*!
   Returns the engine's root context.
 
@@ -104,6 +104,9 @@ public:
     void clearComponentCache();
     void trimComponentCache();
 
+    void beginPropertyUpdateBatch();
+    void endPropertyUpdateBatch();
+
     QStringList importPathList() const;
     void setImportPathList(const QStringList &paths);
     void addImportPath(const QString& dir);
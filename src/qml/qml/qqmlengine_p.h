@@ -72,8 +72,10 @@
 #include <QtCore/qpair.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qvector.h>
 
 #include <private/qobject_p.h>
 
@@ -156,10 +158,20 @@ public:
     QQmlDelayedError *erroredBindings;
     int inProgressCreations;
 
+    // Expressions whose dependencies changed inside QQmlEngine::beginPropertyUpdateBatch()
+    // and QQmlEngine::endPropertyUpdateBatch()
+    int propertyUpdateBatchDepth;
+    QVector<QQmlJavaScriptExpression *> batchedExpressions;
+    QHash<QQmlJavaScriptExpression *, int> batchedExpressionIndexes;
+    QSet<QQmlJavaScriptExpression *> flushedExpressions;
+    void queueBatchedExpression(QQmlJavaScriptExpression *);
+    void removeBatchedExpression(QQmlJavaScriptExpression *);
+    void flushBatchedExpressions();
+
     QV4::ExecutionEngine *v4engine() const { return q_func()->handle(); }
 
 #if QT_CONFIG(qml_worker_script)
-    QThread *workerScriptEngine;
+    QObject *workerScriptEnginePool;
 #endif
 
     QUrl baseUrl;
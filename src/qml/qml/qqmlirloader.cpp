@@ -113,6 +113,10 @@ QmlIR::Object *QQmlIRLoader::loadObject(const QV4::CompiledData::Object *seriali
 
             QmlIR::CompiledFunctionOrExpression *foe = pool->New<QmlIR::CompiledFunctionOrExpression>();
             foe->nameIndex = 0;
+            if (const QV4::CompiledData::SimpleBinding *simpleBinding = unit->qmlUnit()->simpleBindingForFunction(functionIndices.last())) {
+                foe->simpleBinding = pool->New<QV4::CompiledData::SimpleBinding>();
+                *foe->simpleBinding = *simpleBinding;
+            }
 
             QQmlJS::AST::ExpressionNode *expr;
 
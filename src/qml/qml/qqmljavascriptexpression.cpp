@@ -102,6 +102,12 @@ QQmlJavaScriptExpression::QQmlJavaScriptExpression()
 
 QQmlJavaScriptExpression::~QQmlJavaScriptExpression()
 {
+    if (Q_UNLIKELY(isInPropertyUpdateBatch())) {
+        QV4::ExecutionEngine *engine = m_qmlScope.engine();
+        if (QQmlEnginePrivate *ep = engine ? QQmlEnginePrivate::get(engine) : nullptr)
+            ep->removeBatchedExpression(this);
+    }
+
     if (m_prevExpression) {
         *m_prevExpression = m_nextExpression;
         if (m_nextExpression)
@@ -208,10 +214,22 @@ QV4::ReturnedValue QQmlJavaScriptExpression::evaluate(QV4::CallData *callData, b
     }
 
     Q_ASSERT(m_qmlScope.valueRef());
-    QV4::ReturnedValue res = v4Function->call(
-            &(callData->thisObject.asValue<QV4::Value>()),
-            callData->argValues<QV4::Value>(), callData->argc(),
-            static_cast<QV4::ExecutionContext *>(m_qmlScope.valueRef()));
+    QV4::ReturnedValue res = QV4::Encode::undefined();
+    bool evaluated = false;
+    // Signal handlers can refer to their parameters by name, which compiled code can't.
+    // A debugger attached after the unit was linked has to be able to stop in the function.
+    if (v4Function->aotFunction && !v4->debugger() && callData->argc() == 0) {
+        evaluated = evaluateAOTFunction(v4Function, &res) || watcher.wasDeleted();
+        // Start over with the guards the compiled code captured before it gave up.
+        if (!evaluated && notifyOnValueChanged())
+            capture.guards.copyAndClearPrepend(activeGuards);
+    }
+    if (!evaluated) {
+        res = v4Function->call(
+                &(callData->thisObject.asValue<QV4::Value>()),
+                callData->argValues<QV4::Value>(), callData->argc(),
+                static_cast<QV4::ExecutionContext *>(m_qmlScope.valueRef()));
+    }
     QV4::Scope scope(v4);
     QV4::ScopedValue result(scope, res);
 
@@ -366,6 +384,52 @@ QQmlJavaScriptExpression::evalFunction(QQmlContextData *ctxt, QObject *scopeObje
     return result->asReturnedValue();
 }
 
+// Runs the C++ code qmlcachegen generated for v4Function instead of its bytecode. Returns false
+// without side effects if the code can't handle the types it encounters.
+bool QQmlJavaScriptExpression::evaluateAOTFunction(QV4::Function *v4Function,
+                                                   QV4::ReturnedValue *result)
+{
+    const QQmlPrivate::AOTCompiledFunction *aotFunction = v4Function->aotFunction;
+
+    QQmlPrivate::AOTCompiledContext aotContext;
+    aotContext.qmlContext = m_context;
+    aotContext.qmlScopeObject = scopeObject();
+    aotContext.engine = m_context->engine;
+    aotContext.compilationUnit = v4Function->executableCompilationUnit();
+
+    switch (aotFunction->returnType) {
+    case QMetaType::Void:
+        // Only signal handlers are compiled without a result.
+        if (notifyOnValueChanged() || !aotFunction->functionPtr(&aotContext, nullptr))
+            return false;
+        *result = QV4::Encode::undefined();
+        return true;
+    case QMetaType::Double: {
+        double value = 0;
+        if (!aotFunction->functionPtr(&aotContext, &value))
+            return false;
+        *result = QV4::Encode(value);
+        return true;
+    }
+    case QMetaType::Bool: {
+        bool value = false;
+        if (!aotFunction->functionPtr(&aotContext, &value))
+            return false;
+        *result = QV4::Encode(value);
+        return true;
+    }
+    case QMetaType::QString: {
+        QString value;
+        if (!aotFunction->functionPtr(&aotContext, &value))
+            return false;
+        *result = m_context->engine->handle()->newString(value)->asReturnedValue();
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
 void QQmlJavaScriptExpression::createQmlBinding(QQmlContextData *ctxt, QObject *qmlScope,
                                           const QString &code, const QString &filename, quint16 line)
 {
@@ -414,6 +478,15 @@ void QQmlJavaScriptExpressionGuard_callback(QQmlNotifierEndpoint *e, void **)
     QQmlJavaScriptExpression *expression =
         static_cast<QQmlJavaScriptExpressionGuard *>(e)->expression;
 
+    QQmlContextData *context = expression->m_context;
+    if (context && context->engine) {
+        QQmlEnginePrivate *ep = QQmlEnginePrivate::get(context->engine);
+        if (Q_UNLIKELY(ep->propertyUpdateBatchDepth)) {
+            ep->queueBatchedExpression(expression);
+            return;
+        }
+    }
+
     expression->expressionChanged();
 }
 
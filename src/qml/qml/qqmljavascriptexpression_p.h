@@ -157,19 +157,26 @@ protected:
 
     // We store some flag bits in the following flag pointers.
     //    activeGuards:flag1  - notifyOnValueChanged
-    //    activeGuards:flag2  - useSharedContext
+    //    activeGuards:flag2  - inPropertyUpdateBatch
     QBiPointer<QObject, DeleteWatcher> m_scopeObject;
     QForwardFieldList<QQmlJavaScriptExpressionGuard, &QQmlJavaScriptExpressionGuard::next> activeGuards;
 
     void setTranslationsCaptured(bool captured) { m_error.setFlagValue(captured); }
     bool translationsCaptured() const { return m_error.flag(); }
 
+    void setInPropertyUpdateBatch(bool inBatch) { activeGuards.setFlag2Value(inBatch); }
+    bool isInPropertyUpdateBatch() const { return activeGuards.flag2(); }
+
 private:
     friend class QQmlContextData;
+    friend class QQmlEngine;
+    friend class QQmlEnginePrivate;
     friend class QQmlPropertyCapture;
     friend void QQmlJavaScriptExpressionGuard_callback(QQmlNotifierEndpoint *, void **);
     friend class QQmlTranslationBinding;
 
+    bool evaluateAOTFunction(QV4::Function *v4Function, QV4::ReturnedValue *result);
+
     // m_error:flag1 translationsCapturedDuringEvaluation
     QFlagPointer<QQmlDelayedError> m_error;
 
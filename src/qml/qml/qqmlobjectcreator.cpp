@@ -952,7 +952,10 @@ bool QQmlObjectCreator::setPropertyBinding(const QQmlPropertyData *bindingProper
                 qmlBinding = QQmlBinding::createTranslationBinding(compilationUnit, binding, _scopeObject, context);
             } else {
                 QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[binding->value.compiledScriptIndex];
-                qmlBinding = QQmlBinding::create(targetProperty, runtimeFunction, _scopeObject, context, currentQmlContext());
+                if (const QV4::CompiledData::SimpleBinding *simpleBinding = compilationUnit->simpleBindingForFunction(binding->value.compiledScriptIndex))
+                    qmlBinding = QQmlBinding::createSimpleBinding(targetProperty, runtimeFunction, simpleBinding, _scopeObject, context, currentQmlContext());
+                else
+                    qmlBinding = QQmlBinding::create(targetProperty, runtimeFunction, _scopeObject, context, currentQmlContext());
             }
 
             auto bindingTarget = _bindingTarget;
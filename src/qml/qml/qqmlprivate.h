@@ -83,6 +83,8 @@
 QT_BEGIN_NAMESPACE
 
 class QQmlPropertyValueInterceptor;
+class QQmlContextData;
+class QJSEngine;
 
 namespace QQmlPrivate {
 struct CachedQmlUnit;
@@ -92,6 +94,7 @@ using QQmlAttachedPropertiesFunc = A *(*)(QObject *);
 
 namespace QV4 {
 struct ExecutionEngine;
+class ExecutableCompilationUnit;
 namespace CompiledData {
 struct Unit;
 struct CompilationUnit;
@@ -459,9 +462,44 @@ namespace QQmlPrivate
         const char *typeName;
     };
 
+    // Passed to the functions qmlcachegen compiles ahead of time. The functions read and write
+    // properties only through these accessors, which return false if a name or property doesn't
+    // resolve to the C++ type the function was compiled for. The function then returns false
+    // without side effects and the binding or signal handler is run as bytecode instead.
+    struct Q_QML_EXPORT AOTCompiledContext {
+        QQmlContextData *qmlContext;
+        QObject *qmlScopeObject;
+        QJSEngine *engine;
+        QV4::ExecutableCompilationUnit *compilationUnit;
+
+        // Names are looked up like QML does: ids first, then the properties of the scope and
+        // context objects, walking up the contexts.
+        bool lookupObject(uint nameIndex, QObject **value) const;
+        bool lookupNumber(uint nameIndex, double *value) const;
+        bool lookupBool(uint nameIndex, bool *value) const;
+        bool lookupString(uint nameIndex, QString *value) const;
+        // Returns the scope or context object a name refers to a property of.
+        bool lookupPropertyOwner(uint nameIndex, QObject **owner) const;
+
+        bool loadObject(QObject *object, uint nameIndex, QObject **value) const;
+        bool loadNumber(QObject *object, uint nameIndex, double *value) const;
+        bool loadBool(QObject *object, uint nameIndex, bool *value) const;
+        bool loadString(QObject *object, uint nameIndex, QString *value) const;
+
+        bool storeNumber(QObject *object, uint nameIndex, double value) const;
+        bool storeBool(QObject *object, uint nameIndex, bool value) const;
+        bool storeString(QObject *object, uint nameIndex, const QString &value) const;
+    };
+
+    struct AOTCompiledFunction {
+        int index; // of the function in the compilation unit, -1 terminates the table
+        int returnType; // QMetaType::Void for signal handlers
+        bool (*functionPtr)(const AOTCompiledContext *context, void *resultPtr);
+    };
+
     struct CachedQmlUnit {
         const QV4::CompiledData::Unit *qmlData;
-        void *unused1;
+        const AOTCompiledFunction *aotCompiledFunctions;
         void *unused2;
     };
 
@@ -72,7 +72,8 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         QQmlRefPointer<QV4::ExecutableCompilationUnit> unit
                 = QV4::ExecutableCompilationUnit::create();
         QString error;
-        if (unit->loadFromDisk(url(), data.sourceTimeStamp(), &error)) {
+        if (unit->loadFromDisk(url(), data.sourceTimeStamp(), &error,
+                               typeLoader()->engine()->handle()->lazyFunctionCompilationEnabled())) {
             initializeFromCompilationUnit(unit);
             return;
         } else {
@@ -110,6 +111,8 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         QmlIR::Document irUnit(isDebugging());
 
         irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
+        irUnit.jsModule.lazyFunctionCompilation
+                = typeLoader()->engine()->handle()->lazyFunctionCompilationEnabled();
 
         QmlIR::ScriptDirectivesCollector collector(&irUnit);
         irUnit.jsParserEngine.setDirectives(&collector);
@@ -136,7 +139,9 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         QString errorString;
         if (executableUnit->saveToDisk(url(), &errorString)) {
             QString error;
-            if (!executableUnit->loadFromDisk(url(), data.sourceTimeStamp(), &error)) {
+            if (!executableUnit->loadFromDisk(
+                        url(), data.sourceTimeStamp(), &error,
+                        typeLoader()->engine()->handle()->lazyFunctionCompilationEnabled())) {
                 // ignore error, keep using the in-memory compilation unit.
             }
         } else {
@@ -148,10 +153,10 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
     initializeFromCompilationUnit(executableUnit);
 }
 
-void QQmlScriptBlob::initializeFromCachedUnit(const QV4::CompiledData::Unit *unit)
+void QQmlScriptBlob::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit)
 {
     initializeFromCompilationUnit(QV4::ExecutableCompilationUnit::create(
-            QV4::CompiledData::CompilationUnit(unit, urlString(), finalUrlString())));
+            QV4::CompiledData::CompilationUnit(unit->qmlData, urlString(), finalUrlString())));
 }
 
 void QQmlScriptBlob::done()
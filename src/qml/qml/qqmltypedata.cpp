@@ -46,6 +46,7 @@
 #include <private/qqmlscriptblob_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qqmltypecompiler_p.h>
+#include <private/qqmltypeloaderparsejob_p.h>
 
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qcryptographichash.h>
@@ -120,7 +121,8 @@ bool QQmlTypeData::tryLoadFromDiskCache()
     QQmlRefPointer<QV4::ExecutableCompilationUnit> unit = QV4::ExecutableCompilationUnit::create();
     {
         QString error;
-        if (!unit->loadFromDisk(url(), m_backupSourceCode.sourceTimeStamp(), &error)) {
+        if (!unit->loadFromDisk(url(), m_backupSourceCode.sourceTimeStamp(), &error,
+                                v4->lazyFunctionCompilationEnabled())) {
             qCDebug(DBG_DISK_CACHE) << "Error loading" << urlString() << "from disk cache:" << error;
             return false;
         }
@@ -434,6 +436,9 @@ void QQmlTypeData::dataReceived(const SourceCodeData &data)
 {
     m_backupSourceCode = data;
 
+    // Unless loadFromSource() uses it, a document parsed in the background is of no use anymore.
+    auto dropParseJob = qScopeGuard([this] { typeLoader()->takeParseJob(url()); });
+
     if (tryLoadFromDiskCache())
         return;
 
@@ -456,35 +461,55 @@ void QQmlTypeData::dataReceived(const SourceCodeData &data)
     continueLoadFromIR();
 }
 
-void QQmlTypeData::initializeFromCachedUnit(const QV4::CompiledData::Unit *unit)
+void QQmlTypeData::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit)
 {
     m_document.reset(new QmlIR::Document(isDebugging()));
-    QQmlIRLoader loader(unit, m_document.data());
+    QQmlIRLoader loader(unit->qmlData, m_document.data());
     loader.load();
     m_document->jsModule.fileName = urlString();
     m_document->jsModule.finalUrl = finalUrlString();
-    m_document->javaScriptCompilationUnit = QV4::CompiledData::CompilationUnit(unit);
+    m_document->javaScriptCompilationUnit = QV4::CompiledData::CompilationUnit(unit->qmlData);
+    m_aotCompiledFunctions = unit->aotCompiledFunctions;
     continueLoadFromIR();
 }
 
 bool QQmlTypeData::loadFromSource()
 {
-    m_document.reset(new QmlIR::Document(isDebugging()));
-    m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
     QQmlEngine *qmlEngine = typeLoader()->engine();
-    QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
+    const bool lazyFunctionCompilation = qmlEngine->handle()->lazyFunctionCompilationEnabled();
+    bool parsed = false;
+    QList<QQmlJS::DiagnosticMessage> parseErrors;
+
+    const QSharedPointer<QQmlTypeLoaderParseJob> job = typeLoader()->takeParseJob(url());
+    if (job && job->waitForResult(m_backupSourceCode.sourceTimeStamp(), isDebugging(), lazyFunctionCompilation)) {
+        if (!job->sourceError.isEmpty()) {
+            setError(job->sourceError);
+            return false;
+        }
+        m_document.reset(job->document.take());
+        parsed = job->parsed;
+        parseErrors = job->errors;
+    } else {
+        m_document.reset(new QmlIR::Document(isDebugging()));
+        m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
+        m_document->jsModule.lazyFunctionCompilation = lazyFunctionCompilation;
+        QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
+
+        QString sourceError;
+        const QString source = m_backupSourceCode.readAll(&sourceError);
+        if (!sourceError.isEmpty()) {
+            setError(sourceError);
+            return false;
+        }
 
-    QString sourceError;
-    const QString source = m_backupSourceCode.readAll(&sourceError);
-    if (!sourceError.isEmpty()) {
-        setError(sourceError);
-        return false;
+        parsed = compiler.generateFromQml(source, finalUrlString(), m_document.data());
+        parseErrors = compiler.errors;
     }
 
-    if (!compiler.generateFromQml(source, finalUrlString(), m_document.data())) {
+    if (!parsed) {
         QList<QQmlError> errors;
-        errors.reserve(compiler.errors.count());
-        for (const QQmlJS::DiagnosticMessage &msg : qAsConst(compiler.errors)) {
+        errors.reserve(parseErrors.count());
+        for (const QQmlJS::DiagnosticMessage &msg : qAsConst(parseErrors)) {
             QQmlError e;
             e.setUrl(url());
             e.setLine(msg.line);
@@ -618,13 +643,18 @@ void QQmlTypeData::compile(const QQmlRefPointer<QQmlTypeNameCache> &typeNameCach
         return;
     }
 
+    // Type compilation keeps the functions of the cached unit at their indices.
+    if (typeRecompilation)
+        m_compiledData->aotCompiledFunctions = m_aotCompiledFunctions;
+
     const bool trySaveToDisk = (!diskCacheDisabled() || diskCacheForced())
             && !m_document->jsModule.debugMode && !typeRecompilation;
     if (trySaveToDisk) {
         QString errorString;
         if (m_compiledData->saveToDisk(url(), &errorString)) {
             QString error;
-            if (!m_compiledData->loadFromDisk(url(), m_backupSourceCode.sourceTimeStamp(), &error)) {
+            if (!m_compiledData->loadFromDisk(url(), m_backupSourceCode.sourceTimeStamp(), &error,
+                                              m_document->jsModule.lazyFunctionCompilation)) {
                 // ignore error, keep using the in-memory compilation unit.
             }
         } else {
@@ -657,6 +687,7 @@ void QQmlTypeData::resolveTypes()
     }
 
     // Lets handle resolved composite singleton types
+    QVector<TypeReference> compositeSingletons;
     const auto resolvedCompositeSingletons = m_importCache.resolvedCompositeSingletons();
     for (const QQmlImports::CompositeSingletonReference &csRef : resolvedCompositeSingletons) {
         TypeReference ref;
@@ -677,18 +708,13 @@ void QQmlTypeData::resolveTypes()
             return;
 
         if (ref.type.isCompositeSingleton()) {
-            ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
-            if (ref.typeData->status() == QQmlDataBlob::ResolvingDependencies) {
-                // TODO: give an error message? If so, we should record and show the path of the cycle.
-                continue;
-            }
-            addDependency(ref.typeData.data());
             ref.prefix = csRef.prefix;
-
-            m_compositeSingletons << ref;
+            compositeSingletons << ref;
         }
     }
 
+    QVector<QPair<int, TypeReference>> resolvedTypes;
+    resolvedTypes.reserve(m_typeReferences.count());
     for (QV4::CompiledData::TypeReferenceMap::ConstIterator unresolvedRef = m_typeReferences.constBegin(), end = m_typeReferences.constEnd();
          unresolvedRef != end; ++unresolvedRef) {
 
@@ -706,10 +732,6 @@ void QQmlTypeData::resolveTypes()
                          QQmlType::AnyRegistrationType) && reportErrors)
             return;
 
-        if (ref.type.isComposite()) {
-            ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
-            addDependency(ref.typeData.data());
-        }
         ref.majorVersion = majorVersion;
         ref.minorVersion = minorVersion;
 
@@ -718,7 +740,36 @@ void QQmlTypeData::resolveTypes()
 
         ref.needsCreation = unresolvedRef->needsCreation;
 
-        m_resolvedTypes.insert(unresolvedRef.key(), ref);
+        resolvedTypes.append(qMakePair(unresolvedRef.key(), ref));
+    }
+
+    // All the documents we depend on are known now. Let the type loader parse them in parallel
+    // before they are loaded one by one below.
+    for (const TypeReference &ref : qAsConst(compositeSingletons))
+        typeLoader()->parseInBackground(ref.type.sourceUrl());
+    for (const auto &resolvedType : qAsConst(resolvedTypes)) {
+        if (resolvedType.second.type.isComposite())
+            typeLoader()->parseInBackground(resolvedType.second.type.sourceUrl());
+    }
+
+    for (TypeReference &ref : compositeSingletons) {
+        ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
+        if (ref.typeData->status() == QQmlDataBlob::ResolvingDependencies) {
+            // TODO: give an error message? If so, we should record and show the path of the cycle.
+            continue;
+        }
+        addDependency(ref.typeData.data());
+
+        m_compositeSingletons << ref;
+    }
+
+    for (auto &resolvedType : resolvedTypes) {
+        TypeReference &ref = resolvedType.second;
+        if (ref.type.isComposite()) {
+            ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
+            addDependency(ref.typeData.data());
+        }
+        m_resolvedTypes.insert(resolvedType.first, ref);
     }
 
     // ### this allows enums to work without explicit import or instantiation of the type
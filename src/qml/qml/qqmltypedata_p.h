@@ -106,7 +106,7 @@ protected:
     void done() override;
     void completed() override;
     void dataReceived(const SourceCodeData &) override;
-    void initializeFromCachedUnit(const QV4::CompiledData::Unit *unit) override;
+    void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
     void allDependenciesDone() override;
     void downloadProgressChanged(qreal) override;
 
@@ -151,6 +151,8 @@ private:
     bool m_typesResolved:1;
 
     QQmlRefPointer<QV4::ExecutableCompilationUnit> m_compiledData;
+    // Functions qmlcachegen compiled to C++, if the document was loaded from a cached unit
+    const QQmlPrivate::AOTCompiledFunction *m_aotCompiledFunctions = nullptr;
 
     QList<TypeDataCallback *> m_callbacks;
 
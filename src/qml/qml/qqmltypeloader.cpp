@@ -43,8 +43,10 @@
 #include <private/qqmlprofiler_p.h>
 #include <private/qqmlscriptblob_p.h>
 #include <private/qqmltypedata_p.h>
+#include <private/qqmltypeloaderparsejob_p.h>
 #include <private/qqmltypeloaderqmldircontent_p.h>
 #include <private/qqmltypeloaderthread_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 
 #include <QtQml/qqmlabstracturlinterceptor.h>
 #include <QtQml/qqmlengine.h>
@@ -55,6 +57,7 @@
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 
 #include <functional>
 
@@ -67,6 +70,7 @@
 
 DEFINE_BOOL_CONFIG_OPTION(disableDiskCache, QML_DISABLE_DISK_CACHE);
 DEFINE_BOOL_CONFIG_OPTION(forceDiskCache, QML_FORCE_DISK_CACHE);
+DEFINE_BOOL_CONFIG_OPTION(parallelParsing, QML_PARALLEL_PARSING);
 
 QT_BEGIN_NAMESPACE
 
@@ -171,8 +175,8 @@ struct StaticLoader {
 };
 
 struct CachedLoader {
-    const QV4::CompiledData::Unit *unit;
-    CachedLoader(const QV4::CompiledData::Unit *unit) :  unit(unit) {}
+    const QQmlPrivate::CachedQmlUnit *unit;
+    CachedLoader(const QQmlPrivate::CachedQmlUnit *unit) :  unit(unit) {}
 
     void loadThread(QQmlTypeLoader *loader, QQmlDataBlob *blob) const
     {
@@ -244,7 +248,7 @@ void QQmlTypeLoader::loadWithStaticData(QQmlDataBlob *blob, const QByteArray &da
     doLoad(StaticLoader(data), blob, mode);
 }
 
-void QQmlTypeLoader::loadWithCachedUnit(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit, Mode mode)
+void QQmlTypeLoader::loadWithCachedUnit(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit, Mode mode)
 {
     doLoad(CachedLoader(unit), blob, mode);
 }
@@ -256,7 +260,7 @@ void QQmlTypeLoader::loadWithStaticDataThread(QQmlDataBlob *blob, const QByteArr
     setData(blob, data);
 }
 
-void QQmlTypeLoader::loadWithCachedUnitThread(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit)
+void QQmlTypeLoader::loadWithCachedUnitThread(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit)
 {
     ASSERT_LOADTHREAD();
 
@@ -443,7 +447,7 @@ void QQmlTypeLoader::setData(QQmlDataBlob *blob, const QQmlDataBlob::SourceCodeD
     blob->tryDone();
 }
 
-void QQmlTypeLoader::setCachedUnit(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit)
+void QQmlTypeLoader::setCachedUnit(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit)
 {
     QQmlCompilingProfiler prof(profiler(), blob);
 
@@ -747,7 +751,12 @@ QQmlTypeLoader::QQmlTypeLoader(QQmlEngine *engine)
     , m_thread(new QQmlTypeLoaderThread(this))
     , m_mutex(m_thread->mutex())
     , m_typeCacheTrimThreshold(TYPELOADER_MINIMUM_TRIM_THRESHOLD)
+    , m_parseThreads(nullptr)
 {
+#if QT_CONFIG(thread)
+    if (parallelParsing())
+        m_parseThreads = new QThreadPool;
+#endif
 }
 
 /*!
@@ -759,6 +768,10 @@ QQmlTypeLoader::~QQmlTypeLoader()
     // Stop the loader thread before releasing resources
     shutdownThread();
 
+    // Waits for any parse jobs still running
+    delete m_parseThreads;
+    m_parseThreads = nullptr;
+
     clearCache();
 
     invalidate();
@@ -801,12 +814,15 @@ QQmlRefPointer<QQmlTypeData> QQmlTypeLoader::getType(const QUrl &unNormalizedUrl
         // TODO: if (compiledData == 0), is it safe to omit this insertion?
         m_typeCache.insert(url, typeData);
         QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
-        if (const QV4::CompiledData::Unit *cachedUnit = QQmlMetaType::findCachedCompilationUnit(typeData->url(), &error)) {
+        if (const QQmlPrivate::CachedQmlUnit *cachedUnit = QQmlMetaType::findCachedCompilationUnit(typeData->url(), &error)) {
             QQmlTypeLoader::loadWithCachedUnit(typeData, cachedUnit, mode);
         } else {
             typeData->setCachedUnitStatus(error);
             QQmlTypeLoader::load(typeData, mode);
         }
+    } else if (m_parseThreads && typeData->isCompleteOrError()) {
+        // The document is loaded already, nobody is going to take the parse job.
+        m_parseJobs.remove(url);
     } else if ((mode == PreferSynchronous || mode == Synchronous) && QQmlFile::isSynchronous(url)) {
         // this was started Asynchronous, but we need to force Synchronous
         // completion now (if at all possible with this type of URL).
@@ -860,7 +876,7 @@ QQmlRefPointer<QQmlScriptBlob> QQmlTypeLoader::getScript(const QUrl &unNormalize
         m_scriptCache.insert(url, scriptBlob);
 
         QQmlMetaType::CachedUnitLookupError error;
-        if (const QV4::CompiledData::Unit *cachedUnit = QQmlMetaType::findCachedCompilationUnit(scriptBlob->url(), &error)) {
+        if (const QQmlPrivate::CachedQmlUnit *cachedUnit = QQmlMetaType::findCachedCompilationUnit(scriptBlob->url(), &error)) {
             QQmlTypeLoader::loadWithCachedUnit(scriptBlob, cachedUnit);
         } else {
             scriptBlob->setCachedUnitStatus(error);
@@ -871,6 +887,66 @@ QQmlRefPointer<QQmlScriptBlob> QQmlTypeLoader::getScript(const QUrl &unNormalize
     return scriptBlob;
 }
 
+/*!
+Starts reading and parsing the QML document at \a unNormalizedUrl on a separate thread, so that
+the result is ready when the QQmlTypeData for it receives its data. This has no effect unless
+the QML_PARALLEL_PARSING environment variable is set, and only applies to local files that are
+not loaded from a compilation unit or the disk cache.
+
+The loader must not be locked.
+*/
+void QQmlTypeLoader::parseInBackground(const QUrl &unNormalizedUrl)
+{
+    // Intercepted URLs may point to a different file
+    if (!m_parseThreads || m_engine->urlInterceptor())
+        return;
+
+    const QUrl url = normalize(unNormalizedUrl);
+    if (!QQmlFile::isSynchronous(url))
+        return;
+
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(url);
+    if (fileName.isEmpty())
+        return;
+
+    LockHolder<QQmlTypeLoader> holder(this);
+
+    if (m_typeCache.contains(url) || m_parseJobs.contains(url))
+        return;
+
+    QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
+    if (QQmlMetaType::findCachedCompilationUnit(url, &error))
+        return;
+
+    QV4::ExecutionEngine *v4 = m_engine->handle();
+    const bool debugMode = v4->debugger() != nullptr;
+    if ((!disableDiskCache() || forceDiskCache()) && !debugMode
+            && (QFile::exists(fileName + QLatin1Char('c'))
+                || QFile::exists(QV4::ExecutableCompilationUnit::localCacheFilePath(url)))) {
+        return;
+    }
+
+    QSharedPointer<QQmlTypeLoaderParseJob> job(new QQmlTypeLoaderParseJob(
+            fileName, url.toString(), debugMode, v4->lazyFunctionCompilationEnabled(),
+            v4->illegalNames()));
+    m_parseJobs.insert(url, job);
+    m_parseThreads->start(QRunnable::create([job]() { job->run(); }));
+}
+
+/*!
+Returns the job started by parseInBackground() for \a url, if any, and forgets about it.
+
+The loader must not be locked.
+*/
+QSharedPointer<QQmlTypeLoaderParseJob> QQmlTypeLoader::takeParseJob(const QUrl &url)
+{
+    if (!m_parseThreads)
+        return QSharedPointer<QQmlTypeLoaderParseJob>();
+
+    LockHolder<QQmlTypeLoader> holder(this);
+    return m_parseJobs.take(url);
+}
+
 /*!
 Returns a QQmlQmldirData for \a url.  The QQmlQmldirData may be cached.
 */
@@ -1145,6 +1221,7 @@ void QQmlTypeLoader::clearCache()
     m_qmldirCache.clear();
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
+    m_parseJobs.clear();
     QQmlMetaType::freeUnusedTypesAndCaches();
 }
 
@@ -60,6 +60,7 @@
 
 #include <QtCore/qcache.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qsharedpointer.h>
 
 #include <memory>
 
@@ -71,7 +72,9 @@ class QQmlTypeData;
 class QQmlExtensionInterface;
 class QQmlProfiler;
 class QQmlTypeLoaderThread;
+class QQmlTypeLoaderParseJob;
 class QQmlEngine;
+class QThreadPool;
 
 class Q_QML_PRIVATE_EXPORT QQmlTypeLoader
 {
@@ -151,6 +154,9 @@ public:
     QQmlRefPointer<QQmlScriptBlob> getScript(const QUrl &unNormalizedUrl);
     QQmlRefPointer<QQmlQmldirData> getQmldir(const QUrl &);
 
+    void parseInBackground(const QUrl &unNormalizedUrl);
+    QSharedPointer<QQmlTypeLoaderParseJob> takeParseJob(const QUrl &url);
+
     QString absoluteFilePath(const QString &path);
     bool fileExists(const QString &path, const QString &file);
     bool directoryExists(const QString &path);
@@ -169,7 +175,7 @@ public:
 
     void load(QQmlDataBlob *, Mode = PreferSynchronous);
     void loadWithStaticData(QQmlDataBlob *, const QByteArray &, Mode = PreferSynchronous);
-    void loadWithCachedUnit(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit, Mode mode = PreferSynchronous);
+    void loadWithCachedUnit(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit, Mode mode = PreferSynchronous);
 
     QQmlEngine *engine() const;
     void initializeEngine(QQmlExtensionInterface *, const char *);
@@ -195,7 +201,7 @@ private:
 
     void loadThread(QQmlDataBlob *);
     void loadWithStaticDataThread(QQmlDataBlob *, const QByteArray &);
-    void loadWithCachedUnitThread(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit);
+    void loadWithCachedUnitThread(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit);
 #if QT_CONFIG(qml_network)
     void networkReplyFinished(QNetworkReply *);
     void networkReplyProgress(QNetworkReply *, qint64, qint64);
@@ -206,7 +212,7 @@ private:
     void setData(QQmlDataBlob *, const QByteArray &);
     void setData(QQmlDataBlob *, const QString &fileName);
     void setData(QQmlDataBlob *, const QQmlDataBlob::SourceCodeData &);
-    void setCachedUnit(QQmlDataBlob *blob, const QV4::CompiledData::Unit *unit);
+    void setCachedUnit(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit);
 
     template<typename T>
     struct TypedCallback
@@ -248,6 +254,9 @@ private:
     ImportDirCache m_importDirCache;
     ImportQmlDirCache m_importQmlDirCache;
 
+    QThreadPool *m_parseThreads;
+    QHash<QUrl, QSharedPointer<QQmlTypeLoaderParseJob>> m_parseJobs;
+
     template<typename Loader>
     void doLoad(const Loader &loader, QQmlDataBlob *blob, Mode mode);
     void updateTypeCacheTrimThreshold();
@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qqmltypeloaderparsejob_p.h>
+#include <private/qqmldatablob_p.h>
+#include <private/qqmlirbuilder_p.h>
+
+QT_BEGIN_NAMESPACE
+
+QQmlTypeLoaderParseJob::QQmlTypeLoaderParseJob(
+        const QString &fileName, const QString &finalUrl, bool debugMode,
+        bool lazyFunctionCompilation, const QSet<QString> &illegalNames)
+    : m_fileName(fileName)
+    , m_finalUrl(finalUrl)
+    , m_illegalNames(illegalNames)
+    , m_debugMode(debugMode)
+    , m_lazyFunctionCompilation(lazyFunctionCompilation)
+{
+}
+
+QQmlTypeLoaderParseJob::~QQmlTypeLoaderParseJob() = default;
+
+void QQmlTypeLoaderParseJob::run()
+{
+    QQmlDataBlob::SourceCodeData data;
+    data.fileInfo = QFileInfo(m_fileName);
+    m_sourceTimeStamp = data.sourceTimeStamp();
+
+    const QString source = data.readAll(&sourceError);
+    if (sourceError.isEmpty()) {
+        document.reset(new QmlIR::Document(m_debugMode));
+        document->jsModule.sourceTimeStamp = m_sourceTimeStamp;
+        document->jsModule.lazyFunctionCompilation = m_lazyFunctionCompilation;
+        QmlIR::IRBuilder compiler(m_illegalNames);
+        parsed = compiler.generateFromQml(source, m_finalUrl, document.data());
+        errors = compiler.errors;
+    }
+
+    m_finished.release();
+}
+
+bool QQmlTypeLoaderParseJob::waitForResult(const QDateTime &sourceTimeStamp, bool debugMode,
+                                           bool lazyFunctionCompilation)
+{
+    m_finished.acquire();
+    m_finished.release();
+
+    return m_sourceTimeStamp == sourceTimeStamp && m_debugMode == debugMode
+            && m_lazyFunctionCompilation == lazyFunctionCompilation;
+}
+
+QT_END_NAMESPACE
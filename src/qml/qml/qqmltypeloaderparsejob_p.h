@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLTYPELOADERPARSEJOB_P_H
+#define QQMLTYPELOADERPARSEJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmljsdiagnosticmessage_p.h>
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QmlIR {
+struct Document;
+}
+
+// Reads and parses a QML file on one of the type loader's parse threads, ahead of the
+// QQmlTypeData that needs it. The result is only used if the file has not changed in the meantime.
+class QQmlTypeLoaderParseJob
+{
+public:
+    QQmlTypeLoaderParseJob(const QString &fileName, const QString &finalUrl, bool debugMode,
+                           bool lazyFunctionCompilation, const QSet<QString> &illegalNames);
+    ~QQmlTypeLoaderParseJob();
+
+    void run();
+
+    // Waits for run() to finish. Returns false if the result is not valid for a document
+    // with the given properties.
+    bool waitForResult(const QDateTime &sourceTimeStamp, bool debugMode, bool lazyFunctionCompilation);
+
+    QString sourceError;
+    QScopedPointer<QmlIR::Document> document;
+    bool parsed = false;
+    QList<QQmlJS::DiagnosticMessage> errors;
+
+private:
+    const QString m_fileName;
+    const QString m_finalUrl;
+    const QSet<QString> m_illegalNames;
+    const bool m_debugMode;
+    const bool m_lazyFunctionCompilation;
+    QDateTime m_sourceTimeStamp;
+    QSemaphore m_finished;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLTYPELOADERPARSEJOB_P_H
@@ -66,6 +66,7 @@ enum Message {
     SceneGraphFrame,
     MemoryAllocation,
     DebugMessage,
+    HeapSnapshot, // chunk of a JSON lines heap snapshot
 
     MaximumMessage
 };
@@ -123,7 +124,8 @@ enum SceneGraphFrameType {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    SampledAllocation
 };
 
 enum ProfileFeature {
@@ -139,6 +141,7 @@ enum ProfileFeature {
     ProfileHandlingSignal,
     ProfileInputEvents,
     ProfileDebugMessages,
+    ProfileHeapSnapshots,
 
     MaximumProfileFeature
 };
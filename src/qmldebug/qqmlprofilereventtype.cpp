@@ -84,6 +84,8 @@ ProfileFeature QQmlProfilerEventType::feature() const
         return ProfileMemory;
     case DebugMessage:
         return ProfileDebugMessages;
+    case HeapSnapshot:
+        return ProfileHeapSnapshots;
     default:
         break;
     }
@@ -158,12 +158,32 @@ QDataStream &operator>>(QDataStream &stream, QQmlProfilerTypedEvent &event)
         qint64 delta;
         stream >> delta;
 
+        QQmlProfilerEventLocation location;
+        QString name;
+        if (subtype == SampledAllocation && !stream.atEnd()) {
+            QString filename;
+            qint32 line = 0;
+            qint32 column = 0;
+            stream >> filename >> line >> column >> name;
+            location = QQmlProfilerEventLocation(filename, line, column);
+        }
+
         event.type = QQmlProfilerEventType(
                     static_cast<Message>(messageType),
-                    MaximumRangeType, subtype);
+                    MaximumRangeType, subtype, location, name);
         event.event.setNumbers<qint64>({delta});
         break;
     }
+    case HeapSnapshot: {
+        QByteArray chunk;
+        stream >> chunk;
+
+        event.type = QQmlProfilerEventType(
+                    static_cast<Message>(messageType),
+                    MaximumRangeType, subtype);
+        event.event.setNumbers<QByteArray, qint8>(chunk);
+        break;
+    }
     case RangeStart: {
         if (!stream.atEnd()) {
             qint64 typeId;
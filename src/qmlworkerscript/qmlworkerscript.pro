@@ -5,6 +5,7 @@ DEFINES += QT_NO_URL_CAST_FROM_STRING QT_NO_INTEGER_EVENT_COORDINATES QT_NO_FORE
 
 HEADERS += \
     qqmlworkerscriptmodule_p.h \
+    qquickworkerpool_p.h \
     qquickworkerscript_p.h \
     qtqmlworkerscriptglobal.h \
     qtqmlworkerscriptglobal_p.h \
@@ -12,6 +13,7 @@ HEADERS += \
 
 SOURCES += \
     qqmlworkerscriptmodule.cpp \
+    qquickworkerpool.cpp \
     qquickworkerscript.cpp \
     qv4serialize.cpp
 
@@ -39,13 +39,14 @@
 
 #include "qqmlworkerscriptmodule_p.h"
 #include "qquickworkerscript_p.h"
+#include "qquickworkerpool_p.h"
 
 QT_BEGIN_NAMESPACE
 
 void QQmlWorkerScriptModule::defineModule()
 {
     const char uri[] = "QtQml.WorkerScript";
-    qmlRegisterTypesAndRevisions<QQuickWorkerScript>(uri, 2);
+    qmlRegisterTypesAndRevisions<QQuickWorkerScript, QQuickWorkerPool>(uri, 2);
 }
 
 QT_END_NAMESPACE
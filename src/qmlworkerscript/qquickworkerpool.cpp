@@ -0,0 +1,409 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickworkerpool_p.h"
+
+#include <private/qqmlengine_p.h>
+#include <private/qv4arrayobject_p.h>
+#include <private/qv4scopedvalue_p.h>
+
+#include <QtQml/qqmlcontext.h>
+#include <QtQml/qqmlinfo.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickWorkerPoolWorker : public QQuickWorkerScript
+{
+public:
+    QQuickWorkerPoolWorker(QQuickWorkerPool *pool)
+        : QQuickWorkerScript(pool), m_pool(pool)
+    {
+    }
+
+protected:
+    void reportError(const QQmlError &error) override
+    {
+        QQuickWorkerScript::reportError(error);
+        // The job that caused the error will not send a reply. Complete it
+        // with an undefined result so that its batch can still finish.
+        m_pool->jobDone(this, QJSValue());
+    }
+
+    void reportLoadError(const QQmlError &error) override
+    {
+        QQuickWorkerScript::reportError(error);
+        m_pool->workerFailed(this);
+    }
+
+private:
+    QQuickWorkerPool *m_pool;
+};
+
+/*!
+    \qmltype WorkerPool
+    \instantiates QQuickWorkerPool
+    \ingroup qtquick-threading
+    \inqmlmodule QtQml.WorkerScript
+    \since 6.0
+    \brief Distributes a batch of jobs over several worker scripts.
+
+    WorkerPool runs \l count instances of the same worker script, each in its
+    own JavaScript engine, and spreads the messages passed to \l dispatch()
+    over them. Worker scripts are hosted by a shared pool of threads, so the
+    jobs of one batch run in parallel when there are enough cores.
+
+    The worker script has to reply to every message it receives with exactly
+    one call to \c WorkerScript.sendMessage(). The replies are collected, in
+    the order of the original messages, and passed to the \l finished()
+    signal once all jobs of a batch have completed. If a job throws an
+    exception its result is \c undefined. If the script cannot be loaded,
+    the error is reported and the jobs handed to the failed workers, as well
+    as those left without any working worker, complete with \c undefined
+    results.
+
+    \qml
+    WorkerPool {
+        id: pool
+        source: "hash.mjs"
+        onFinished: (results) => console.log("hashed", results.length, "chunks")
+    }
+
+    // ...
+    pool.dispatch(chunks)
+    \endqml
+
+    Each worker only receives a new job after replying to the previous one,
+    so that slow jobs do not hold up a queue of others behind them.
+
+    \sa WorkerScript
+*/
+QQuickWorkerPool::QQuickWorkerPool(QObject *parent)
+    : QObject(parent), m_count(qMax(1, QThread::idealThreadCount())), m_nextBatch(0),
+      m_componentComplete(true)
+{
+}
+
+QQuickWorkerPool::~QQuickWorkerPool()
+{
+}
+
+/*!
+    \qmlproperty url WorkerPool::source
+
+    This holds the url of the JavaScript file that implements the
+    \tt WorkerScript.onMessage() handler run by each worker.
+
+    \sa WorkerScript::source
+*/
+QUrl QQuickWorkerPool::source() const
+{
+    return m_source;
+}
+
+void QQuickWorkerPool::setSource(const QUrl &source)
+{
+    if (m_source == source)
+        return;
+
+    m_source = source;
+
+    for (WorkerState &state : m_workers) {
+        state.failed = false;
+        state.worker->setSource(m_source);
+    }
+
+    emit sourceChanged();
+}
+
+/*!
+    \qmlproperty int WorkerPool::count
+
+    This holds the number of workers in the pool. It defaults to the number
+    of processor cores.
+
+    When the count is reduced while jobs are running, the surplus workers are
+    removed as soon as they have completed their current job.
+*/
+int QQuickWorkerPool::count() const
+{
+    return m_count;
+}
+
+void QQuickWorkerPool::setCount(int count)
+{
+    count = qMax(1, count);
+    if (m_count == count)
+        return;
+
+    m_count = count;
+    updateWorkers();
+    schedule();
+
+    emit countChanged();
+    failUnservedJobs();
+}
+
+/*!
+    \qmlproperty int WorkerPool::pending
+    \readonly
+
+    This holds the number of dispatched jobs that have not completed yet.
+*/
+int QQuickWorkerPool::pending() const
+{
+    int pending = m_queue.count();
+    for (const WorkerState &state : qAsConst(m_workers)) {
+        if (state.batch != -1)
+            ++pending;
+    }
+    return pending;
+}
+
+/*!
+    \qmlmethod int WorkerPool::dispatch(array messages, array transfer)
+
+    Queues one job for each element of \a messages and returns the number of
+    the batch they belong to. The messages are copied when dispatch() is
+    called, with the same restrictions as for WorkerScript::sendMessage().
+
+    ArrayBuffers listed in the optional \a transfer array are handed over to
+    the worker that receives the message referencing them, instead of being
+    copied.
+
+    \sa finished()
+*/
+void QQuickWorkerPool::dispatch(QQmlV4Function *args)
+{
+    QQmlEngine *engine = qmlEngine(this);
+    if (!engine) {
+        qmlWarning(this) << "dispatch() called without qmlEngine() set";
+        return;
+    }
+
+    QV4::Scope scope(args->v4engine());
+    QV4::ScopedArrayObject messages(scope, args->length() != 0 ? (*args)[0] : QV4::Encode::undefined());
+    if (!messages) {
+        qmlWarning(this) << "dispatch() expects an array of messages";
+        return;
+    }
+    QV4::ScopedValue transfer(scope, args->length() > 1 ? (*args)[1] : QV4::Encode::undefined());
+
+    const int batch = m_nextBatch++;
+    const uint length = messages->getLength();
+    QJSValue results = engine->newArray(length);
+
+    if (length == 0) {
+        args->setReturnValue(QV4::Encode(batch));
+        emit finished(results, batch);
+        return;
+    }
+
+    m_batches.insert(batch, Batch { results, int(length) });
+
+    QVector<QV4::Serialize::Message> serialized
+            = QV4::Serialize::serializeEach(messages, scope.engine, transfer);
+    for (int i = 0; i < serialized.count(); ++i)
+        m_queue.enqueue(Job { batch, i, std::move(serialized[i]) });
+
+    args->setReturnValue(QV4::Encode(batch));
+
+    updateWorkers();
+    schedule();
+
+    emit pendingChanged();
+    failUnservedJobs();
+}
+
+/*!
+    \qmlsignal WorkerPool::finished(array results, int batch)
+
+    This signal is emitted when all jobs of the batch numbered \a batch have
+    completed. \a results holds the replies of the worker scripts, in the
+    order of the messages passed to dispatch().
+
+    The corresponding handler is \c onFinished.
+*/
+
+void QQuickWorkerPool::classBegin()
+{
+    m_componentComplete = false;
+}
+
+void QQuickWorkerPool::componentComplete()
+{
+    m_componentComplete = true;
+    updateWorkers();
+    schedule();
+}
+
+void QQuickWorkerPool::updateWorkers()
+{
+    if (!m_componentComplete)
+        return;
+
+    while (m_workers.count() < m_count) {
+        WorkerState state;
+        state.worker = new QQuickWorkerPoolWorker(this);
+        QQmlEngine::setContextForObject(state.worker, qmlContext(this));
+        QQuickWorkerPoolWorker *worker = state.worker;
+        connect(worker, &QQuickWorkerScript::message, this, [this, worker](const QJSValue &result) {
+            jobDone(worker, result);
+        });
+        worker->setSource(m_source);
+        m_workers.append(state);
+    }
+
+    // Workers are removed from the end, once they are idle. This may be
+    // called from within a worker's event handler, hence deleteLater().
+    while (m_workers.count() > m_count && m_workers.last().batch == -1) {
+        QQuickWorkerPoolWorker *worker = m_workers.takeLast().worker;
+        disconnect(worker, nullptr, this, nullptr);
+        worker->deleteLater();
+    }
+}
+
+void QQuickWorkerPool::schedule()
+{
+    const int available = qMin(m_workers.count(), m_count);
+    for (int i = 0; i < available && !m_queue.isEmpty(); ++i) {
+        WorkerState &state = m_workers[i];
+        if (state.batch != -1 || state.failed)
+            continue;
+
+        Job job = m_queue.dequeue();
+        state.batch = job.batch;
+        state.index = job.index;
+        state.worker->sendSerializedMessage(std::move(job.message));
+    }
+}
+
+// Completes the queued jobs once none of the available workers could load
+// the script, as nothing would ever run them.
+void QQuickWorkerPool::failUnservedJobs()
+{
+    if (m_queue.isEmpty())
+        return;
+
+    const int available = qMin(m_workers.count(), m_count);
+    for (int i = 0; i < available; ++i) {
+        if (!m_workers.at(i).failed)
+            return;
+    }
+
+    QVector<QPair<int, QJSValue>> finishedBatches;
+    while (!m_queue.isEmpty()) {
+        const Job job = m_queue.dequeue();
+        QJSValue results;
+        if (completeJob(job.batch, job.index, QJSValue(), &results))
+            finishedBatches.append(qMakePair(job.batch, results));
+    }
+
+    emit pendingChanged();
+    for (const auto &batch : qAsConst(finishedBatches))
+        emit finished(batch.second, batch.first);
+}
+
+// Stores the result of a job and returns true, with the results of the batch
+// in \a results, if it was the last job of its batch.
+bool QQuickWorkerPool::completeJob(int batch, int index, const QJSValue &result,
+                                   QJSValue *results)
+{
+    auto it = m_batches.find(batch);
+    Q_ASSERT(it != m_batches.end());
+    it->results.setProperty(quint32(index), result);
+    if (--it->remaining != 0)
+        return false;
+
+    *results = it->results;
+    m_batches.erase(it);
+    return true;
+}
+
+void QQuickWorkerPool::jobDone(QQuickWorkerPoolWorker *worker, const QJSValue &result)
+{
+    auto state = std::find_if(m_workers.begin(), m_workers.end(), [worker](const WorkerState &state) {
+        return state.worker == worker;
+    });
+    if (state == m_workers.end() || state->batch == -1) {
+        // A worker that failed to load may still answer the job that was
+        // already completed on its behalf.
+        if (state != m_workers.end() && !state->failed)
+            qmlWarning(this) << "Ignoring a message that does not answer a job";
+        return;
+    }
+
+    const int batch = state->batch;
+    const int index = state->index;
+    state->batch = -1;
+    state->index = -1;
+
+    QJSValue results;
+    completeJob(batch, index, result, &results);
+
+    // Keep the workers busy before running any handlers.
+    updateWorkers();
+    schedule();
+
+    emit pendingChanged();
+    if (!results.isUndefined())
+        emit finished(results, batch);
+}
+
+void QQuickWorkerPool::workerFailed(QQuickWorkerPoolWorker *worker)
+{
+    auto state = std::find_if(m_workers.begin(), m_workers.end(), [worker](const WorkerState &state) {
+        return state.worker == worker;
+    });
+    if (state == m_workers.end())
+        return;
+
+    state->failed = true;
+
+    // The job the worker was given before its script failed is not run.
+    if (state->batch != -1)
+        jobDone(worker, QJSValue());
+
+    failUnservedJobs();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qquickworkerpool_p.cpp"
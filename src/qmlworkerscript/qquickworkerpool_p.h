@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKWORKERPOOL_P_H
+#define QQUICKWORKERPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qquickworkerscript_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qqueue.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickWorkerPoolWorker;
+class Q_AUTOTEST_EXPORT QQuickWorkerPool : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(int count READ count WRITE setCount NOTIFY countChanged)
+    Q_PROPERTY(int pending READ pending NOTIFY pendingChanged)
+    QML_NAMED_ELEMENT(WorkerPool)
+    QML_ADDED_IN_MINOR_VERSION(15)
+
+    Q_INTERFACES(QQmlParserStatus)
+public:
+    QQuickWorkerPool(QObject *parent = nullptr);
+    ~QQuickWorkerPool();
+
+    QUrl source() const;
+    void setSource(const QUrl &);
+
+    int count() const;
+    void setCount(int);
+
+    int pending() const;
+
+public Q_SLOTS:
+    void dispatch(QQmlV4Function *);
+
+Q_SIGNALS:
+    void sourceChanged();
+    void countChanged();
+    void pendingChanged();
+    void finished(const QJSValue &results, int batch);
+
+protected:
+    void classBegin() override;
+    void componentComplete() override;
+
+private:
+    friend class QQuickWorkerPoolWorker;
+
+    struct Job {
+        int batch;
+        int index;
+        QV4::Serialize::Message message;
+    };
+
+    struct Batch {
+        QJSValue results;
+        int remaining;
+    };
+
+    struct WorkerState {
+        QQuickWorkerPoolWorker *worker = nullptr;
+        int batch = -1;
+        int index = -1;
+        bool failed = false;
+    };
+
+    void updateWorkers();
+    void schedule();
+    void failUnservedJobs();
+    bool completeJob(int batch, int index, const QJSValue &result, QJSValue *results);
+    void jobDone(QQuickWorkerPoolWorker *worker, const QJSValue &result);
+    void workerFailed(QQuickWorkerPoolWorker *worker);
+
+    QVector<WorkerState> m_workers;
+    QQueue<Job> m_queue;
+    QHash<int, Batch> m_batches;
+    QUrl m_source;
+    int m_count;
+    int m_nextBatch;
+    bool m_componentComplete;
+};
+
+QT_END_NAMESPACE
+
+QML_DECLARE_TYPE(QQuickWorkerPool)
+
+#endif // QQUICKWORKERPOOL_P_H
@@ -72,15 +72,15 @@ class WorkerDataEvent : public QEvent
 public:
     enum Type { WorkerData = QEvent::User };
 
-    WorkerDataEvent(int workerId, const QByteArray &data);
+    WorkerDataEvent(int workerId, QV4::Serialize::Message data);
     virtual ~WorkerDataEvent();
 
     int workerId() const;
-    QByteArray data() const;
+    QV4::Serialize::Message &data();
 
 private:
     int m_id;
-    QByteArray m_data;
+    QV4::Serialize::Message m_data;
 };
 
 class WorkerLoadEvent : public QEvent
@@ -116,12 +116,14 @@ class WorkerErrorEvent : public QEvent
 public:
     enum Type { WorkerError = WorkerRemoveEvent::WorkerRemove + 1 };
 
-    WorkerErrorEvent(const QQmlError &error);
+    WorkerErrorEvent(const QQmlError &error, bool loadError = false);
 
     QQmlError error() const;
+    bool isLoadError() const;
 
 private:
     QQmlError m_error;
+    bool m_loadError;
 };
 
 struct WorkerScript : public QV4::ExecutionEngine {
@@ -162,9 +164,9 @@ protected:
     bool event(QEvent *) override;
 
 private:
-    void processMessage(int, const QByteArray &);
+    void processMessage(int, QV4::Serialize::Message &);
     void processLoad(int, const QUrl &);
-    void reportScriptException(WorkerScript *, const QQmlError &error);
+    void reportScriptException(WorkerScript *, const QQmlError &error, bool loadError = false);
 };
 
 QQuickWorkerScriptEnginePrivate::QQuickWorkerScriptEnginePrivate(QQmlEngine *engine)
@@ -179,11 +181,12 @@ QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(const QV4
     WorkerScript *script = static_cast<WorkerScript *>(scope.engine);
 
     QV4::ScopedValue v(scope, argc > 0 ? argv[0] : QV4::Value::undefinedValue());
-    QByteArray data = QV4::Serialize::serialize(v, scope.engine);
+    QV4::ScopedValue transfer(scope, argc > 1 ? argv[1] : QV4::Value::undefinedValue());
+    QV4::Serialize::Message data = QV4::Serialize::serialize(v, scope.engine, transfer);
 
     QMutexLocker locker(&script->p->m_lock);
     if (script && script->owner)
-        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, data));
+        QCoreApplication::postEvent(script->owner, new WorkerDataEvent(0, std::move(data)));
 
     return QV4::Encode::undefined();
 }
@@ -215,7 +218,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
     }
 }
 
-void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEnginePrivate::processMessage(int id, QV4::Serialize::Message &data)
 {
     WorkerScript *script = workers.value(id);
     if (!script)
@@ -270,8 +273,11 @@ void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
         QScopedPointer<QV4::Script> program;
         program.reset(QV4::Script::createFromFileOrCache(script, /*qmlContext*/nullptr, fileName, url, &error));
         if (program.isNull()) {
-            if (!error.isEmpty())
-                qWarning().nospace() << error;
+            QQmlError loadError;
+            loadError.setUrl(url);
+            loadError.setDescription(error.isEmpty() ? QStringLiteral("Could not load script file")
+                                                     : error);
+            reportScriptException(script, loadError, true);
             return;
         }
 
@@ -281,20 +287,21 @@ void QQuickWorkerScriptEnginePrivate::processLoad(int id, const QUrl &url)
 
     if (script->hasException) {
         QQmlError error = script->catchExceptionAsQmlError();
-        reportScriptException(script, error);
+        reportScriptException(script, error, true);
     }
 }
 
 void QQuickWorkerScriptEnginePrivate::reportScriptException(WorkerScript *script,
-                                                                  const QQmlError &error)
+                                                                  const QQmlError &error,
+                                                                  bool loadError)
 {
     QMutexLocker locker(&script->p->m_lock);
     if (script->owner)
-        QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error));
+        QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error, loadError));
 }
 
-WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data)
-: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data)
+WorkerDataEvent::WorkerDataEvent(int workerId, QV4::Serialize::Message data)
+: QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(std::move(data))
 {
 }
 
@@ -307,7 +314,7 @@ int WorkerDataEvent::workerId() const
     return m_id;
 }
 
-QByteArray WorkerDataEvent::data() const
+QV4::Serialize::Message &WorkerDataEvent::data()
 {
     return m_data;
 }
@@ -337,8 +344,8 @@ int WorkerRemoveEvent::workerId() const
     return m_id;
 }
 
-WorkerErrorEvent::WorkerErrorEvent(const QQmlError &error)
-: QEvent((QEvent::Type)WorkerError), m_error(error)
+WorkerErrorEvent::WorkerErrorEvent(const QQmlError &error, bool loadError)
+: QEvent((QEvent::Type)WorkerError), m_error(error), m_loadError(loadError)
 {
 }
 
@@ -347,6 +354,11 @@ QQmlError WorkerErrorEvent::error() const
     return m_error;
 }
 
+bool WorkerErrorEvent::isLoadError() const
+{
+    return m_loadError;
+}
+
 QQuickWorkerScriptEngine::QQuickWorkerScriptEngine(QQmlEngine *parent)
 : QThread(parent), d(new QQuickWorkerScriptEnginePrivate(parent))
 {
@@ -396,6 +408,7 @@ int QQuickWorkerScriptEngine::registerWorkerScript(QQuickWorkerScript *owner)
     WorkerScript *script = new WorkerScript(d->m_nextId++, d);
 
     script->owner = owner;
+    ++m_workerCount;
 
     d->m_lock.lock();
     d->workers.insert(script->id, script);
@@ -408,6 +421,7 @@ void QQuickWorkerScriptEngine::removeWorkerScript(int id)
 {
     if (WorkerScript *script = d->workers.value(id)) {
         script->owner = nullptr;
+        --m_workerCount;
         QCoreApplication::postEvent(d, new WorkerRemoveEvent(id));
     }
 }
@@ -417,9 +431,9 @@ void QQuickWorkerScriptEngine::executeUrl(int id, const QUrl &url)
     QCoreApplication::postEvent(d, new WorkerLoadEvent(id, url));
 }
 
-void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEngine::sendMessage(int id, QV4::Serialize::Message data)
 {
-    QCoreApplication::postEvent(d, new WorkerDataEvent(id, data));
+    QCoreApplication::postEvent(d, new WorkerDataEvent(id, std::move(data)));
 }
 
 void QQuickWorkerScriptEngine::run()
@@ -436,6 +450,54 @@ void QQuickWorkerScriptEngine::run()
     d->workers.clear();
 }
 
+/*
+    Worker scripts are spread over a small pool of threads rather than all
+    sharing one. A new thread is only started when every existing one is
+    already hosting a worker, up to the maximum thread count. That defaults
+    to QThread::idealThreadCount() and can be overridden with the
+    QML_WORKER_SCRIPT_THREADS environment variable.
+*/
+QQuickWorkerScriptEnginePool::QQuickWorkerScriptEnginePool(QQmlEngine *parent)
+    : QObject(parent), m_qmlEngine(parent), m_maximumThreadCount(QThread::idealThreadCount())
+{
+    bool ok = false;
+    const int threads = qEnvironmentVariableIntValue("QML_WORKER_SCRIPT_THREADS", &ok);
+    if (ok)
+        m_maximumThreadCount = threads;
+    m_maximumThreadCount = qMax(1, m_maximumThreadCount);
+}
+
+QQuickWorkerScriptEnginePool *QQuickWorkerScriptEnginePool::get(QQmlEngine *engine)
+{
+    QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(engine);
+    if (!enginePrivate->workerScriptEnginePool)
+        enginePrivate->workerScriptEnginePool = new QQuickWorkerScriptEnginePool(engine);
+    return static_cast<QQuickWorkerScriptEnginePool *>(enginePrivate->workerScriptEnginePool);
+}
+
+void QQuickWorkerScriptEnginePool::setMaximumThreadCount(int count)
+{
+    // Threads that are already running are kept; the limit only affects new ones.
+    m_maximumThreadCount = qMax(1, count);
+}
+
+QQuickWorkerScriptEngine *QQuickWorkerScriptEnginePool::engineForNewWorker()
+{
+    QQuickWorkerScriptEngine *leastLoaded = nullptr;
+    for (QQuickWorkerScriptEngine *engine : qAsConst(m_engines)) {
+        if (!leastLoaded || engine->workerCount() < leastLoaded->workerCount())
+            leastLoaded = engine;
+    }
+
+    if (!leastLoaded || (leastLoaded->workerCount() > 0 && m_engines.count() < m_maximumThreadCount)) {
+        // The engines are children of the QQmlEngine, like the single worker
+        // thread used to be, so that they are torn down along with it.
+        leastLoaded = new QQuickWorkerScriptEngine(m_qmlEngine);
+        m_engines.append(leastLoaded);
+    }
+
+    return leastLoaded;
+}
 
 /*!
     \qmltype WorkerScript
@@ -476,6 +538,12 @@ void QQuickWorkerScriptEngine::run()
     isolation and thread-safety. If the impact of that results in a memory consumption that is too
     high for your environment, then consider sharing a WorkerScript element.
 
+    WorkerScript elements are distributed over a pool of threads. A new thread
+    is started whenever all existing threads already run a worker script, up to
+    QThread::idealThreadCount() threads. The limit can be changed by setting the
+    \c QML_WORKER_SCRIPT_THREADS environment variable. Use WorkerPool to spread
+    a batch of independent jobs over several workers.
+
     \section3 Restrictions
 
     Since the \c WorkerScript.onMessage() function is run in a separate thread, the
@@ -491,7 +559,7 @@ void QQuickWorkerScriptEngine::run()
     Worker scripts that are plain JavaScript sources can not use \l {qtqml-javascript-imports.html}{.import} syntax.
     Scripts that are ECMAScript modules can freely use import and export statements.
 
-    \sa {Qt Quick Examples - Threading},
+    \sa WorkerPool, {Qt Quick Examples - Threading},
         {Threaded ListModel Example}
 */
 QQuickWorkerScript::QQuickWorkerScript(QObject *parent)
@@ -533,7 +601,7 @@ void QQuickWorkerScript::setSource(const QUrl &source)
 }
 
 /*!
-    \qmlmethod WorkerScript::sendMessage(jsobject message)
+    \qmlmethod WorkerScript::sendMessage(jsobject message, array transfer)
 
     Sends the given \a message to a worker script handler in another
     thread. The other worker script handler can receive this message
@@ -545,12 +613,21 @@ void QQuickWorkerScript::setSource(const QUrl &source)
     \list
     \li boolean, number, string
     \li JavaScript objects and arrays
+    \li ArrayBuffer, SharedArrayBuffer and typed array objects
     \li ListModel objects (any other type of QObject* is not allowed)
     \endlist
 
     All objects and arrays are copied to the \c message. With the exception
-    of ListModel objects, any modifications by the other thread to an object
-    passed in \c message will not be reflected in the original object.
+    of ListModel objects and SharedArrayBuffers, any modifications by the other
+    thread to an object passed in \c message will not be reflected in the
+    original object.
+
+    ArrayBuffers listed in the optional \a transfer array are not copied.
+    Their memory is handed over to the receiving thread, and the buffers
+    become detached (zero-length) in the sending thread. SharedArrayBuffers
+    are always shared between the threads, and can be synchronized with
+    \c Atomics. The worker script's \c WorkerScript.sendMessage() function
+    accepts the same arguments.
 */
 void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
 {
@@ -561,10 +638,22 @@ void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
 
     QV4::Scope scope(args->v4engine());
     QV4::ScopedValue argument(scope, QV4::Value::undefinedValue());
+    QV4::ScopedValue transfer(scope, QV4::Value::undefinedValue());
     if (args->length() != 0)
         argument = (*args)[0];
+    if (args->length() > 1)
+        transfer = (*args)[1];
 
-    m_engine->sendMessage(m_scriptId, QV4::Serialize::serialize(argument, scope.engine));
+    sendSerializedMessage(QV4::Serialize::serialize(argument, scope.engine, transfer));
+}
+
+bool QQuickWorkerScript::sendSerializedMessage(QV4::Serialize::Message message)
+{
+    if (!engine())
+        return false;
+
+    m_engine->sendMessage(m_scriptId, std::move(message));
+    return true;
 }
 
 void QQuickWorkerScript::classBegin()
@@ -582,10 +671,7 @@ QQuickWorkerScriptEngine *QQuickWorkerScript::engine()
             return nullptr;
         }
 
-        QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(engine);
-        if (enginePrivate->workerScriptEngine == nullptr)
-            enginePrivate->workerScriptEngine = new QQuickWorkerScriptEngine(engine);
-        m_engine = qobject_cast<QQuickWorkerScriptEngine *>(enginePrivate->workerScriptEngine);
+        m_engine = QQuickWorkerScriptEnginePool::get(engine)->engineForNewWorker();
         Q_ASSERT(m_engine);
         m_scriptId = m_engine->registerWorkerScript(this);
 
@@ -623,13 +709,28 @@ bool QQuickWorkerScript::event(QEvent *event)
         return true;
     } else if (event->type() == (QEvent::Type)WorkerErrorEvent::WorkerError) {
         WorkerErrorEvent *workerEvent = static_cast<WorkerErrorEvent *>(event);
-        QQmlEnginePrivate::warning(qmlEngine(this), workerEvent->error());
+        if (workerEvent->isLoadError())
+            reportLoadError(workerEvent->error());
+        else
+            reportError(workerEvent->error());
         return true;
     } else {
         return QObject::event(event);
     }
 }
 
+void QQuickWorkerScript::reportError(const QQmlError &error)
+{
+    QQmlEnginePrivate::warning(qmlEngine(this), error);
+}
+
+// Called instead of reportError() when the script could not be loaded or threw
+// while it was run for the first time.
+void QQuickWorkerScript::reportLoadError(const QQmlError &error)
+{
+    reportError(error);
+}
+
 QT_END_NAMESPACE
 
 #include <qquickworkerscript.moc>
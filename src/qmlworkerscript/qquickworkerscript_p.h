@@ -58,6 +58,10 @@
 #include <QtQml/qjsvalue.h>
 #include <QtCore/qurl.h>
 
+#include <QtCore/qvector.h>
+
+#include <private/qv4serialize_p.h>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -73,15 +77,40 @@ public:
     int registerWorkerScript(QQuickWorkerScript *);
     void removeWorkerScript(int);
     void executeUrl(int, const QUrl &);
-    void sendMessage(int, const QByteArray &);
+    void sendMessage(int, QV4::Serialize::Message);
+
+    int workerCount() const { return m_workerCount; }
 
 protected:
     void run() override;
 
 private:
     QQuickWorkerScriptEnginePrivate *d;
+    int m_workerCount = 0;
+};
+
+class QQuickWorkerScriptEnginePool : public QObject
+{
+    Q_OBJECT
+public:
+    QQuickWorkerScriptEnginePool(QQmlEngine *parent);
+
+    static QQuickWorkerScriptEnginePool *get(QQmlEngine *engine);
+
+    QQuickWorkerScriptEngine *engineForNewWorker();
+
+    int maximumThreadCount() const { return m_maximumThreadCount; }
+    void setMaximumThreadCount(int count);
+
+    int threadCount() const { return m_engines.count(); }
+
+private:
+    QQmlEngine *m_qmlEngine;
+    QVector<QQuickWorkerScriptEngine *> m_engines;
+    int m_maximumThreadCount;
 };
 
+class QQmlError;
 class QQmlV4Function;
 class Q_AUTOTEST_EXPORT QQuickWorkerScript : public QObject, public QQmlParserStatus
 {
@@ -104,10 +133,15 @@ Q_SIGNALS:
     void sourceChanged();
     void message(const QJSValue &messageObject);
 
+public:
+    bool sendSerializedMessage(QV4::Serialize::Message message);
+
 protected:
     void classBegin() override;
     void componentComplete() override;
     bool event(QEvent *) override;
+    virtual void reportError(const QQmlError &error);
+    virtual void reportLoadError(const QQmlError &error);
 
 private:
     QQuickWorkerScriptEngine *engine();
@@ -47,6 +47,11 @@
 #endif
 #include <private/qv4objectproto_p.h>
 #include <private/qv4qobjectwrapper_p.h>
+#include <private/qv4arraybuffer_p.h>
+#include <private/qv4typedarray_p.h>
+#include <private/qv4mm_p.h>
+
+#include <QtCore/qhash.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -64,7 +69,14 @@ using namespace QV4;
 //    + Number
 //    + Date
 //    + RegExp
+//    + ArrayBuffer, SharedArrayBuffer
+//    + TypedArray
 // <quint8 type><quint24 size><data>
+//
+// ArrayBuffers are stored as an index into the buffers of the message. Their contents are
+// copied, unless they are listed as transferable, in which case the sender's buffer is
+// detached and the memory is handed over. SharedArrayBuffers share their memory with the
+// receiver.
 
 enum Type {
     WorkerUndefined,
@@ -82,8 +94,24 @@ enum Type {
     WorkerRegexp,
     WorkerListModel,
 #if QT_CONFIG(qml_sequence_object)
-    WorkerSequence
+    WorkerSequence,
 #endif
+    WorkerArrayBuffer,
+    WorkerSharedArrayBuffer,
+    WorkerTypedArray
+};
+
+struct Serialize::SerializeState
+{
+    Message message;
+    QHash<Heap::SharedArrayBuffer *, quint32> bufferIndexes;
+    QVector<Heap::ArrayBuffer *> transferred;
+};
+
+struct Serialize::DeserializeState
+{
+    Message *message;
+    Value *buffers; // the buffer objects created so far, on the JS stack
 };
 
 static inline quint32 valueheader(Type type, quint32 size = 0)
@@ -146,9 +174,37 @@ static inline void *popPtr(const char *&data)
 // serialization/deserialization failures
 
 #define ALIGN(size) (((size) + 3) & ~3)
-void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine *engine)
+void Serialize::serializeBuffer(SerializeState &state, Heap::SharedArrayBuffer *buffer)
+{
+    QByteArray &data = state.message.data;
+    if (buffer->isDetachedBuffer()) {
+        push(data, valueheader(WorkerUndefined));
+        return;
+    }
+
+    auto it = state.bufferIndexes.constFind(buffer);
+    if (it == state.bufferIndexes.constEnd()) {
+        const bool isTransferred = !buffer->isSharedArrayBuffer()
+                && state.transferred.contains(static_cast<Heap::ArrayBuffer *>(buffer));
+        if (buffer->isSharedArrayBuffer() || isTransferred) {
+            QByteArrayDataPtr shared = { buffer->data };
+            shared.ptr->ref.ref();
+            state.message.buffers.append(QByteArray(shared));
+        } else {
+            state.message.buffers.append(QByteArray(buffer->data->data(), buffer->data->size));
+        }
+        it = state.bufferIndexes.insert(buffer, quint32(state.message.buffers.size() - 1));
+    }
+
+    reserve(data, 2 * sizeof(quint32));
+    push(data, valueheader(buffer->isSharedArrayBuffer() ? WorkerSharedArrayBuffer : WorkerArrayBuffer));
+    push(data, it.value());
+}
+
+void Serialize::serialize(SerializeState &state, const QV4::Value &v, ExecutionEngine *engine)
 {
     QV4::Scope scope(engine);
+    QByteArray &data = state.message.data;
 
     if (v.isEmpty()) {
         Q_ASSERT(!"Serialize: got empty value");
@@ -189,7 +245,7 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         push(data, valueheader(WorkerArray, length));
         ScopedValue val(scope);
         for (uint ii = 0; ii < length; ++ii)
-            serialize(data, (val = array->get(ii)), engine);
+            serialize(state, (val = array->get(ii)), engine);
     } else if (v.isInteger()) {
         reserve(data, 2 * sizeof(quint32));
         push(data, valueheader(WorkerInt32));
@@ -225,6 +281,14 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         char *buffer = data.data() + offset;
 
         memcpy(buffer, pattern.constData(), length*sizeof(QChar));
+    } else if (const SharedArrayBuffer *buffer = v.as<SharedArrayBuffer>()) {
+        serializeBuffer(state, buffer->d());
+    } else if (const TypedArray *array = v.as<TypedArray>()) {
+        reserve(data, 3 * sizeof(quint32));
+        push(data, valueheader(WorkerTypedArray, array->d()->arrayType));
+        push(data, quint32(array->d()->byteOffset));
+        push(data, quint32(array->d()->byteLength));
+        serializeBuffer(state, array->d()->buffer);
     } else if (const QObjectWrapper *qobjectWrapper = v.as<QV4::QObjectWrapper>()) {
         // XXX TODO: Generalize passing objects between the main thread and worker scripts so
         // that others can trivially plug in their elements.
@@ -251,10 +315,10 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
             }
             reserve(data, sizeof(quint32) + length * sizeof(quint32));
             push(data, valueheader(WorkerSequence, length));
-            serialize(data, QV4::Value::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
+            serialize(state, QV4::Value::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
             ScopedValue val(scope);
             for (uint ii = 0; ii < seqLength; ++ii)
-                serialize(data, (val = o->get(ii)), engine); // sequence elements
+                serialize(state, (val = o->get(ii)), engine); // sequence elements
 
             return;
         }
@@ -273,14 +337,14 @@ void Serialize::serialize(QByteArray &data, const QV4::Value &v, ExecutionEngine
         QV4::ScopedValue s(scope);
         for (quint32 ii = 0; ii < length; ++ii) {
             s = properties->get(ii);
-            serialize(data, s, engine);
+            serialize(state, s, engine);
 
             QV4::String *str = s->as<String>();
             val = o->get(str);
             if (scope.hasException())
                 scope.engine->catchException();
 
-            serialize(data, val, engine);
+            serialize(state, val, engine);
         }
         return;
     } else {
@@ -323,7 +387,7 @@ Q_DECLARE_METATYPE(VariantRef)
 Q_DECLARE_METATYPE(QV4::ExecutionEngine *)
 QT_BEGIN_NAMESPACE
 
-ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
+ReturnedValue Serialize::deserialize(DeserializeState &state, const char *&data, ExecutionEngine *engine)
 {
     quint32 header = popUint32(data);
     Type type = headertype(header);
@@ -355,7 +419,7 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedArrayObject a(scope, engine->newArrayObject());
         ScopedValue v(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            v = deserialize(data, engine);
+            v = deserialize(state, data, engine);
             a->put(ii, v);
         }
         return a.asReturnedValue();
@@ -368,8 +432,8 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         ScopedString n(scope);
         ScopedValue value(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            name = deserialize(data, engine);
-            value = deserialize(data, engine);
+            name = deserialize(state, data, engine);
+            value = deserialize(state, data, engine);
             n = name->asReturnedValue();
             o->put(n, value);
         }
@@ -413,12 +477,12 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         bool succeeded = false;
         quint32 length = headersize(header);
         quint32 seqLength = length - 1;
-        value = deserialize(data, engine);
+        value = deserialize(state, data, engine);
         int sequenceType = value->integerValue();
         ScopedArrayObject array(scope, engine->newArrayObject());
         array->arrayReserve(seqLength);
         for (quint32 ii = 0; ii < seqLength; ++ii) {
-            value = deserialize(data, engine);
+            value = deserialize(state, data, engine);
             array->arrayPut(ii, value);
         }
         array->setArrayLengthUnchecked(seqLength);
@@ -426,22 +490,123 @@ ReturnedValue Serialize::deserialize(const char *&data, ExecutionEngine *engine)
         return QV4::SequencePrototype::fromVariant(engine, seqVariant, &succeeded);
     }
 #endif
+    case WorkerArrayBuffer:
+    case WorkerSharedArrayBuffer:
+    {
+        const quint32 index = popUint32(data);
+        Value &buffer = state.buffers[index];
+        if (buffer.isUndefined()) {
+            QByteArray &contents = state.message->buffers[index];
+            if (type == WorkerSharedArrayBuffer)
+                buffer = engine->memoryManager->allocate<SharedArrayBuffer>(contents);
+            else
+                buffer = engine->newArrayBuffer(contents);
+            // Drop the message's reference, so that writing to the buffer doesn't detach it.
+            contents = QByteArray();
+        }
+        return buffer.asReturnedValue();
+    }
+    case WorkerTypedArray:
+    {
+        const quint32 arrayType = headersize(header);
+        const quint32 byteOffset = popUint32(data);
+        const quint32 byteLength = popUint32(data);
+        Scoped<SharedArrayBuffer> buffer(scope, deserialize(state, data, engine));
+        if (!buffer || arrayType >= NTypedArrayTypes)
+            return QV4::Encode::undefined();
+        Scoped<TypedArray> array(scope, TypedArray::create(engine, Heap::TypedArray::Type(arrayType)));
+        array->d()->buffer.set(engine, static_cast<Heap::ArrayBuffer *>(buffer->d()));
+        array->d()->byteLength = byteLength;
+        array->d()->byteOffset = byteOffset;
+        return array.asReturnedValue();
+    }
     }
     Q_ASSERT(!"Unreachable");
     return QV4::Encode::undefined();
 }
 
-QByteArray Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine)
+void Serialize::collectTransferred(SerializeState &state, const QV4::Value &transferList,
+                                   ExecutionEngine *engine)
 {
-    QByteArray rv;
-    serialize(rv, value, engine);
-    return rv;
+    const ArrayObject *transfer = transferList.as<ArrayObject>();
+    if (!transfer)
+        return;
+
+    Scope scope(engine);
+    ScopedValue item(scope);
+    const uint length = transfer->getLength();
+    for (uint i = 0; i < length; ++i) {
+        item = transfer->get(i);
+        // SharedArrayBuffers can't be transferred, they are always shared.
+        if (const ArrayBuffer *buffer = item->as<ArrayBuffer>()) {
+            if (!buffer->isSharedArrayBuffer() && !buffer->isDetachedBuffer())
+                state.transferred.append(buffer->d());
+        }
+    }
+}
+
+Serialize::Message Serialize::serialize(const QV4::Value &value, ExecutionEngine *engine,
+                                        const QV4::Value &transferList)
+{
+    SerializeState state;
+    collectTransferred(state, transferList, engine);
+
+    serialize(state, value, engine);
+
+    // The message now owns the memory of transferred buffers.
+    for (Heap::ArrayBuffer *buffer : qAsConst(state.transferred))
+        buffer->detachArrayBuffer();
+
+    return std::move(state.message);
 }
 
-ReturnedValue Serialize::deserialize(const QByteArray &data, ExecutionEngine *engine)
+QVector<Serialize::Message> Serialize::serializeEach(const ArrayObject *values,
+                                                     ExecutionEngine *engine,
+                                                     const QV4::Value &transferList)
 {
-    const char *stream = data.constData();
-    return deserialize(stream, engine);
+    Scope scope(engine);
+    SerializeState state;
+    collectTransferred(state, transferList, engine);
+
+    // Detaching a buffer right after the first message would make it undefined in the
+    // messages serialized after it, so all of them are detached at the end.
+    QVector<Heap::ArrayBuffer *> handedOver;
+    QVector<Message> messages;
+    const uint length = values->getLength();
+    messages.reserve(int(length));
+    ScopedValue value(scope);
+    for (uint i = 0; i < length; ++i) {
+        value = values->get(i);
+        serialize(state, value, engine);
+
+        for (auto it = state.bufferIndexes.cbegin(), end = state.bufferIndexes.cend(); it != end; ++it) {
+            if (it.key()->isSharedArrayBuffer())
+                continue;
+            Heap::ArrayBuffer *buffer = static_cast<Heap::ArrayBuffer *>(it.key());
+            if (state.transferred.removeOne(buffer))
+                handedOver.append(buffer);
+        }
+
+        messages.append(std::move(state.message));
+        state.message = Message();
+        state.bufferIndexes.clear();
+    }
+
+    // As in serialize(), listed buffers that no message referenced are detached as well.
+    for (Heap::ArrayBuffer *buffer : qAsConst(handedOver))
+        buffer->detachArrayBuffer();
+    for (Heap::ArrayBuffer *buffer : qAsConst(state.transferred))
+        buffer->detachArrayBuffer();
+
+    return messages;
+}
+
+ReturnedValue Serialize::deserialize(Message &message, ExecutionEngine *engine)
+{
+    Scope scope(engine);
+    DeserializeState state = { &message, scope.alloc(message.buffers.size()) };
+    const char *stream = message.data.constData();
+    return deserialize(state, stream, engine);
 }
 
 QT_END_NAMESPACE
@@ -52,6 +52,7 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
 #include <private/qv4value_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -60,13 +61,30 @@ namespace QV4 {
 
 class Serialize {
 public:
+    // The contents of ArrayBuffers travel next to the serialized data. This way buffers
+    // that are transferred or shared don't need to be copied.
+    struct Message
+    {
+        QByteArray data;
+        QVector<QByteArray> buffers;
+    };
 
-    static QByteArray serialize(const Value &, ExecutionEngine *);
-    static ReturnedValue deserialize(const QByteArray &, ExecutionEngine *);
+    static Message serialize(const Value &, ExecutionEngine *,
+                             const Value &transferList = Value::undefinedValue());
+    // Serializes each element of the array into a message of its own. A transferred buffer is
+    // handed over to the first message referencing it, later messages receive copies.
+    static QVector<Message> serializeEach(const ArrayObject *, ExecutionEngine *,
+                                          const Value &transferList = Value::undefinedValue());
+    static ReturnedValue deserialize(Message &, ExecutionEngine *);
 
 private:
-    static void serialize(QByteArray &, const Value &, ExecutionEngine *);
-    static ReturnedValue deserialize(const char *&, ExecutionEngine *);
+    struct SerializeState;
+    struct DeserializeState;
+
+    static void collectTransferred(SerializeState &, const Value &transferList, ExecutionEngine *);
+    static void serialize(SerializeState &, const Value &, ExecutionEngine *);
+    static void serializeBuffer(SerializeState &, Heap::SharedArrayBuffer *);
+    static ReturnedValue deserialize(DeserializeState &, const char *&, ExecutionEngine *);
 };
 
 }
@@ -62,6 +62,7 @@
 
 #include <private/qqmlglobal_p.h>
 #include <private/qqmlengine_p.h>
+#include <private/qqmldata_p.h>
 #include <QtQuick/private/qquickstategroup_p.h>
 #include <private/qqmlopenmetaobject_p.h>
 #include <QtQuick/private/qquickstate_p.h>
@@ -91,6 +92,8 @@ Q_DECLARE_LOGGING_CATEGORY(DBG_HOVER_TRACE)
 Q_DECLARE_LOGGING_CATEGORY(lcTransient)
 Q_LOGGING_CATEGORY(lcHandlerParent, "qt.quick.handler.parent")
 
+DEFINE_BOOL_CONFIG_OPTION(qmlLazyBindings, QML_LAZY_BINDINGS)
+
 void debugFocusTree(QQuickItem *item, QQuickItem *scope = nullptr, int depth = 1)
 {
     if (DBG_FOCUS().isEnabled(QtDebugMsg)) {
@@ -2766,6 +2769,7 @@ void QQuickItem::setParentItem(QQuickItem *parentItem)
     else if (d->window)
         QQuickWindowPrivate::get(d->window)->parentlessItems.insert(this);
 
+    d->setBindingUpdatesDeferred(d->parentItem && !QQuickItemPrivate::get(d->parentItem)->effectiveVisible);
     d->setEffectiveVisibleRecur(d->calcEffectiveVisible());
     d->setEffectiveEnableRecur(nullptr, d->calcEffectiveEnable());
 
@@ -6048,8 +6052,11 @@ bool QQuickItemPrivate::setEffectiveVisibleRecur(bool newEffectiveVisible)
     }
 
     bool childVisibilityChanged = false;
-    for (int ii = 0; ii < childItems.count(); ++ii)
-        childVisibilityChanged |= QQuickItemPrivate::get(childItems.at(ii))->setEffectiveVisibleRecur(newEffectiveVisible);
+    for (int ii = 0; ii < childItems.count(); ++ii) {
+        QQuickItemPrivate *childPrivate = QQuickItemPrivate::get(childItems.at(ii));
+        childPrivate->setBindingUpdatesDeferred(!newEffectiveVisible);
+        childVisibilityChanged |= childPrivate->setEffectiveVisibleRecur(newEffectiveVisible);
+    }
 
     itemChange(QQuickItem::ItemVisibleHasChanged, effectiveVisible);
 #if QT_CONFIG(accessibility)
@@ -6065,6 +6072,30 @@ bool QQuickItemPrivate::setEffectiveVisibleRecur(bool newEffectiveVisible)
     return true;    // effective visibility DID change
 }
 
+/*!
+    \internal
+
+    With QML_LAZY_BINDINGS set, the bindings of items hidden by one of their ancestors
+    are not re-evaluated when their dependencies change. They are evaluated when they
+    are read, or when the item's parent becomes visible again. The bindings of an item
+    that is hidden only by its own \c visible property are still evaluated, so that the
+    \c visible binding itself stays up to date.
+*/
+void QQuickItemPrivate::setBindingUpdatesDeferred(bool deferred)
+{
+    if (!qmlLazyBindings())
+        return;
+
+    Q_Q(QQuickItem);
+    QQmlData *data = QQmlData::get(q);
+    if (!data || data->deferBindingUpdates == deferred)
+        return;
+
+    data->deferBindingUpdates = deferred;
+    if (!deferred)
+        data->flushPendingBindings(q);
+}
+
 bool QQuickItemPrivate::calcEffectiveEnable() const
 {
     // XXX todo - Should the effective enable of an element with no parent just be the current
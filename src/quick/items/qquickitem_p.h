@@ -615,6 +615,7 @@ public:
 
     bool calcEffectiveVisible() const;
     bool setEffectiveVisibleRecur(bool);
+    void setBindingUpdatesDeferred(bool deferred);
     bool calcEffectiveEnable() const;
     void setEffectiveEnableRecur(QQuickItem *scope, bool);
 
@@ -73,6 +73,9 @@
 #include <QtCore/QLibraryInfo>
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
+#include <QtQml/qqmlengine.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4mm_p.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
 
@@ -454,6 +457,35 @@ void QQuickWindowPrivate::syncSceneGraph()
     runAndClearJobs(&afterSynchronizingJobs);
 }
 
+/*!
+    \internal
+
+    Gives the JavaScript garbage collector a time slice to make progress on an
+    incremental collection. Called by every render loop once per frame: by the
+    threaded render loop after the scene graph has been synchronized, while the
+    render thread is busy with the frame, and by the other render loops after
+    the frame has been swapped.
+
+    The engine is the one that created the window or its content. Windows
+    created from C++ do not necessarily have an incubation controller.
+ */
+void QQuickWindowPrivate::runIncrementalGCSlice()
+{
+    Q_Q(QQuickWindow);
+    QQmlEngine *engine = qmlEngine(q);
+    if (!engine) {
+        const QList<QQuickItem *> items = contentItem->childItems();
+        for (QQuickItem *item : items) {
+            if ((engine = qmlEngine(item)))
+                break;
+        }
+    }
+    if (!engine && incubationController)
+        engine = incubationController->engine();
+    if (engine)
+        engine->handle()->memoryManager->runIncrementalGCSlice();
+}
+
 void QQuickWindowPrivate::emitBeforeRenderPassRecording(void *ud)
 {
     QQuickWindow *w = reinterpret_cast<QQuickWindow *>(ud);
@@ -219,6 +219,7 @@ public:
     void polishItems();
     void forcePolish();
     void syncSceneGraph();
+    void runIncrementalGCSlice();
     void renderSceneGraph(const QSize &size, const QSize &surfaceSize = QSize());
 
     bool isRenderable() const;
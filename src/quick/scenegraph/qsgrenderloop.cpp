@@ -721,6 +721,10 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
 
     QSGRhiProfileConnection::instance()->send(rhi);
 
+    // The frame is done, let an incremental garbage collection make some progress
+    // before the next one.
+    cd->runIncrementalGCSlice();
+
     // Might have been set during syncSceneGraph()
     if (data.updatePending)
         maybeUpdate(window);
@@ -509,6 +509,10 @@ void QSGWindowsRenderLoop::renderWindow(QQuickWindow *window)
     RLDEBUG(" - frameDone");
     d->fireFrameSwapped();
 
+    // The frame is done, let an incremental garbage collection make some progress
+    // before the next one.
+    d->runIncrementalGCSlice();
+
     qCDebug(QSG_LOG_TIME_RENDERLOOP()).nospace()
             << "Frame rendered with 'windows' renderloop in: " << (time_swapped - time_start) / 1000000 << "ms"
             << ", polish=" << (time_polished - time_start) / 1000000
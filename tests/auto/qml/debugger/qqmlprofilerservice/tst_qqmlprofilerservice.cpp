@@ -150,6 +150,7 @@ void QQmlProfilerTestClient::addEvent(const QQmlProfilerEvent &event)
         jsHeapMessages.append(event);
         break;
     case DebugMessage:
+    case HeapSnapshot:
         // Unhandled
         break;
     case MaximumMessage:
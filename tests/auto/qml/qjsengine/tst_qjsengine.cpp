@@ -154,9 +154,13 @@ private slots:
     void arrayPop_QTBUG_35979();
     void array_unshift_QTBUG_52065();
     void array_join_QTBUG_53672();
+    void packedArrayBuiltins();
+    void ropeStrings();
+    void jsonParseAndStringify();
 
     void regexpLastMatch();
     void regexpLastIndex();
+    void regexpSharedBetweenEngines();
     void indexedAccesses();
 
     void prototypeChainGc();
@@ -253,6 +257,11 @@ private slots:
 
     void triggerBackwardJumpWithDestructuring();
 
+    void lazyFunctionCompilation_data();
+    void lazyFunctionCompilation();
+
+    void builtinObjectsAcrossEngines();
+
 public:
     Q_INVOKABLE QJSValue throwingCppMethod1();
     Q_INVOKABLE void throwingCppMethod2();
@@ -3480,6 +3489,91 @@ void tst_QJSEngine::array_join_QTBUG_53672()
     QCOMPARE(result.toString(), QString(""));
 }
 
+void tst_QJSEngine::ropeStrings()
+{
+    QJSEngine eng;
+    QJSValue result = eng.evaluate(
+                "var log = '';\n"
+                "var expected = [];\n"
+                "for (var i = 0; i < 20000; ++i) {\n"
+                "    log += 'line ' + i;\n"
+                "    log += (i % 3) ? '\\n' : ' (' + i * 2 + ')\\n';\n"
+                "    expected.push('line ' + i + ((i % 3) ? '' : ' (' + i * 2 + ')'));\n"
+                "}\n"
+                "var prefixed = '';\n"
+                "for (var j = 0; j < 1000; ++j)\n"
+                "    prefixed = j + ',' + prefixed;\n"
+                "var flat = expected.join('\\n') + '\\n';\n"
+                "[log === flat, log.length === flat.length, log.indexOf('line 19999'),\n"
+                " prefixed.indexOf('999,998,'), prefixed.slice(-4), `${log.length}-${prefixed[0]}`].join('|');\n");
+    QVERIFY(!result.isError());
+    const QStringList parts = result.toString().split(QLatin1Char('|'));
+    QCOMPARE(parts.size(), 6);
+    QCOMPARE(parts.at(0), QStringLiteral("true"));
+    QCOMPARE(parts.at(1), QStringLiteral("true"));
+    QVERIFY(parts.at(2).toInt() > 0);
+    QCOMPARE(parts.at(3), QStringLiteral("0"));
+    QCOMPARE(parts.at(4), QStringLiteral("1,0,"));
+    QVERIFY(parts.at(5).endsWith(QStringLiteral("-9")));
+
+    // Strings built by prepending collapse the right spine of the rope
+    result = eng.evaluate(
+                "var reversed = '';\n"
+                "var items = [];\n"
+                "for (var k = 0; k < 100000; ++k) {\n"
+                "    reversed = 'item ' + k + ';' + reversed;\n"
+                "    items.push('item ' + k + ';');\n"
+                "}\n"
+                "reversed === items.reverse().join('');\n");
+    QVERIFY(!result.isError());
+    QVERIFY(result.toBool());
+}
+
+void tst_QJSEngine::jsonParseAndStringify()
+{
+    QJSEngine eng;
+    QJSValue result = eng.evaluate(QStringLiteral(
+                "var text = '[{\"a\": 1, \"b\": \"x\"}, {\"a\": 2, \"b\": \"y\"}, {\"b\": \"z\", \"a\": 3},'\n"
+                "    + ' {\"a\": 4, \"a\": 5}, {\"a\": 6, \"__proto__\": 7, \"0\": 8},'\n"
+                "    + '\\t\\n {\"a\\\\u0062\": \"0123456789abcdef\\\\\"0123456789\\\\\\\\end\", \"b\": -12345678901}]';\n"
+                "var v = JSON.parse(text);\n"
+                "[v.length, v[0].a, v[1].b, Object.keys(v[2]).join(), v[3].a, Object.keys(v[3]).length,\n"
+                " v[4].__proto__, v[4][0], v[5].ab, v[5].b,\n"
+                " JSON.stringify(v[5]), JSON.stringify({ x: undefined, y: [undefined, 1], z: 'a\\u0001\\n' }),\n"
+                " JSON.stringify({ a: [1, {}], b: {} }, null, 1)].join('|');\n"));
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toString(),
+             QStringLiteral("6|1|y|b,a|5|1|"
+                            "7|8|0123456789abcdef\"0123456789\\end|-12345678901|"
+                            "{\"ab\":\"0123456789abcdef\\\"0123456789\\\\end\",\"b\":-12345678901}|"
+                            "{\"y\":[null,1],\"z\":\"a\\u0001\\n\"}|"
+                            "{\n \"a\": [\n  1,\n  {}\n ],\n \"b\": {}\n}"));
+}
+
+void tst_QJSEngine::packedArrayBuiltins()
+{
+    QJSEngine eng;
+    QJSValue result = eng.evaluate(
+                "var ints = [1, 2, 3, 2, 1];\n"
+                "var doubles = [0.5, NaN, -0, 2, 0.5];\n"
+                "var mixed = [1, 2, 3]; mixed[1] = 'x';\n"
+                "var holey = [1, 2]; holey[4] = 5;\n"
+                "var results = [\n"
+                "    ints.indexOf(2), ints.lastIndexOf(2), ints.indexOf(2.5), ints.indexOf(2, -2),\n"
+                "    ints.includes(3), ints.includes(4), ints.join(), ints.join('-'),\n"
+                "    doubles.indexOf(NaN), doubles.includes(NaN), doubles.indexOf(0),\n"
+                "    doubles.lastIndexOf(0.5), doubles.lastIndexOf(0.5, 3), doubles.join(),\n"
+                "    mixed.indexOf(2), mixed.indexOf('x'), mixed.join(),\n"
+                "    holey.includes(undefined), holey.indexOf(undefined), holey.join()\n"
+                "];\n"
+                "results.join('|');\n");
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toString(),
+             QStringLiteral("1|3|-1|3|true|false|1,2,3,2,1|1-2-3-2-1|"
+                            "-1|true|2|4|0|0.5,NaN,0,2,0.5|"
+                            "-1|1|1,x,3|true|-1|1,2,,,5"));
+}
+
 void tst_QJSEngine::regexpLastMatch()
 {
     QJSEngine eng;
@@ -3564,6 +3658,27 @@ void tst_QJSEngine::regexpLastIndex()
     QVERIFY(result.toBool());
 }
 
+void tst_QJSEngine::regexpSharedBetweenEngines()
+{
+    const QString program = QStringLiteral(
+            "(function() { var re = /(\\d+)-(\\w+)/g; var out = [];"
+            "  for (var m; (m = re.exec('1-a 22-bb 333-ccc')); ) out.push(m[2]);"
+            "  return out.join(); })()");
+
+    // The compiled pattern outlives the engine that compiled it, as long as
+    // another engine is still using it.
+    QScopedPointer<QJSEngine> first(new QJSEngine);
+    QCOMPARE(first->evaluate(program).toString(), QStringLiteral("a,bb,ccc"));
+
+    QJSEngine second;
+    QCOMPARE(second.evaluate(program).toString(), QStringLiteral("a,bb,ccc"));
+    first.reset();
+    second.collectGarbage();
+    QCOMPARE(second.evaluate(program).toString(), QStringLiteral("a,bb,ccc"));
+    QVERIFY(second.evaluate("/(a)\\1/.test('aa')").toBool());
+    QVERIFY(second.evaluate("new RegExp('(')").isError());
+}
+
 void tst_QJSEngine::indexedAccesses()
 {
     QJSEngine engine;
@@ -4960,6 +5075,92 @@ void tst_QJSEngine::triggerBackwardJumpWithDestructuring()
     QVERIFY(!value.isError());
 }
 
+void tst_QJSEngine::lazyFunctionCompilation_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("closure") << "function outer() { var x = 1; function inner(y) { return x + y; } x = 41; return inner(1); }\nouter()" << "42";
+    QTest::newRow("block scope") << "function f() { let a = 2; { const b = 3; let g = function() { return a * b; }; return g(); } }\nf()" << "6";
+    QTest::newRow("assign outer") << "var counter = 0; function inc() { counter++; }\ninc(); inc(); counter" << "2";
+    QTest::newRow("declaration") << "function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\nfib(10)" << "55";
+    QTest::newRow("named expression") << "var fact = function f(n) { return n <= 1 ? 1 : n * f(n - 1); }; var f = null;\nfact(5)" << "120";
+    QTest::newRow("nested") << "function a() { function b() { function c() { return 7; } return c(); } return b(); }\na()" << "7";
+    QTest::newRow("arguments") << "function f() { return arguments.length; }\nf(1, 2, 3)" << "3";
+    QTest::newRow("strict") << "'use strict'; function f() { return this === undefined; }\nf()" << "true";
+    QTest::newRow("sloppy") << "function f() { return this === undefined; }\nf()" << "false";
+    QTest::newRow("constructor") << "function P(x) { this.x = x; }\nnew P(5).x" << "5";
+    QTest::newRow("eval") << "function f() { var y = 3; return eval('y * 2'); }\nf()" << "6";
+    QTest::newRow("error in body") << "function f() { break; }\nf()" << "SyntaxError: Break outside of loop";
+}
+
+void tst_QJSEngine::lazyFunctionCompilation()
+{
+    QFETCH(QString, code);
+    QFETCH(QString, result);
+
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(code).toString(), result);
+    }
+
+    const QByteArray origLazy = qgetenv("QV4_LAZY_FUNCTION_COMPILATION");
+    qputenv("QV4_LAZY_FUNCTION_COMPILATION", "1");
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(code).toString(), result);
+        // The body of a function that is never called is not compiled
+        QCOMPARE(engine.evaluate("function neverCalled() { break; }\n42").toString(), QString("42"));
+    }
+    if (origLazy.isNull())
+        qunsetenv("QV4_LAZY_FUNCTION_COMPILATION");
+    else
+        qputenv("QV4_LAZY_FUNCTION_COMPILATION", origLazy);
+}
+
+void tst_QJSEngine::builtinObjectsAcrossEngines()
+{
+    // Lists the own properties of the global object and of the builtin constructors and
+    // prototypes, in order, together with their attributes.
+    const QString code = QStringLiteral(
+                "(function(global) {\n"
+                "    var result = [];\n"
+                "    function describe(name, o) {\n"
+                "        Reflect.ownKeys(o).forEach(function(key) {\n"
+                "            var d = Object.getOwnPropertyDescriptor(o, key);\n"
+                "            result.push(name + '.' + String(key) + ':' + typeof d.value + typeof d.get\n"
+                "                        + typeof d.set + d.writable + d.enumerable + d.configurable);\n"
+                "        });\n"
+                "    }\n"
+                "    describe('global', global);\n"
+                "    Object.getOwnPropertyNames(global).forEach(function(name) {\n"
+                "        var o = global[name];\n"
+                "        if (typeof o !== 'function' && (typeof o !== 'object' || o === null))\n"
+                "            return;\n"
+                "        describe(name, o);\n"
+                "        if (typeof o === 'function' && typeof o.prototype === 'object')\n"
+                "            describe(name + '.prototype', o.prototype);\n"
+                "    });\n"
+                "    return result;\n"
+                "})(this)");
+
+    QStringList first;
+    for (int i = 0; i < 3; ++i) {
+        QJSEngine engine;
+        const QStringList properties = engine.evaluate(code).toVariant().toStringList();
+        QVERIFY(properties.contains(QStringLiteral("Array.prototype.map:functionundefinedundefinedtruefalsetrue")));
+        QVERIFY(properties.contains(QStringLiteral("global.undefined:undefinedundefinedundefinedfalsefalsefalse")));
+        if (i == 0)
+            first = properties;
+        else
+            QCOMPARE(properties, first);
+
+        QCOMPARE(engine.evaluate("[3, 1, 2].sort().concat(Math.max(4, 5)).join()").toString(), QStringLiteral("1,2,3,5"));
+        QCOMPARE(engine.evaluate("new Map([[1, 'a']]).get(1) + new Int8Array([7])[0] + parseInt('8')").toString(),
+                 QStringLiteral("a78"));
+    }
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
@@ -0,0 +1,25 @@
+import QtQml 2.0
+
+QtObject {
+    id: root
+
+    property int count: 2
+    property bool enabled: true
+
+    property real ratio: count / 4
+    property bool big: count > 10 && enabled
+    property string parity: count % 2 == 0 ? "even" : "odd"
+    property string greeting: "Hello, " + parity
+    // count isn't a string, so this binding always falls back to the bytecode
+    property string label: "Count: " + count
+
+    property QtObject child: QtObject {
+        id: inner
+        property real size: 10
+        property real scaled: root.count * size
+    }
+    property real childSize: inner.size + 1
+
+    signal bump()
+    onBump: count += 3
+}
@@ -15,7 +15,8 @@ RESOURCES += \
     data/Enums.qml \
     data/componentInItem.qml \
     data/jsmoduleimport.qml \
-    data/script.mjs
+    data/script.mjs \
+    data/aotBindings.qml
 
 workerscripts_test.files = \
     data/worker.js \
@@ -32,4 +33,6 @@ RESOURCES += \
 
 QTQUICK_COMPILER_RETAINED_RESOURCES += retain.qrc
 
+QMLCACHE_FLAGS += --aot-bindings
+
 QT += core-private qml-private testlib
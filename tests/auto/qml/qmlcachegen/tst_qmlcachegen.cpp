@@ -37,10 +37,13 @@
 #include <QLoggingCategory>
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlscriptdata_p.h>
+#include <private/qv4function_p.h>
 #include <qtranslator.h>
 
 #include "../../shared/util.h"
 
+#include <algorithm>
+
 class tst_qmlcachegen: public QQmlDataTest
 {
     Q_OBJECT
@@ -70,6 +73,8 @@ private slots:
 
     void sourceFileIndices();
 
+    void aotBindings();
+
     void reproducibleCache_data();
     void reproducibleCache();
 };
@@ -364,9 +369,10 @@ void tst_qmlcachegen::versionChecksForAheadOfTimeUnits()
 
     Q_ASSERT(!temporaryModifiedCachedUnit);
     QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
-    const QV4::CompiledData::Unit *originalUnit = QQmlMetaType::findCachedCompilationUnit(
+    const QQmlPrivate::CachedQmlUnit *originalCachedUnit = QQmlMetaType::findCachedCompilationUnit(
             QUrl("qrc:/data/versionchecks.qml"), &error);
-    QVERIFY(originalUnit);
+    QVERIFY(originalCachedUnit);
+    const QV4::CompiledData::Unit *originalUnit = originalCachedUnit->qmlData;
     QV4::CompiledData::Unit *tweakedUnit = (QV4::CompiledData::Unit *)malloc(originalUnit->unitSize);
     memcpy(reinterpret_cast<void *>(tweakedUnit), reinterpret_cast<const void *>(originalUnit), originalUnit->unitSize);
     tweakedUnit->version = QV4_DATA_STRUCTURE_VERSION - 1;
@@ -593,11 +599,11 @@ void tst_qmlcachegen::moduleScriptImport()
         QVERIFY(unitData->flags & QV4::CompiledData::Unit::IsESModule);
 
         QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
-        const QV4::CompiledData::Unit *unitFromResources = QQmlMetaType::findCachedCompilationUnit(
+        const QQmlPrivate::CachedQmlUnit *unitFromResources = QQmlMetaType::findCachedCompilationUnit(
                 QUrl("qrc:/data/script.mjs"), &error);
         QVERIFY(unitFromResources);
 
-        QCOMPARE(unitFromResources, compilationUnit->unitData());
+        QCOMPARE(unitFromResources->qmlData, compilationUnit->unitData());
     }
 }
 
@@ -616,11 +622,62 @@ void tst_qmlcachegen::sourceFileIndices()
     QVERIFY(QFileInfo(":/data/versionchecks.qml").size() > 0);
 
     QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
-    const QV4::CompiledData::Unit *unitFromResources = QQmlMetaType::findCachedCompilationUnit(
+    const QQmlPrivate::CachedQmlUnit *unitFromResources = QQmlMetaType::findCachedCompilationUnit(
             QUrl("qrc:/data/versionchecks.qml"), &error);
     QVERIFY(unitFromResources);
-    QVERIFY(unitFromResources->flags & QV4::CompiledData::Unit::PendingTypeCompilation);
-    QCOMPARE(uint(unitFromResources->sourceFileIndex), uint(0));
+    QVERIFY(unitFromResources->qmlData->flags & QV4::CompiledData::Unit::PendingTypeCompilation);
+    QCOMPARE(uint(unitFromResources->qmlData->sourceFileIndex), uint(0));
+}
+
+void tst_qmlcachegen::aotBindings()
+{
+    QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
+    const QQmlPrivate::CachedQmlUnit *unitFromResources = QQmlMetaType::findCachedCompilationUnit(
+            QUrl("qrc:/data/aotBindings.qml"), &error);
+    QVERIFY(unitFromResources);
+    QVERIFY(unitFromResources->aotCompiledFunctions);
+    QVERIFY(unitFromResources->aotCompiledFunctions[0].index >= 0);
+
+    QQmlEngine engine;
+    CleanlyLoadingComponent component(&engine, QUrl("qrc:/data/aotBindings.qml"));
+    QScopedPointer<QObject> obj(component.create());
+    QVERIFY(!obj.isNull());
+
+    auto compilationUnit = QQmlComponentPrivate::get(&component)->compilationUnit;
+    QVERIFY(compilationUnit);
+    const bool hasAOTFunctions = std::any_of(
+            compilationUnit->runtimeFunctions.cbegin(), compilationUnit->runtimeFunctions.cend(),
+            [](const QV4::Function *function) { return function->aotFunction != nullptr; });
+    QVERIFY(hasAOTFunctions);
+
+    QCOMPARE(obj->property("ratio").toDouble(), 0.5);
+    QCOMPARE(obj->property("big").toBool(), false);
+    QCOMPARE(obj->property("parity").toString(), QStringLiteral("even"));
+    QCOMPARE(obj->property("greeting").toString(), QStringLiteral("Hello, even"));
+    QCOMPARE(obj->property("label").toString(), QStringLiteral("Count: 2"));
+    QCOMPARE(obj->property("childSize").toDouble(), 11.0);
+    QObject *child = obj->property("child").value<QObject *>();
+    QVERIFY(child);
+    QCOMPARE(child->property("scaled").toDouble(), 20.0);
+
+    // The compiled bindings have to capture their dependencies like the bytecode does.
+    obj->setProperty("count", 12);
+    QCOMPARE(obj->property("ratio").toDouble(), 3.0);
+    QCOMPARE(obj->property("big").toBool(), true);
+    QCOMPARE(obj->property("label").toString(), QStringLiteral("Count: 12"));
+    QCOMPARE(child->property("scaled").toDouble(), 120.0);
+
+    obj->setProperty("enabled", false);
+    QCOMPARE(obj->property("big").toBool(), false);
+
+    child->setProperty("size", 1.5);
+    QCOMPARE(obj->property("childSize").toDouble(), 2.5);
+    QCOMPARE(child->property("scaled").toDouble(), 18.0);
+
+    QVERIFY(QMetaObject::invokeMethod(obj.data(), "bump"));
+    QCOMPARE(obj->property("count").toInt(), 15);
+    QCOMPARE(obj->property("parity").toString(), QStringLiteral("odd"));
+    QCOMPARE(obj->property("greeting").toString(), QStringLiteral("Hello, odd"));
 }
 
 void tst_qmlcachegen::reproducibleCache_data()
@@ -34,6 +34,7 @@
 #include <private/qv4codegen_p.h>
 #include <private/qqmlcomponent_p.h>
 #include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4function_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <QQmlComponent>
 #include <QQmlEngine>
@@ -42,6 +43,7 @@
 #include <QCryptographicHash>
 #include <QStandardPaths>
 #include <QDirIterator>
+#include <QScopeGuard>
 
 class tst_qmldiskcache: public QObject
 {
@@ -64,6 +66,9 @@ private slots:
     void singletonDependency();
     void cppRegisteredSingletonDependency();
     void cacheModuleScripts();
+    void jitCodeInCache();
+    void corruptedJitCodeInCache();
+    void lazyFunctionsInCache();
 
 private:
     QDir m_qmlCacheDirectory;
@@ -961,6 +966,231 @@ void tst_qmldiskcache::cacheModuleScripts()
     }
 }
 
+void tst_qmldiskcache::jitCodeInCache()
+{
+#if !QT_CONFIG(qml_jit) || !defined(Q_OS_LINUX)
+    QSKIP("JIT code is only stored in the disk cache on Linux.");
+#else
+    qputenv("QV4_JIT_DISK_CACHE", "1");
+    qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    auto environmentCleanup = qScopeGuard([]() {
+        qunsetenv("QV4_JIT_DISK_CACHE");
+        qunsetenv("QV4_JIT_CALL_THRESHOLD");
+    });
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString fileName = tempDir.path() + QLatin1String("/jitCode.qml");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArrayLiteral("import QtQml 2.0\n"
+                                     "QtObject {\n"
+                                     "    function sum(n) {\n"
+                                     "        var s = 0;\n"
+                                     "        for (var i = 0; i < n; ++i)\n"
+                                     "            s += i;\n"
+                                     "        return s;\n"
+                                     "    }\n"
+                                     "    property int result: sum(100)\n"
+                                     "}"));
+    }
+    const QUrl url = QUrl::fromLocalFile(fileName);
+
+    {
+        QQmlEngine engine;
+        CleanlyLoadingComponent component(&engine, url);
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("result").toInt(), 4950);
+    }
+
+    {
+        QFile cacheFile(QV4::ExecutableCompilationUnit::localCacheFilePath(url));
+        QVERIFY2(cacheFile.open(QIODevice::ReadOnly), qPrintable(cacheFile.errorString()));
+        QV4::CompiledData::Unit unit;
+        QVERIFY(cacheFile.read(reinterpret_cast<char *>(&unit), sizeof(unit)) == sizeof(unit));
+        QVERIFY(cacheFile.size() > qint64(unit.unitSize));
+    }
+
+    {
+        QQmlEngine engine;
+        CleanlyLoadingComponent component(&engine, url);
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("result").toInt(), 4950);
+
+        auto componentPrivate = QQmlComponentPrivate::get(&component);
+        QVERIFY(!componentPrivate->compilationUnit->backingFile.isNull());
+        QVERIFY(componentPrivate->compilationUnit->nativeCodeFunctionCount > 0);
+
+        QVariant sum;
+        QVERIFY(QMetaObject::invokeMethod(obj.data(), "sum", Q_RETURN_ARG(QVariant, sum),
+                                          Q_ARG(QVariant, 10)));
+        QCOMPARE(sum.toInt(), 45);
+    }
+#endif
+}
+
+void tst_qmldiskcache::corruptedJitCodeInCache()
+{
+#if !QT_CONFIG(qml_jit) || !defined(Q_OS_LINUX)
+    QSKIP("JIT code is only stored in the disk cache on Linux.");
+#else
+    qputenv("QV4_JIT_DISK_CACHE", "1");
+    qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    auto environmentCleanup = qScopeGuard([]() {
+        qunsetenv("QV4_JIT_DISK_CACHE");
+        qunsetenv("QV4_JIT_CALL_THRESHOLD");
+    });
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString fileName = tempDir.path() + QLatin1String("/corruptedJitCode.qml");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArrayLiteral("import QtQml 2.0\n"
+                                     "QtObject {\n"
+                                     "    function sum(n) {\n"
+                                     "        var s = 0;\n"
+                                     "        for (var i = 0; i < n; ++i)\n"
+                                     "            s += i;\n"
+                                     "        return s;\n"
+                                     "    }\n"
+                                     "    property int result: sum(100)\n"
+                                     "}"));
+    }
+    const QUrl url = QUrl::fromLocalFile(fileName);
+
+    {
+        QQmlEngine engine;
+        CleanlyLoadingComponent component(&engine, url);
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("result").toInt(), 4950);
+    }
+
+    // Move the first relocation of every stored function past the end of its code
+    quint32 storedFunctions = 0;
+    quint32 corruptedFunctions = 0;
+    {
+        QFile cacheFile(QV4::ExecutableCompilationUnit::localCacheFilePath(url));
+        QVERIFY2(cacheFile.open(QIODevice::ReadWrite), qPrintable(cacheFile.errorString()));
+        QByteArray contents = cacheFile.readAll();
+        QVERIFY(contents.size() >= int(sizeof(QV4::CompiledData::Unit)));
+        const auto *unit = reinterpret_cast<const QV4::CompiledData::Unit *>(contents.constData());
+        const int sectionOffset = int((unit->unitSize + 15) & ~15u);
+        QVERIFY(contents.size() > sectionOffset + int(sizeof(QV4::CompiledData::NativeCodeHeader)));
+
+        char *section = contents.data() + sectionOffset;
+        const auto *header = reinterpret_cast<const QV4::CompiledData::NativeCodeHeader *>(section);
+        storedFunctions = header->nFunctions;
+        for (quint32 i = 0; i < storedFunctions; ++i) {
+            const QV4::CompiledData::NativeCodeFunction *code = header->functionTable() + i;
+            if (!code->nRelocations)
+                continue;
+            auto *relocation = reinterpret_cast<QV4::CompiledData::NativeCodeRelocation *>(
+                        section + code->relocationTableOffset);
+            relocation->offset = code->codeSize + 0x1000;
+            ++corruptedFunctions;
+        }
+        QVERIFY(corruptedFunctions > 0);
+
+        QVERIFY(cacheFile.seek(0));
+        QCOMPARE(cacheFile.write(contents), qint64(contents.size()));
+    }
+
+    // Don't let the JIT compile the rejected functions again
+    qputenv("QV4_JIT_CALL_THRESHOLD", "1000000");
+    {
+        QQmlEngine engine;
+        CleanlyLoadingComponent component(&engine, url);
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("result").toInt(), 4950);
+
+        // The corrupted functions are not loaded, they run in the interpreter instead
+        auto componentPrivate = QQmlComponentPrivate::get(&component);
+        QVERIFY(!componentPrivate->compilationUnit->backingFile.isNull());
+        QCOMPARE(quint32(componentPrivate->compilationUnit->nativeCodeFunctionCount),
+                 storedFunctions - corruptedFunctions);
+        quint32 jittedFunctions = 0;
+        for (const QV4::Function *function : qAsConst(componentPrivate->compilationUnit->runtimeFunctions)) {
+            if (function->jittedCode)
+                ++jittedFunctions;
+        }
+        QCOMPARE(jittedFunctions, storedFunctions - corruptedFunctions);
+
+        QVariant sum;
+        QVERIFY(QMetaObject::invokeMethod(obj.data(), "sum", Q_RETURN_ARG(QVariant, sum),
+                                          Q_ARG(QVariant, 10)));
+        QCOMPARE(sum.toInt(), 45);
+    }
+#endif
+}
+
+void tst_qmldiskcache::lazyFunctionsInCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString scriptPath = tempDir.path() + QLatin1String("/lazy.js");
+    {
+        QFile file(scriptPath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArrayLiteral("function answer() { return 42; }\n"));
+    }
+    const QString fileName = tempDir.path() + QLatin1String("/lazy.qml");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArrayLiteral("import QtQml 2.0\n"
+                                     "import \"lazy.js\" as Lazy\n"
+                                     "QtObject {\n"
+                                     "    property int result: Lazy.answer()\n"
+                                     "}"));
+    }
+
+    const QString cacheFilePath = QV4::ExecutableCompilationUnit::localCacheFilePath(
+            QUrl::fromLocalFile(scriptPath));
+    auto cachedFlags = [&cacheFilePath]() -> quint32 {
+        QFile cacheFile(cacheFilePath);
+        if (!cacheFile.open(QIODevice::ReadOnly))
+            return 0;
+        QV4::CompiledData::Unit unit;
+        if (cacheFile.read(reinterpret_cast<char *>(&unit), sizeof(unit)) != sizeof(unit))
+            return 0;
+        return unit.flags;
+    };
+
+    auto load = [&fileName]() {
+        QQmlEngine engine;
+        CleanlyLoadingComponent component(&engine, QUrl::fromLocalFile(fileName));
+        QScopedPointer<QObject> obj(component.create());
+        QVERIFY(!obj.isNull());
+        QCOMPARE(obj->property("result").toInt(), 42);
+    };
+
+    {
+        qputenv("QV4_LAZY_FUNCTION_COMPILATION", "1");
+        auto environmentCleanup = qScopeGuard([]() {
+            qunsetenv("QV4_LAZY_FUNCTION_COMPILATION");
+        });
+        load();
+    }
+    QVERIFY(cachedFlags() & QV4::CompiledData::Unit::HasLazyFunctions);
+
+    // An engine that compiles eagerly does not use the stubs, but recompiles and
+    // replaces the cache file.
+    load();
+    const quint32 flags = cachedFlags();
+    QVERIFY(flags & QV4::CompiledData::Unit::IsJavascript);
+    QVERIFY(!(flags & QV4::CompiledData::Unit::HasLazyFunctions));
+}
+
 QTEST_MAIN(tst_qmldiskcache)
 
 #include "tst_qmldiskcache.moc"
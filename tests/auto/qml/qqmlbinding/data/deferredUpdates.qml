@@ -0,0 +1,11 @@
+import QtQml 2.0
+
+QtObject {
+    property int input: 1
+    property QtObject inner: QtObject {
+        property int doubled: input * 2
+        property int tripled: input * 3
+    }
+
+    function readDoubled() { return inner.doubled }
+}
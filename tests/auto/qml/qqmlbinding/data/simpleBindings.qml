@@ -0,0 +1,20 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+    width: 100
+
+    property int value: 5
+    property bool enabledFlag: true
+    property string name: "abc"
+    property Item inner: innerItem
+
+    Item {
+        id: innerItem
+        width: parent.width
+        height: root.value + 10
+        property bool hidden: !root.enabledFlag
+        property real half: (root.value) / 2
+        property string label: root.name + 1
+    }
+}
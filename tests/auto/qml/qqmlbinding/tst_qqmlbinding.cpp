@@ -29,6 +29,8 @@
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
 #include <private/qqmlbind_p.h>
+#include <private/qqmldata_p.h>
+#include <private/qqmlcomponent_p.h>
 #include <QtQuick/private/qquickrectangle_p.h>
 #include "../../shared/util.h"
 
@@ -55,6 +57,8 @@ private slots:
     void delayed();
     void bindingOverwriting();
     void bindToQmlComponent();
+    void deferredUpdates();
+    void simpleBindings();
 
 private:
     QQmlEngine engine;
@@ -402,6 +406,88 @@ void tst_qqmlbinding::bindToQmlComponent()
     QVERIFY(c.create());
 }
 
+void tst_qqmlbinding::deferredUpdates()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("deferredUpdates.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QVERIFY2(object, qPrintable(c.errorString()));
+    QObject *inner = object->property("inner").value<QObject *>();
+    QVERIFY(inner);
+    QCOMPARE(inner->property("doubled").toInt(), 2);
+
+    QQmlData *data = QQmlData::get(inner);
+    QVERIFY(data);
+    data->deferBindingUpdates = true;
+
+    object->setProperty("input", 2);
+    QCOMPARE(inner->property("doubled").toInt(), 2);
+    QCOMPARE(inner->property("tripled").toInt(), 3);
+
+    // Reading a pending binding from JavaScript evaluates it
+    QVariant doubled;
+    QVERIFY(QMetaObject::invokeMethod(object.data(), "readDoubled", Q_RETURN_ARG(QVariant, doubled)));
+    QCOMPARE(doubled.toInt(), 4);
+    QCOMPARE(inner->property("tripled").toInt(), 3);
+
+    data->flushPendingBindings(inner);
+    QCOMPARE(inner->property("tripled").toInt(), 6);
+
+    data->deferBindingUpdates = false;
+    object->setProperty("input", 3);
+    QCOMPARE(inner->property("doubled").toInt(), 6);
+    QCOMPARE(inner->property("tripled").toInt(), 9);
+}
+
+void tst_qqmlbinding::simpleBindings()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("simpleBindings.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QVERIFY2(object, qPrintable(c.errorString()));
+
+    // All bindings except for the literal width are simple, including the property
+    // copy "inner: innerItem".
+    QQmlRefPointer<QV4::ExecutableCompilationUnit> unit = QQmlComponentPrivate::get(&c)->compilationUnit;
+    QVERIFY(unit);
+    QCOMPARE(int(unit->qmlData->nSimpleBindings), 6);
+
+    QQuickItem *root = qobject_cast<QQuickItem *>(object.data());
+    QVERIFY(root);
+    QQuickItem *inner = root->property("inner").value<QQuickItem *>();
+    QVERIFY(inner);
+
+    QCOMPARE(inner->width(), 100.0);
+    QCOMPARE(inner->height(), 15.0);
+    QCOMPARE(inner->property("hidden").toBool(), false);
+    QCOMPARE(inner->property("half").toReal(), 2.5);
+    // Not a number, so this one is left to JavaScript
+    QCOMPARE(inner->property("label").toString(), QStringLiteral("abc1"));
+
+    root->setWidth(200);
+    root->setProperty("value", 7);
+    root->setProperty("enabledFlag", false);
+    root->setProperty("name", QStringLiteral("x"));
+    QCOMPARE(inner->width(), 200.0);
+    QCOMPARE(inner->height(), 17.0);
+    QCOMPARE(inner->property("hidden").toBool(), true);
+    QCOMPARE(inner->property("half").toReal(), 3.5);
+    QCOMPARE(inner->property("label").toString(), QStringLiteral("x1"));
+
+    // "parent" is read on every update, so the binding follows a new parent item
+    QQuickItem otherParent;
+    otherParent.setWidth(42);
+    inner->setParentItem(&otherParent);
+    QCOMPARE(inner->width(), 42.0);
+    otherParent.setWidth(43);
+    QCOMPARE(inner->width(), 43.0);
+    root->setWidth(300);
+    QCOMPARE(inner->width(), 43.0);
+
+    inner->setParentItem(root);
+    QCOMPARE(inner->width(), 300.0);
+}
+
 QTEST_MAIN(tst_qqmlbinding)
 
 #include "tst_qqmlbinding.moc"
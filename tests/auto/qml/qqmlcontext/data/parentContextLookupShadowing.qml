@@ -0,0 +1,7 @@
+import QtQml 2.2
+
+QtObject {
+    property Component delegate: QtObject {
+        property int fromContextProperty: contextValue
+    }
+}
@@ -0,0 +1,12 @@
+import QtQml 2.2
+
+QtObject {
+    id: root
+    property int value: 1
+
+    property Component delegate: QtObject {
+        property int fromId: root.value
+        property int fromContextProperty: contextValue
+        property int fromContextObject: a
+    }
+}
@@ -72,6 +72,8 @@ private slots:
     void outerContextObject();
     void contextObjectHierarchy();
     void destroyContextProperty();
+    void parentContextLookups();
+    void parentContextLookupShadowing();
 
 private:
     QQmlEngine engine;
@@ -907,6 +909,92 @@ void tst_qqmlcontext::destroyContextProperty()
     QCOMPARE(qvariant_cast<QObject *>(context.contextProperty(QLatin1String("a"))), nullptr);
 }
 
+void tst_qqmlcontext::parentContextLookups()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("parentContextLookups.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    TestObject contextObject1;
+    contextObject1.setA(3);
+    QQmlContext context1(engine.rootContext());
+    context1.setContextObject(&contextObject1);
+    context1.setContextProperty(QLatin1String("contextValue"), 2);
+
+    TestObject contextObject2;
+    contextObject2.setA(30);
+    QQmlContext context2(engine.rootContext());
+    context2.setContextObject(&contextObject2);
+    context2.setContextProperty(QLatin1String("contextValue"), 20);
+
+    QScopedPointer<QObject> root1(component.create(&context1));
+    QVERIFY(!root1.isNull());
+    QScopedPointer<QObject> root2(component.create(&context2));
+    QVERIFY(!root2.isNull());
+    root2->setProperty("value", 10);
+
+    const auto createDelegate = [](QObject *root) {
+        QQmlComponent *delegate = qvariant_cast<QQmlComponent *>(root->property("delegate"));
+        return delegate->create(delegate->creationContext());
+    };
+
+    // The delegates share their lookups, but are created in different contexts
+    for (int i = 0; i < 3; ++i) {
+        QScopedPointer<QObject> delegate1(createDelegate(root1.data()));
+        QVERIFY(!delegate1.isNull());
+        QCOMPARE(delegate1->property("fromId").toInt(), 1);
+        QCOMPARE(delegate1->property("fromContextProperty").toInt(), 2);
+        QCOMPARE(delegate1->property("fromContextObject").toInt(), 3);
+
+        QScopedPointer<QObject> delegate2(createDelegate(root2.data()));
+        QVERIFY(!delegate2.isNull());
+        QCOMPARE(delegate2->property("fromId").toInt(), 10);
+        QCOMPARE(delegate2->property("fromContextProperty").toInt(), 20);
+        QCOMPARE(delegate2->property("fromContextObject").toInt(), 30);
+    }
+
+    QScopedPointer<QObject> delegate(createDelegate(root1.data()));
+    QVERIFY(!delegate.isNull());
+    root1->setProperty("value", 4);
+    QCOMPARE(delegate->property("fromId").toInt(), 4);
+    context1.setContextProperty(QLatin1String("contextValue"), 5);
+    QCOMPARE(delegate->property("fromContextProperty").toInt(), 5);
+    contextObject1.setA(6);
+    QCOMPARE(delegate->property("fromContextObject").toInt(), 6);
+}
+
+void tst_qqmlcontext::parentContextLookupShadowing()
+{
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty(QLatin1String("contextValue"), 1);
+    QQmlComponent component(&engine, testFileUrl("parentContextLookupShadowing.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QQmlContext context(engine.rootContext());
+    QScopedPointer<QObject> root(component.create(&context));
+    QVERIFY(!root.isNull());
+
+    QQmlComponent *delegate = qvariant_cast<QQmlComponent *>(root->property("delegate"));
+    QVERIFY(delegate);
+    QScopedPointer<QObject> delegate1(delegate->create(delegate->creationContext()));
+    QVERIFY(!delegate1.isNull());
+    QCOMPARE(delegate1->property("fromContextProperty").toInt(), 1);
+
+    // The second delegate is resolved through the cached lookup
+    QScopedPointer<QObject> delegate2(delegate->create(delegate->creationContext()));
+    QVERIFY(!delegate2.isNull());
+    QCOMPARE(delegate2->property("fromContextProperty").toInt(), 1);
+
+    // A closer context property shadows the one of the root context from now on
+    context.setContextProperty(QLatin1String("contextValue"), 2);
+    QCOMPARE(delegate1->property("fromContextProperty").toInt(), 2);
+    QCOMPARE(delegate2->property("fromContextProperty").toInt(), 2);
+
+    QScopedPointer<QObject> delegate3(delegate->create(delegate->creationContext()));
+    QVERIFY(!delegate3.isNull());
+    QCOMPARE(delegate3->property("fromContextProperty").toInt(), 2);
+}
+
 QTEST_MAIN(tst_qqmlcontext)
 
 #include "tst_qqmlcontext.moc"
@@ -0,0 +1,14 @@
+import QtQml 2.0
+
+QtObject {
+    property int a: 1
+    property int x: 1
+    property int left: a * 2
+    property int right: a * 3 + x
+    property int sum: left + right
+    property int sumChanges: 0
+    onSumChanged: ++sumChanges
+
+    property int loopA: loopB + 1
+    property int loopB: loopA + 1
+}
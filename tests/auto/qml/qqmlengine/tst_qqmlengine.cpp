@@ -83,6 +83,7 @@ private slots:
     void singletonInstance();
     void aggressiveGc();
     void cachedGetterLookup_qtbug_75335();
+    void propertyUpdateBatch();
 
 public slots:
     QObject *createAQObjectForOwnershipTest ()
@@ -1131,6 +1132,50 @@ void tst_qqmlengine::cachedGetterLookup_qtbug_75335()
     QVERIFY(object != nullptr);
 }
 
+void tst_qqmlengine::propertyUpdateBatch()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("propertyUpdateBatch.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object != nullptr);
+    QCOMPARE(object->property("sum").toInt(), 6);
+    object->setProperty("sumChanges", 0);
+
+    // Without a batch, sum is updated once for each of its dependencies
+    object->setProperty("a", 2);
+    QCOMPARE(object->property("sum").toInt(), 11);
+    QCOMPARE(object->property("sumChanges").toInt(), 2);
+    object->setProperty("sumChanges", 0);
+
+    engine.beginPropertyUpdateBatch();
+    object->setProperty("a", 3);
+    object->setProperty("x", 2);
+    engine.beginPropertyUpdateBatch();
+    object->setProperty("a", 4);
+    engine.endPropertyUpdateBatch();
+    QCOMPARE(object->property("sum").toInt(), 11);
+    QCOMPARE(object->property("sumChanges").toInt(), 0);
+    engine.endPropertyUpdateBatch();
+    QCOMPARE(object->property("sum").toInt(), 22);
+    QCOMPARE(object->property("sumChanges").toInt(), 1);
+
+    // Binding loops are still detected
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*Binding loop detected.*"));
+    engine.beginPropertyUpdateBatch();
+    object->setProperty("loopA", 10);
+    engine.endPropertyUpdateBatch();
+
+    // Objects deleted with pending bindings are dropped from the batch
+    engine.beginPropertyUpdateBatch();
+    object->setProperty("a", 5);
+    object.reset();
+    engine.endPropertyUpdateBatch();
+
+    QTest::ignoreMessage(QtWarningMsg, "QQmlEngine::endPropertyUpdateBatch: No batch of property updates was started");
+    engine.endPropertyUpdateBatch();
+}
+
 QTEST_MAIN(tst_qqmlengine)
 
 #include "tst_qqmlengine.moc"
@@ -0,0 +1,6 @@
+import QtQml 2.0
+
+First {
+    function twice(x) { return 2 * x; }
+    property int doubled: twice(value)
+}
@@ -0,0 +1,6 @@
+import QtQml 2.0
+
+QtObject {
+    property int value: nested.doubled
+    property QtObject nested: Second { value: 5 }
+}
@@ -0,0 +1,8 @@
+import QtQml 2.0
+
+QtObject {
+    property QtObject a: First { value: 1 }
+    property QtObject b: Second { value: 2 }
+    property QtObject c: Third {}
+    property int sum: a.value + b.value + c.value + c.nested.value
+}
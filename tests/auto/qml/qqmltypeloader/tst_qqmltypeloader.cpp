@@ -60,6 +60,7 @@ private slots:
     void implicitComponentModule();
     void qrcRootPathUrl();
     void implicitImport();
+    void parallelParsing();
 
 private:
     void checkSingleton(const QString & dataDirectory);
@@ -539,6 +540,43 @@ void tst_QQMLTypeLoader::implicitImport()
     QVERIFY(!obj.isNull());
 }
 
+void tst_QQMLTypeLoader::parallelParsing()
+{
+#if QT_CONFIG(process)
+    // The thread pool is only created by type loaders constructed with the variable set.
+    const char *parallelParsingKey = "QML_PARALLEL_PARSING";
+    if (!qEnvironmentVariableIsSet(parallelParsingKey)) {
+#ifdef Q_OS_ANDROID
+        QSKIP("Android seems to have problems with QProcess");
+#endif
+        QProcess child;
+        child.setProgram(QCoreApplication::applicationFilePath());
+        child.setArguments(QStringList(QLatin1String("parallelParsing")));
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QLatin1String(parallelParsingKey), QLatin1String("1"));
+        env.insert(QLatin1String("QML_DISABLE_DISK_CACHE"), QLatin1String("1"));
+        child.setProcessEnvironment(env);
+        child.start();
+        QVERIFY(child.waitForFinished());
+        QCOMPARE(child.exitCode(), 0);
+        return;
+    }
+#endif
+
+    QQmlEngine engine;
+
+    QQmlComponent component(&engine, testFileUrl("parallelParsing/main.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QObject> obj(component.create());
+    QVERIFY(!obj.isNull());
+    QCOMPARE(obj->property("sum").toInt(), 18);
+
+    QQmlComponent broken(&engine, testFileUrl("parallelParsing/syntaxError.qml"));
+    QVERIFY(broken.isError());
+    QVERIFY2(broken.errorString().contains(QLatin1String("Broken.qml:5")),
+             qPrintable(broken.errorString()));
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
@@ -0,0 +1,9 @@
+WorkerScript.onMessage = function(msg) {
+    Atomics.store(msg.shared, 0, msg.view[0] + msg.view[1]);
+    msg.view[0] = 10;
+    WorkerScript.sendMessage({
+        view: msg.view,
+        sum: msg.view[0] + msg.view[1],
+        copied: Array.prototype.join.call(msg.copied)
+    }, [msg.view.buffer]);
+}
@@ -0,0 +1,5 @@
+WorkerScript.onMessage = function(msg) {
+    if (msg.fail)
+        throw new Error("job failed");
+    WorkerScript.sendMessage(msg * msg);
+}
@@ -0,0 +1,5 @@
+throw new Error("broken");
+
+WorkerScript.onMessage = function(message) {
+    WorkerScript.sendMessage(message);
+}
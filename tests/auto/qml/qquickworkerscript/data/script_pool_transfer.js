@@ -0,0 +1,9 @@
+var worker = Math.random();
+
+WorkerScript.onMessage = function(msg) {
+    var bytes = new Uint8Array(msg.buffer);
+    var sum = 0;
+    for (var i = 0; i < bytes.length; ++i)
+        sum += bytes[i];
+    WorkerScript.sendMessage({ sum: sum, worker: worker });
+}
@@ -0,0 +1,40 @@
+import QtQuick 2.0
+
+WorkerScript {
+    id: worker
+    source: "script_arraybuffer.js"
+
+    property var shared: new SharedArrayBuffer(16)
+    property bool transferredDetached: false
+    property var response
+
+    signal done()
+
+    function testSend() {
+        var buffer = new ArrayBuffer(8);
+        var view = new Int32Array(buffer);
+        view[0] = 1;
+        view[1] = 2;
+        var copied = new Uint8Array([7, 8, 9]);
+        worker.sendMessage({ view: view, copied: copied, shared: new Int32Array(shared) }, [buffer]);
+        try {
+            buffer.byteLength;
+        } catch (e) {
+            transferredDetached = true;
+        }
+        copied[0] = 0;
+    }
+
+    function sharedValue() {
+        return Atomics.load(new Int32Array(shared), 0);
+    }
+
+    function responseString() {
+        return [response.sum, response.view.length, response.view[0], response.copied].join("|");
+    }
+
+    onMessage: {
+        worker.response = messageObject
+        worker.done()
+    }
+}
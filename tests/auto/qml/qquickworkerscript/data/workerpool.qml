@@ -0,0 +1,28 @@
+import QtQml 2.15
+import QtQml.WorkerScript 2.15
+
+WorkerPool {
+    id: pool
+    source: "script_pool.js"
+    count: 3
+
+    property var results: []
+    property var batches: []
+
+    signal done()
+
+    function testDispatch() {
+        var first = [];
+        for (var i = 0; i < 10; ++i)
+            first.push(i);
+        pool.dispatch(first);
+        pool.dispatch([{ fail: true }, 20]);
+    }
+
+    onFinished: (results, batch) => {
+        pool.batches.push(batch);
+        pool.results[batch] = Array.prototype.join.call(results, ",");
+        if (pool.batches.length === 2)
+            pool.done();
+    }
+}
@@ -0,0 +1,24 @@
+import QtQml 2.15
+import QtQml.WorkerScript 2.15
+
+WorkerPool {
+    id: pool
+    source: "script_pool_error.js"
+    count: 2
+
+    property int undefinedResults: 0
+
+    signal done()
+
+    function testDispatch() {
+        pool.dispatch([1, 2, 3, 4, 5]);
+    }
+
+    onFinished: (results) => {
+        for (var i = 0; i < results.length; ++i) {
+            if (results[i] === undefined)
+                ++pool.undefinedResults;
+        }
+        pool.done();
+    }
+}
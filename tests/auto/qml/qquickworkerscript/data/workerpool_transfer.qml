@@ -0,0 +1,49 @@
+import QtQml 2.15
+import QtQml.WorkerScript 2.15
+
+WorkerPool {
+    id: pool
+    source: "script_pool_transfer.js"
+    count: 3
+
+    property string sums
+    property int workersUsed: 0
+    property int detachedBuffers: 0
+
+    signal done()
+
+    function testDispatch() {
+        var messages = [];
+        var buffers = [];
+        for (var i = 0; i < 6; ++i) {
+            var bytes = new Uint8Array(4);
+            bytes.fill(i + 1);
+            messages.push({ buffer: bytes.buffer });
+            buffers.push(bytes.buffer);
+        }
+        // Listed for transfer, but not referenced by any message
+        buffers.push(new ArrayBuffer(4));
+        pool.dispatch(messages, buffers);
+
+        for (var j = 0; j < buffers.length; ++j) {
+            try {
+                buffers[j].byteLength;
+            } catch (e) {
+                ++pool.detachedBuffers;
+            }
+        }
+    }
+
+    onFinished: (results) => {
+        var sums = [];
+        var workers = [];
+        for (var i = 0; i < results.length; ++i) {
+            sums.push(results[i].sum);
+            if (workers.indexOf(results[i].worker) === -1)
+                workers.push(results[i].worker);
+        }
+        pool.sums = sums.join(",");
+        pool.workersUsed = workers.length;
+        pool.done();
+    }
+}
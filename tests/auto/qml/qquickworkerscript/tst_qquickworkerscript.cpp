@@ -31,12 +31,14 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qregularexpression.h>
+#include <QtTest/qsignalspy.h>
 #include <QtQml/qjsengine.h>
 
 #include <QtQml/qqmlcomponent.h>
 #include <QtQml/qqmlengine.h>
 
 #include <private/qquickworkerscript_p.h>
+#include <private/qquickworkerpool_p.h>
 #include <private/qqmlengine_p.h>
 #include "../../shared/util.h"
 
@@ -52,6 +54,10 @@ private slots:
     void messaging_sendQObjectList();
     void messaging_sendJsObject();
     void messaging_sendExternalObject();
+    void messaging_arrayBuffers();
+    void workerPool();
+    void workerPoolTransfer();
+    void workerPoolLoadError();
     void script_with_pragma();
     void script_included();
     void scriptError_onLoad();
@@ -215,6 +221,87 @@ void tst_QQuickWorkerScript::messaging_sendExternalObject()
     delete obj;
 }
 
+void tst_QQuickWorkerScript::messaging_arrayBuffers()
+{
+    QQmlComponent component(&m_engine, testFileUrl("worker_arraybuffer.qml"));
+    QScopedPointer<QQuickWorkerScript> worker(qobject_cast<QQuickWorkerScript*>(component.create()));
+    QVERIFY(worker);
+
+    QVERIFY(QMetaObject::invokeMethod(worker.data(), "testSend"));
+    QVERIFY(worker->property("transferredDetached").toBool());
+    waitForEchoMessage(worker.data());
+
+    QVariant response;
+    QVERIFY(QMetaObject::invokeMethod(worker.data(), "responseString", Qt::DirectConnection,
+                                      Q_RETURN_ARG(QVariant, response)));
+    QCOMPARE(response.toString(), QStringLiteral("12|2|10|7,8,9"));
+
+    QVariant shared;
+    QVERIFY(QMetaObject::invokeMethod(worker.data(), "sharedValue", Qt::DirectConnection,
+                                      Q_RETURN_ARG(QVariant, shared)));
+    QCOMPARE(shared.toInt(), 3);
+}
+
+void tst_QQuickWorkerScript::workerPool()
+{
+    // A fresh engine, so that no threads were started by other tests
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("workerpool.qml"));
+    QScopedPointer<QQuickWorkerPool> pool(qobject_cast<QQuickWorkerPool*>(component.create()));
+    QVERIFY(pool);
+    QCOMPARE(pool->count(), 3);
+
+    QSignalSpy spy(pool.data(), SIGNAL(done()));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*job failed"));
+    QVERIFY(QMetaObject::invokeMethod(pool.data(), "testDispatch"));
+    QCOMPARE(pool->pending(), 12);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(pool->pending(), 0);
+
+    const QVariantList results = pool->property("results").toList();
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(results.at(0).toString(), QStringLiteral("0,1,4,9,16,25,36,49,64,81"));
+    QCOMPARE(results.at(1).toString(), QStringLiteral(",400"));
+
+    // Each of the three workers gets a thread of its own, as far as the maximum allows.
+    QQuickWorkerScriptEnginePool *threads = QQuickWorkerScriptEnginePool::get(&engine);
+    QCOMPARE(threads->threadCount(), qMin(3, threads->maximumThreadCount()));
+}
+
+void tst_QQuickWorkerScript::workerPoolTransfer()
+{
+    QQmlComponent component(&m_engine, testFileUrl("workerpool_transfer.qml"));
+    QScopedPointer<QQuickWorkerPool> pool(qobject_cast<QQuickWorkerPool*>(component.create()));
+    QVERIFY(pool);
+
+    QSignalSpy spy(pool.data(), SIGNAL(done()));
+    QVERIFY(QMetaObject::invokeMethod(pool.data(), "testDispatch"));
+    QCOMPARE(pool->property("detachedBuffers").toInt(), 7);
+    QTRY_COMPARE(spy.count(), 1);
+
+    // Every message received the buffer transferred with it.
+    QCOMPARE(pool->property("sums").toString(), QStringLiteral("4,8,12,16,20,24"));
+    // The first three jobs are handed to the three idle workers right away.
+    QCOMPARE(pool->property("workersUsed").toInt(), 3);
+}
+
+void tst_QQuickWorkerScript::workerPoolLoadError()
+{
+    QQmlComponent component(&m_engine, testFileUrl("workerpool_loaderror.qml"));
+    QScopedPointer<QQuickWorkerPool> pool(qobject_cast<QQuickWorkerPool*>(component.create()));
+    QVERIFY(pool);
+    QCOMPARE(pool->count(), 2);
+
+    // Each worker reports the error, and the jobs still complete.
+    QSignalSpy spy(pool.data(), SIGNAL(done()));
+    for (int i = 0; i < pool->count(); ++i)
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*script_pool_error.js.*broken"));
+    QVERIFY(QMetaObject::invokeMethod(pool.data(), "testDispatch"));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(pool->pending(), 0);
+    QCOMPARE(pool->property("undefinedResults").toInt(), 5);
+}
+
 void tst_QQuickWorkerScript::script_with_pragma()
 {
     QVariant value(100);
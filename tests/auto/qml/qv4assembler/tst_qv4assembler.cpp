@@ -34,7 +34,11 @@
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlapplicationengine.h>
 
+#include <QtQml/qjsengine.h>
+
 #include <private/qv4global_p.h>
+#include <private/qjsvalue_p.h>
+#include <private/qv4functionobject_p.h>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -49,6 +53,9 @@ private slots:
     void perfMapFile();
     void functionTable();
     void jitEnabled();
+    void typeFeedback();
+    void mathBuiltins();
+    void onStackReplacement();
 };
 
 void tst_QV4Assembler::initTestCase()
@@ -154,6 +161,149 @@ void tst_QV4Assembler::jitEnabled()
 #endif
 }
 
+void tst_QV4Assembler::typeFeedback()
+{
+#if !QT_CONFIG(qml_jit)
+    QSKIP("Type feedback is only used by the JIT.");
+#else
+    qputenv("QV4_JIT_OPTIMIZE_CALL_THRESHOLD", "10");
+    QJSEngine engine;
+    qunsetenv("QV4_JIT_OPTIMIZE_CALL_THRESHOLD");
+
+    // b is stored inline, z in the member data of the object
+    QJSValue sum = engine.evaluate(QStringLiteral(
+            "(function(o) { return o.b + o.z; })"));
+    QVERIFY(sum.isCallable());
+    QJSValue makeObject = engine.evaluate(QStringLiteral(
+            "(function(i) {\n"
+            "    var o = { a: 0, b: i };\n"
+            "    for (var c = 0; c < 26; ++c)\n"
+            "        o[String.fromCharCode(99 + c)] = c;\n"
+            "    return o;\n"
+            "})"));
+    QVERIFY(makeObject.isCallable());
+
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(sum.call({makeObject.call({i})}).toInt(), i + 23);
+
+    QV4::Function *function = QJSValuePrivate::getValue(&sum)->as<QV4::FunctionObject>()->function();
+    QVERIFY(function->hasOptimizedCode);
+
+    // Objects of other shapes have to take the generic path
+    QCOMPARE(sum.call({engine.evaluate(QStringLiteral("({ z: 1, b: 2 })"))}).toInt(), 3);
+    QCOMPARE(sum.call({engine.evaluate(QStringLiteral("({ b: 'x', z: 'y' })"))}).toString(),
+             QStringLiteral("xy"));
+    QVERIFY(qIsNaN(sum.call({QJSValue(5)}).toNumber()));
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(sum.call({makeObject.call({i})}).toInt(), i + 23);
+#endif
+}
+
+void tst_QV4Assembler::mathBuiltins()
+{
+#if !QT_CONFIG(qml_jit)
+    QSKIP("Math builtins are only inlined by the JIT.");
+#else
+    qputenv("QV4_JIT_OPTIMIZE_CALL_THRESHOLD", "10");
+    QJSEngine engine;
+    qunsetenv("QV4_JIT_OPTIMIZE_CALL_THRESHOLD");
+
+    QJSValue ops = engine.evaluate(QStringLiteral(
+            "(function(a, b) {\n"
+            "    return [Math.floor(a), Math.ceil(a), Math.abs(a), Math.sqrt(a),\n"
+            "            Math.min(a, b), Math.max(a, b)];\n"
+            "})"));
+    QVERIFY(ops.isCallable());
+    QJSValue reference = engine.evaluate(QStringLiteral(
+            "(function(a, b) {\n"
+            "    return [Math.floor.call(Math, a), Math.ceil.call(Math, a), Math.abs.call(Math, a),\n"
+            "            Math.sqrt.call(Math, a), Math.min.call(Math, a, b), Math.max.call(Math, a, b)];\n"
+            "})"));
+    QVERIFY(reference.isCallable());
+    QJSValue compare = engine.evaluate(QStringLiteral(
+            "(function(ops, reference) {\n"
+            "    var values = [0, -0, 1, -1, 2.5, -2.5, 0.5, -0.5, 3, 3.0000001, NaN, Infinity,\n"
+            "                  -Infinity, 2147483647, -2147483648, 2147483647.5, -2147483648.5,\n"
+            "                  1e10, -1e10, '4', null, undefined];\n"
+            "    for (var i = 0; i < values.length; ++i) {\n"
+            "        for (var j = 0; j < values.length; ++j) {\n"
+            "            var x = ops(values[i], values[j]);\n"
+            "            var y = reference(values[i], values[j]);\n"
+            "            for (var k = 0; k < x.length; ++k) {\n"
+            "                if (!Object.is(x[k], y[k]))\n"
+            "                    return i + ', ' + j + ': ' + k;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "    return '';\n"
+            "})"));
+    QVERIFY(compare.isCallable());
+
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(ops.call({i, 10}).property(4).toInt(), qMin(i, 10));
+
+    QV4::Function *function = QJSValuePrivate::getValue(&ops)->as<QV4::FunctionObject>()->function();
+    QVERIFY(function->hasOptimizedCode);
+    QCOMPARE(compare.call({ops, reference}).toString(), QString());
+
+    // Replaced builtins have to be called
+    engine.evaluate(QStringLiteral("Math.floor = function() { return 42; }; Math.min = Math.max;"));
+    QJSValue result = ops.call({1.5, 2});
+    QCOMPARE(result.property(0).toInt(), 42);
+    QCOMPARE(result.property(4).toInt(), 2);
+#endif
+}
+
+void tst_QV4Assembler::onStackReplacement()
+{
+#if !QT_CONFIG(qml_jit)
+    QSKIP("On-stack replacement is only used by the JIT.");
+#else
+    qputenv("QV4_JIT_CALL_THRESHOLD", "1000");
+    qputenv("QV4_JIT_OSR_THRESHOLD", "100");
+    QJSEngine engine;
+    qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    qunsetenv("QV4_JIT_OSR_THRESHOLD");
+
+    QJSValue loops = engine.evaluate(QStringLiteral(
+            "(function(n) {\n"
+            "    var sum = 0;\n"
+            "    for (var i = 0; i < n; ++i)\n"
+            "        sum += i;\n"
+            "    var j = 0;\n"
+            "    do {\n"
+            "        sum -= j;\n"
+            "    } while (++j < n);\n"
+            "    return sum + n;\n"
+            "})"));
+    QVERIFY(loops.isCallable());
+    QV4::Function *function = QJSValuePrivate::getValue(&loops)->as<QV4::FunctionObject>()->function();
+
+    QCOMPARE(loops.call({10}).toInt(), 10);
+    QVERIFY(function->jittedCode == nullptr);
+    QCOMPARE(loops.call({5000}).toInt(), 5000);
+    QVERIFY(function->jittedCode != nullptr);
+    QVERIFY(function->osrEntry != nullptr);
+
+    // Loops inside exception handlers keep running in the interpreter
+    QJSValue tryLoop = engine.evaluate(QStringLiteral(
+            "(function(n) {\n"
+            "    var sum = 0;\n"
+            "    try {\n"
+            "        for (var i = 0; i < n; ++i) {\n"
+            "            if (i === n - 1)\n"
+            "                throw sum;\n"
+            "            sum += 2;\n"
+            "        }\n"
+            "    } catch (e) {\n"
+            "        return e + 1;\n"
+            "    }\n"
+            "})"));
+    QVERIFY(tryLoop.isCallable());
+    QCOMPARE(tryLoop.call({5000}).toInt(), 9999);
+#endif
+}
+
 QTEST_MAIN(tst_QV4Assembler)
 
 #include "tst_qv4assembler.moc"
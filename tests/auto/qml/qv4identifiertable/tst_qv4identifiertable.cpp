@@ -42,6 +42,7 @@ private slots:
     void dontSweepAcrossBucketBoundaries();
     void sweepAcrossBucketBoundariesIfFirstBucketFull();
     void sweepBucketGap();
+    void sharedStrings();
 };
 
 void tst_qv4identifiertable::sweepFirstEntryInBucket()
@@ -358,6 +359,37 @@ void tst_qv4identifiertable::sweepBucketGap()
     QCOMPARE(table.entriesByHash[3], nullptr);
 }
 
+void tst_qv4identifiertable::sharedStrings()
+{
+    QV4::ExecutionEngine engine1;
+    QV4::ExecutionEngine engine2;
+
+    const QString name = QStringLiteral("sharedIdentifier");
+    QV4::Heap::String *string1 = engine1.identifierTable->insertSharedString(name);
+    QV4::Heap::String *string2 = engine2.identifierTable->insertSharedString(QString(name.constData(), name.length()));
+    QVERIFY(string1);
+    QVERIFY(string2);
+
+    // Each engine has its own string, with the same text and hash
+    QVERIFY(string1 != string2);
+    QCOMPARE(string1->text, string2->text);
+    QCOMPARE(string1->stringHash, string2->stringHash);
+    QVERIFY(string1->identifier.isValid());
+    QCOMPARE(string1->toQString(), name);
+
+    // Within one engine, it is the same identifier
+    QCOMPARE(engine1.identifierTable->insertSharedString(name), string1);
+    QCOMPARE(engine1.identifierTable->asPropertyKey(name), string1->identifier);
+
+    // Identifiers created by the engine before are reused
+    QV4::Heap::String *length = engine1.identifierTable->insertSharedString(QStringLiteral("length"));
+    QCOMPARE(length, engine1.id_length()->d());
+
+    // Array indices and long strings are not shared
+    QVERIFY(!engine1.identifierTable->insertSharedString(QStringLiteral("42")));
+    QVERIFY(!engine1.identifierTable->insertSharedString(QString(QV4::SharedIdentifierTable::MaxLength + 1, QLatin1Char('x'))));
+}
+
 QTEST_MAIN(tst_qv4identifiertable)
 
 #include "tst_qv4identifiertable.moc"
@@ -30,6 +30,10 @@
 #include <QQmlEngine>
 #include <QLoggingCategory>
 #include <QQmlComponent>
+#include <QJSEngine>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #include <private/qv4mm_p.h>
 #include <private/qv4qobjectwrapper_p.h>
@@ -48,6 +52,10 @@ private slots:
     void multiWrappedQObjects();
     void accessParentOnDestruction();
     void clearICParent();
+    void generationalGC();
+    void incrementalGC();
+    void concurrentSweep();
+    void heapSnapshot();
 };
 
 void tst_qv4mm::gcStats()
@@ -148,6 +156,190 @@ void tst_qv4mm::clearICParent()
     QFAIL("Garbage collector was not triggered by large amount of InternalClasses");
 }
 
+void tst_qv4mm::generationalGC()
+{
+    qputenv(QV4_MM_GENERATIONAL_GC, "1");
+    QJSEngine jsEngine;
+    qunsetenv(QV4_MM_GENERATIONAL_GC);
+
+    QV4::ExecutionEngine *engine = jsEngine.handle();
+    QV4::MemoryManager *mm = engine->memoryManager;
+    QVERIFY(mm->generationalGC);
+    QVERIFY(engine->writeBarrierActive);
+
+    jsEngine.evaluate(QStringLiteral("var holder = { items: [] }; var map = new Map();"));
+    mm->runGC(QV4::MemoryManager::FullGC);
+
+    // holder and map are old now, everything referenced from them below is young
+    QJSValue result = jsEngine.evaluate(QStringLiteral(
+            "for (var i = 0; i < 100; ++i) {\n"
+            "    holder.items.push({ value: i });\n"
+            "    map.set(i, { value: i });\n"
+            "}\n"
+            "for (var j = 0; j < 10000; ++j)\n"
+            "    var garbage = { value: j };\n"));
+    QVERIFY(!result.isError());
+
+    const size_t usedBefore = mm->getUsedMem();
+    mm->runGC(QV4::MemoryManager::MinorGC);
+    QVERIFY(mm->getUsedMem() < usedBefore);
+    QCOMPARE(mm->minorGCsSinceLastFullGC, 1u);
+
+    result = jsEngine.evaluate(QStringLiteral(
+            "holder.items.length === 100 && map.size === 100\n"
+            "    && holder.items.every(function(o, i) { return o.value === i; })\n"
+            "    && holder.items.every(function(o, i) { return map.get(i).value === i; })"));
+    QVERIFY(result.toBool());
+
+    mm->runGC(QV4::MemoryManager::FullGC);
+    QCOMPARE(mm->minorGCsSinceLastFullGC, 0u);
+    result = jsEngine.evaluate(QStringLiteral("holder.items[99].value + map.get(99).value"));
+    QCOMPARE(result.toInt(), 198);
+}
+
+void tst_qv4mm::incrementalGC()
+{
+    qputenv(QV4_MM_INCREMENTAL_GC, "1");
+    QJSEngine jsEngine;
+    qunsetenv(QV4_MM_INCREMENTAL_GC);
+
+    QV4::ExecutionEngine *engine = jsEngine.handle();
+    QV4::MemoryManager *mm = engine->memoryManager;
+    QVERIFY(mm->incrementalGC);
+    QVERIFY(!engine->writeBarrierActive);
+
+    QJSValue result = jsEngine.evaluate(QStringLiteral(
+            "var holder = { items: [] };\n"
+            "for (var i = 0; i < 1000; ++i)\n"
+            "    holder.items.push({ value: i });\n"));
+    QVERIFY(!result.isError());
+
+    mm->startIncrementalGC();
+    QVERIFY(mm->isIncrementalGCRunning());
+    QVERIFY(engine->writeBarrierActive);
+
+    // Move objects around while marking is in progress, the write barrier needs to
+    // keep them alive.
+    int slices = 0;
+    bool running = true;
+    while (running && slices < 10000) {
+        result = jsEngine.evaluate(QStringLiteral(
+                "holder.items.push({ value: holder.items.shift().value });"));
+        QVERIFY(!result.isError());
+        running = mm->runIncrementalGCSlice(100);
+        ++slices;
+    }
+
+    // The cycle has to complete through the slices alone.
+    QVERIFY(!running);
+    QVERIFY(slices > 0);
+    QVERIFY(!mm->isIncrementalGCRunning());
+    QVERIFY(!engine->writeBarrierActive);
+
+    result = jsEngine.evaluate(QStringLiteral(
+            "holder.items.length === 1000 && holder.items.every(function(o) {\n"
+            "    return typeof o.value === 'number';\n"
+            "})"));
+    QVERIFY(result.toBool());
+}
+
+void tst_qv4mm::concurrentSweep()
+{
+    qputenv(QV4_MM_CONCURRENT_SWEEP, "1");
+    QJSEngine jsEngine;
+    qunsetenv(QV4_MM_CONCURRENT_SWEEP);
+
+    QV4::ExecutionEngine *engine = jsEngine.handle();
+    QV4::MemoryManager *mm = engine->memoryManager;
+    QVERIFY(mm->concurrentSweep);
+
+    QJSValue result = jsEngine.evaluate(QStringLiteral(
+            "var holder = [];\n"
+            "for (var i = 0; i < 10000; ++i) {\n"
+            "    var o = { value: i, name: 'item' + i };\n"
+            "    if (i % 10 == 0)\n"
+            "        holder.push(o);\n"
+            "}\n"));
+    QVERIFY(!result.isError());
+    QVERIFY(!mm->plainAllocator.chunks.empty());
+
+    mm->runGC();
+
+    // Allocate while the worker might still be sweeping
+    result = jsEngine.evaluate(QStringLiteral(
+            "for (var j = 0; j < 1000; ++j)\n"
+            "    holder.push({ value: j });\n"));
+    QVERIFY(!result.isError());
+
+    QVERIFY(mm->finishConcurrentSweep(/*wait*/true));
+    QVERIFY(!mm->plainAllocator.concurrentSweep);
+
+    mm->runGC();
+    QVERIFY(mm->finishConcurrentSweep(/*wait*/true));
+
+    result = jsEngine.evaluate(QStringLiteral(
+            "holder.length === 2000 && holder.every(function(o, i) {\n"
+            "    return i < 1000 ? (o.value === i * 10 && o.name === 'item' + o.value)\n"
+            "                    : o.value === i - 1000;\n"
+            "})"));
+    QVERIFY(result.toBool());
+}
+
+void tst_qv4mm::heapSnapshot()
+{
+    QJSEngine jsEngine;
+    QV4::MemoryManager *mm = jsEngine.handle()->memoryManager;
+
+    QJSValue result = jsEngine.evaluate(QStringLiteral(
+            "var leakHolder = { cache: [] };\n"
+            "leakHolder.cache.push(function leakedClosure() { return 42; });\n"
+            "for (var i = 0; i < 1000; ++i)\n"
+            "    var garbage = { value: i };\n"));
+    QVERIFY(!result.isError());
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    const qint64 written = mm->writeHeapSnapshot(&buffer);
+    QVERIFY(written > 0);
+
+    const QList<QByteArray> lines = buffer.data().split('\n');
+    QVERIFY(lines.length() > 3);
+    QCOMPARE(QJsonDocument::fromJson(lines.first()).object().value("snapshot").toInt(), 1);
+    QVERIFY(lines.last().isEmpty());
+    const QJsonObject trailer = QJsonDocument::fromJson(lines.at(lines.length() - 2)).object();
+    QVERIFY(trailer.value("end").toBool());
+    QCOMPARE(qint64(trailer.value("objects").toDouble()), written);
+    QCOMPARE(qint64(lines.length() - 3), written);
+
+    QHash<QString, QJsonObject> objects;
+    QString closure;
+    for (int i = 1; i < lines.length() - 2; ++i) {
+        const QJsonObject record = QJsonDocument::fromJson(lines.at(i)).object();
+        QVERIFY(record.value("size").toInt() > 0);
+        QVERIFY(!record.value("class").toString().isEmpty());
+        const QString id = record.value("id").toString();
+        objects.insert(id, record);
+        if (record.value("function").toString() == QLatin1String("leakedClosure"))
+            closure = id;
+    }
+    QVERIFY(!closure.isEmpty());
+
+    // The closure is held by the array, which is held by leakHolder, and so on up to a root.
+    QString current = closure;
+    int depth = 0;
+    for (; !objects.value(current).value("retainer").isNull(); ++depth) {
+        current = objects.value(current).value("retainer").toString();
+        QVERIFY(objects.contains(current));
+        QVERIFY(depth < 100);
+    }
+    QVERIFY(depth >= 2);
+
+    // The heap is still intact afterwards.
+    mm->runGC();
+    result = jsEngine.evaluate(QStringLiteral("leakHolder.cache[0]()"));
+    QCOMPARE(result.toInt(), 42);
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
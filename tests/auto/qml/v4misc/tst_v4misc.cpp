@@ -29,6 +29,8 @@
 #include <qtest.h>
 #include <private/qv4instr_moth_p.h>
 #include <private/qv4script_p.h>
+#include <private/qv4engine_p.h>
+#include <QtCore/qtimer.h>
 
 class tst_v4misc: public QObject
 {
@@ -38,6 +40,9 @@ private slots:
     void tdzOptimizations_data();
     void tdzOptimizations();
 
+    void scalarReplacement_data();
+    void scalarReplacement();
+
     void parserMisc_data();
     void parserMisc();
 
@@ -45,30 +50,15 @@ private slots:
     void subClassing();
 
     void nestingDepth();
-};
 
-void tst_v4misc::tdzOptimizations_data()
-{
-    QTest::addColumn<QString>("scriptToCompile");
-
-    QTest::newRow("access-after-let") << QString("let x; x = 10;");
-    QTest::newRow("access-after-const") << QString("const x = 10; print(x);");
-    QTest::newRow("access-after-let") << QString("for (let x of y) print(x);");
-}
+    void polymorphicLookups();
+    void polymorphicQObjectLookups();
+};
 
-void tst_v4misc::tdzOptimizations()
+static QVector<QV4::Moth::Instr::Type> instructionTypes(const QV4::CompiledData::Function *function)
 {
-    QFETCH(QString, scriptToCompile);
-
-    QV4::ExecutionEngine v4;
-    QV4::Script script(&v4, nullptr, /*parse as binding*/false, scriptToCompile);
-    script.parse();
-    QVERIFY(!v4.hasException);
-
-    const auto function = script.compilationUnit->unitData()->functionAt(0);
-    const auto *code = function->code();
-    const auto len = function->codeSize;
-    const char *end = code + len;
+    const char *code = function->code();
+    const char *end = code + function->codeSize;
 
     const auto decodeInstruction = [&code]() {
         QV4::Moth::Instr::Type type = QV4::Moth::Instr::Type(static_cast<uchar>(*code));
@@ -103,11 +93,98 @@ void tst_v4misc::tdzOptimizations()
         return type;
     };
 
-    while (code < end) {
-        QV4::Moth::Instr::Type type = decodeInstruction();
-        QVERIFY(type != QV4::Moth::Instr::Type::DeadTemporalZoneCheck);
+    QVector<QV4::Moth::Instr::Type> types;
+    while (code < end)
+        types.append(decodeInstruction());
+    return types;
+}
+
+void tst_v4misc::tdzOptimizations_data()
+{
+    QTest::addColumn<QString>("scriptToCompile");
+
+    QTest::newRow("access-after-let") << QString("let x; x = 10;");
+    QTest::newRow("access-after-const") << QString("const x = 10; print(x);");
+    QTest::newRow("access-after-let") << QString("for (let x of y) print(x);");
+}
+
+void tst_v4misc::tdzOptimizations()
+{
+    QFETCH(QString, scriptToCompile);
+
+    QV4::ExecutionEngine v4;
+    QV4::Script script(&v4, nullptr, /*parse as binding*/false, scriptToCompile);
+    script.parse();
+    QVERIFY(!v4.hasException);
+
+    const auto function = script.compilationUnit->unitData()->functionAt(0);
+    QVERIFY(!instructionTypes(function).contains(QV4::Moth::Instr::Type::DeadTemporalZoneCheck));
+}
+
+void tst_v4misc::scalarReplacement_data()
+{
+    QTest::addColumn<QString>("script");
+    QTest::addColumn<bool>("replaced");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("read-write") << QString("function f(a, b) { var p = { x: a, y: b }; p.x += 1; return p.x * p.y; } f(2, 3)")
+                                << true << QString("9");
+    QTest::newRow("loop") << QString("function f() { let p = { n: 0 }; for (let i = 0; i < 10; ++i) { p.n++; } return p.n; } f()")
+                          << true << QString("10");
+    QTest::newRow("function-name") << QString("function f() { const p = { g: function() {} }; return p.g.name; } f()")
+                                   << true << QString("g");
+    QTest::newRow("unused") << QString("function f() { var p = { x: 1 }; return 2; } f()")
+                            << true << QString("2");
+    QTest::newRow("returned") << QString("function f() { var p = { x: 1 }; return p; } f().x")
+                              << false << QString("1");
+    QTest::newRow("method-call") << QString("function f() { var p = { x: 1, g: function() { return this.x; } }; return p.g(); } f()")
+                                 << false << QString("1");
+    QTest::newRow("nested-method-call") << QString("function f() { var p = { x: 1, g: function() { return this.x; } }; return (p.g)(); } f()")
+                                        << false << QString("1");
+    QTest::newRow("inherited") << QString("function f() { var p = { x: 1 }; return p.hasOwnProperty('x'); } f()")
+                               << false << QString("true");
+    QTest::newRow("unknown-property") << QString("function f() { var p = { x: 1 }; p.y = 2; return p.x + p.y; } f()")
+                                      << false << QString("3");
+    QTest::newRow("delete") << QString("function f() { var p = { x: 1 }; delete p.x; return p.x; } f()")
+                            << false << QString("undefined");
+    QTest::newRow("closure") << QString("function f() { var p = { x: 1 }; return (function() { return p.x; })(); } f()")
+                             << false << QString("1");
+    QTest::newRow("use-before-init") << QString("function f(c) { if (c) return p.x; var p = { x: 1 }; return p.x; } f(false)")
+                                     << false << QString("1");
+    QTest::newRow("shadowed") << QString("function f() { var p = { x: 1 }; { let p = { x: 2 }; p.x++; } return p.x; } f()")
+                              << false << QString("1");
+    QTest::newRow("nested-declaration") << QString("function f(c) { if (c) { var p = { x: 1 }; return p.x; } return 0; } f(true)")
+                                        << false << QString("1");
+    QTest::newRow("eval") << QString("function f() { var p = { x: 1 }; return eval('p.x'); } f()")
+                          << false << QString("1");
+    QTest::newRow("getter") << QString("function f() { var p = { get x() { return 1; } }; return p.x; } f()")
+                            << false << QString("1");
+    QTest::newRow("proto") << QString("function f() { var p = { __proto__: { x: 1 } }; return p.__proto__.x; } f()")
+                           << false << QString("1");
+}
+
+void tst_v4misc::scalarReplacement()
+{
+    QFETCH(QString, script);
+    QFETCH(bool, replaced);
+    QFETCH(QString, result);
+
+    QV4::ExecutionEngine v4;
+    QV4::Script compiled(&v4, nullptr, /*parse as binding*/false, script);
+    compiled.parse();
+    QVERIFY(!v4.hasException);
+
+    const QV4::CompiledData::Unit *unit = compiled.compilationUnit->unitData();
+    const QV4::CompiledData::Function *function = nullptr;
+    for (uint i = 0; i < unit->functionTableSize; ++i) {
+        if (unit->stringAtInternal(unit->functionAt(i)->nameIndex) == QLatin1String("f"))
+            function = unit->functionAt(i);
     }
+    QVERIFY(function);
+    QCOMPARE(!instructionTypes(function).contains(QV4::Moth::Instr::Type::DefineObjectLiteral), replaced);
 
+    QJSEngine engine;
+    QCOMPARE(engine.evaluate(script).toString(), result);
 }
 
 void tst_v4misc::parserMisc_data()
@@ -197,6 +274,65 @@ void tst_v4misc::nestingDepth()
     }
 }
 
+void tst_v4misc::polymorphicLookups()
+{
+    const QString script = QStringLiteral(
+            "function get(o) { return o.x; }\n"
+            "function set(o, v) { o.x = v; }\n"
+            "var sum = 0;\n"
+            "for (var i = 0; i < 100; ++i) {\n"
+            "    for (var j = 0; j < shapes.length; ++j) {\n"
+            "        set(shapes[j], j + 1);\n"
+            "        sum += get(shapes[j]);\n"
+            "    }\n"
+            "}\n"
+            "sum\n");
+
+    {
+        QJSEngine engine;
+        QV4::ExecutionEngine *v4 = engine.handle();
+        engine.evaluate("var shapes = [ { x: 0 }, { a: 0, x: 0 }, { b: 0, x: 0 }, { c: 0, d: 0, x: 0 } ];");
+        QJSValue result = engine.evaluate(script);
+        QCOMPARE(result.toInt(), 1000);
+        QCOMPARE(v4->lookupStatistics.polymorphicLookups, quint64(2));
+        QCOMPARE(v4->lookupStatistics.polymorphicEntries, quint64(8));
+        QVERIFY(v4->lookupStatistics.polymorphicHits > 0);
+        QCOMPARE(v4->lookupStatistics.megamorphicLookups, quint64(0));
+    }
+
+    {
+        QJSEngine engine;
+        QV4::ExecutionEngine *v4 = engine.handle();
+        engine.evaluate("var shapes = [ { x: 0 }, { a: 0, x: 0 }, { b: 0, x: 0 }, { c: 0, d: 0, x: 0 },"
+                        "               { e: 0, x: 0 } ];");
+        QJSValue result = engine.evaluate(script);
+        QCOMPARE(result.toInt(), 1500);
+        QCOMPARE(v4->lookupStatistics.megamorphicLookups, quint64(2));
+    }
+}
+
+void tst_v4misc::polymorphicQObjectLookups()
+{
+    QJSEngine engine;
+    QObject object;
+    object.setObjectName(QStringLiteral("object"));
+    QTimer timer;
+    timer.setObjectName(QStringLiteral("timer"));
+
+    engine.globalObject().setProperty("object", engine.newQObject(&object));
+    engine.globalObject().setProperty("timer", engine.newQObject(&timer));
+    engine.globalObject().setProperty("plain", engine.newObject());
+    engine.evaluate("plain.objectName = 'plain'");
+
+    QJSValue result = engine.evaluate(
+            "function name(o) { return o.objectName; }\n"
+            "var names = [];\n"
+            "for (var i = 0; i < 10; ++i)\n"
+            "    names = [ name(object), name(timer), name(plain) ];\n"
+            "names.join()\n");
+    QCOMPARE(result.toString(), QStringLiteral("object,timer,plain"));
+}
+
 QTEST_MAIN(tst_v4misc);
 
 #include "tst_v4misc.moc"
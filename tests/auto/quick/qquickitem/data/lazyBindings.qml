@@ -0,0 +1,30 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+    property int input: 1
+
+    Item {
+        objectName: "container"
+        Item {
+            objectName: "child"
+            property int value: root.input * 2
+        }
+    }
+
+    Item {
+        objectName: "hiddenParent"
+        visible: false
+    }
+
+    Item {
+        objectName: "movable"
+        property int value: root.input * 2
+    }
+
+    Item {
+        objectName: "hiddenSelf"
+        visible: false
+        property int value: root.input * 2
+    }
+}
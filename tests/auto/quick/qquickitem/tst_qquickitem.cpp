@@ -37,6 +37,10 @@
 #include <QDebug>
 #include <QTimer>
 #include <QQmlEngine>
+#include <QQmlComponent>
+#if QT_CONFIG(process)
+#include <QProcess>
+#endif
 #include "../../shared/util.h"
 #include "../shared/viewtestutil.h"
 #include <QSignalSpy>
@@ -157,6 +161,7 @@ private slots:
     void setParentItem();
 
     void visible();
+    void lazyBindings();
     void enabled();
     void enabledFocus();
 
@@ -1006,6 +1011,69 @@ void tst_qquickitem::visible()
     delete child2;
 }
 
+void tst_qquickitem::lazyBindings()
+{
+#if QT_CONFIG(process)
+    // The variable is read only once per process.
+    const char *lazyBindingsKey = "QML_LAZY_BINDINGS";
+    if (!qEnvironmentVariableIsSet(lazyBindingsKey)) {
+#ifdef Q_OS_ANDROID
+        QSKIP("Android seems to have problems with QProcess");
+#endif
+        QProcess child;
+        child.setProgram(QCoreApplication::applicationFilePath());
+        child.setArguments(QStringList(QLatin1String("lazyBindings")));
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert(QLatin1String(lazyBindingsKey), QLatin1String("1"));
+        child.setProcessEnvironment(env);
+        child.start();
+        QVERIFY(child.waitForFinished());
+        QCOMPARE(child.exitCode(), 0);
+        return;
+    }
+#else
+    QSKIP("Need QProcess support to set QML_LAZY_BINDINGS.");
+#endif
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("lazyBindings.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+
+    QQuickItem *container = root->findChild<QQuickItem *>("container");
+    QQuickItem *child = root->findChild<QQuickItem *>("child");
+    QQuickItem *hiddenParent = root->findChild<QQuickItem *>("hiddenParent");
+    QQuickItem *movable = root->findChild<QQuickItem *>("movable");
+    QQuickItem *hiddenSelf = root->findChild<QQuickItem *>("hiddenSelf");
+    QVERIFY(container && child && hiddenParent && movable && hiddenSelf);
+    QCOMPARE(child->property("value").toInt(), 2);
+
+    // Hiding an ancestor defers the updates, showing it again evaluates them
+    container->setVisible(false);
+    root->setProperty("input", 2);
+    QCOMPARE(child->property("value").toInt(), 2);
+    container->setVisible(true);
+    QCOMPARE(child->property("value").toInt(), 4);
+    root->setProperty("input", 3);
+    QCOMPARE(child->property("value").toInt(), 6);
+
+    // Reparenting into a hidden parent defers the updates, reparenting out evaluates them
+    QCOMPARE(movable->property("value").toInt(), 6);
+    movable->setParentItem(hiddenParent);
+    root->setProperty("input", 4);
+    QCOMPARE(movable->property("value").toInt(), 6);
+    movable->setParentItem(qobject_cast<QQuickItem *>(root.data()));
+    QCOMPARE(movable->property("value").toInt(), 8);
+    root->setProperty("input", 5);
+    QCOMPARE(movable->property("value").toInt(), 10);
+
+    // An item hidden by its own visible property keeps evaluating its bindings
+    QVERIFY(!hiddenSelf->isVisible());
+    QCOMPARE(hiddenSelf->property("value").toInt(), 10);
+    root->setProperty("input", 6);
+    QCOMPARE(hiddenSelf->property("value").toInt(), 12);
+}
+
 void tst_qquickitem::enabled()
 {
     QQuickItem *root = new QQuickItem;
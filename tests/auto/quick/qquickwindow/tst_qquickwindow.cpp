@@ -44,6 +44,8 @@
 #include <QSignalSpy>
 #include <private/qquickwindow_p.h>
 #include <private/qguiapplication_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4mm_p.h>
 #include <QRunnable>
 #include <QOpenGLFunctions>
 #include <QSGRendererInterface>
@@ -482,6 +484,8 @@ private slots:
     void testChildMouseEventFilter_data();
     void cleanupGrabsOnRelease();
 
+    void incrementalGCSlice();
+
 private:
     QTouchDevice *touchDevice;
     QTouchDevice *touchDeviceWithVelocity;
@@ -3579,6 +3583,32 @@ void tst_qquickwindow::cleanupGrabsOnRelease()
     QCOMPARE(parent->mouseUngrabEventCount, 1);
 }
 
+void tst_qquickwindow::incrementalGCSlice()
+{
+    qputenv("QV4_MM_INCREMENTAL_GC", "1");
+    QQmlEngine engine;
+    qunsetenv("QV4_MM_INCREMENTAL_GC");
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    QVERIFY(mm->incrementalGC);
+
+    // A window created from C++, without an incubation controller, finds the
+    // engine through its content.
+    QQuickWindow window;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.0\nItem {}", QUrl());
+    QScopedPointer<QQuickItem> item(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY(item);
+    item->setParentItem(window.contentItem());
+    QQuickWindowPrivate *windowPrivate = QQuickWindowPrivate::get(&window);
+    QVERIFY(!windowPrivate->incubationController);
+
+    mm->startIncrementalGC();
+    QVERIFY(mm->isIncrementalGCRunning());
+    for (int slices = 0; mm->isIncrementalGCRunning() && slices < 10000; ++slices)
+        windowPrivate->runIncrementalGCSlice();
+    QVERIFY(!mm->isIncrementalGCRunning());
+}
+
 QTEST_MAIN(tst_qquickwindow)
 
 #include "tst_qquickwindow.moc"
@@ -51,6 +51,10 @@ private slots:
     void objectproperty();
     void basicproperty_data();
     void basicproperty();
+    void parentcontextproperty_data();
+    void parentcontextproperty();
+    void simplebinding_data();
+    void simplebinding();
     void creation_data();
     void creation();
 
@@ -147,6 +151,68 @@ void tst_binding::basicproperty()
     }
 }
 
+void tst_binding::parentcontextproperty_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("binding");
+
+    QTest::newRow("myObject.value") << SRCDIR "/data/parentcontext.txt" << "myObject.value";
+    QTest::newRow("myObject.value + 10") << SRCDIR "/data/parentcontext.txt" << "myObject.value + 10";
+    QTest::newRow("tstObject.value") << SRCDIR "/data/parentcontext.txt" << "tstObject.value";
+    QTest::newRow("myObject.value + tstObject.value") << SRCDIR "/data/parentcontext.txt" << "myObject.value + tstObject.value";
+}
+
+void tst_binding::parentcontextproperty()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, binding);
+
+    COMPONENT(file, binding);
+
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(c.create());
+    QVERIFY(object != 0);
+    QVERIFY(object->object() != 0);
+    object->setValue(10);
+    tstObject.setValue(10);
+
+    QBENCHMARK {
+        object->setValue(1);
+        tstObject.setValue(1);
+    }
+}
+
+// Bindings of these forms are evaluated without calling their JavaScript function. Run the
+// benchmark with QML_DISABLE_SIMPLE_BINDINGS=1 to compare against evaluating the function.
+void tst_binding::simplebinding_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("binding");
+
+    QTest::newRow("value") << SRCDIR "/data/localproperty.txt" << "value";
+    QTest::newRow("value * 2") << SRCDIR "/data/localproperty.txt" << "value * 2";
+    QTest::newRow("myObject.value") << SRCDIR "/data/idproperty.txt" << "myObject.value";
+    QTest::newRow("myObject.value + 10") << SRCDIR "/data/idproperty.txt" << "myObject.value + 10";
+    QTest::newRow("!myObject.value") << SRCDIR "/data/idproperty.txt" << "!myObject.value";
+    QTest::newRow("myObject.value - 1 (parent context)") << SRCDIR "/data/parentcontext.txt" << "myObject.value - 1";
+}
+
+void tst_binding::simplebinding()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, binding);
+
+    COMPONENT(file, binding);
+
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(c.create());
+    QVERIFY(object != 0);
+    object->setValue(10);
+
+    QBENCHMARK {
+        object->setValue(1);
+        object->setValue(2);
+    }
+}
+
 void tst_binding::creation_data()
 {
     QTest::addColumn<QString>("file");
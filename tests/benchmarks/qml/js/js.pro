@@ -3,8 +3,10 @@ SUBDIRS = \
         qjsengine \
         qjsvalue \
         qjsvalueiterator \
+        json \
 
 TRUSTED_BENCHMARKS += \
+    json \
     qjsvalue \
     qjsengine \
 
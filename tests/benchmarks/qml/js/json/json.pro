@@ -0,0 +1,8 @@
+CONFIG += benchmark
+TEMPLATE = app
+TARGET = tst_bench_json
+
+SOURCES += tst_json.cpp
+
+QT += qml testlib
+macos:CONFIG -= app_bundle
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtQml/qjsvalue.h>
+#include <QtQml/qjsengine.h>
+
+class tst_json : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void parse_data();
+    void parse();
+    void stringify_data();
+    void stringify();
+
+private:
+    void addRows();
+
+    QJSEngine m_engine;
+};
+
+// A telemetry-like document: many objects with the same layout, a mix of numbers, short
+// strings, strings with escapes and nested arrays.
+static QString telemetryDocument(int samples, bool indented)
+{
+    QString json;
+    json += QLatin1String("{\"source\": \"sensor-bus\", \"samples\": [");
+    for (int i = 0; i < samples; ++i) {
+        if (i)
+            json += QLatin1Char(',');
+        if (indented)
+            json += QLatin1String("\n    ");
+        json += QStringLiteral("{\"id\": %1, \"timestamp\": %2, \"value\": %3, \"unit\": \"mV\", "
+                               "\"label\": \"channel %4\", \"note\": \"line\\n\\\"quoted\\\" \\u00e9\", "
+                               "\"ok\": %5, \"history\": [%6, %7, %8]}")
+                .arg(i).arg(1580000000000.0 + i * 16, 0, 'f', 0).arg(i * 0.25)
+                .arg(i % 32).arg(i % 7 ? QLatin1String("true") : QLatin1String("false"))
+                .arg(i - 1).arg(i).arg(i + 1);
+    }
+    if (indented)
+        json += QLatin1Char('\n');
+    json += QLatin1String("]}");
+    return json;
+}
+
+void tst_json::initTestCase()
+{
+    m_engine.globalObject().setProperty(QStringLiteral("compact"),
+                                        telemetryDocument(10000, false));
+    m_engine.globalObject().setProperty(QStringLiteral("indented"),
+                                        telemetryDocument(10000, true));
+    QJSValue parsed = m_engine.evaluate(QStringLiteral("var data = JSON.parse(compact); data"));
+    QVERIFY(!parsed.isError());
+    QCOMPARE(parsed.property(QStringLiteral("samples")).property(QStringLiteral("length")).toInt(),
+             10000);
+}
+
+void tst_json::addRows()
+{
+    QTest::addColumn<QString>("code");
+}
+
+void tst_json::parse_data()
+{
+    addRows();
+    QTest::newRow("compact") << QStringLiteral("JSON.parse(compact)");
+    QTest::newRow("indented") << QStringLiteral("JSON.parse(indented)");
+}
+
+void tst_json::parse()
+{
+    QFETCH(QString, code);
+    QJSValue function = m_engine.evaluate(QStringLiteral("(function() { return %1; })").arg(code));
+    QVERIFY(function.isCallable());
+
+    QBENCHMARK {
+        function.call();
+    }
+}
+
+void tst_json::stringify_data()
+{
+    addRows();
+    QTest::newRow("compact") << QStringLiteral("JSON.stringify(data)");
+    QTest::newRow("indented") << QStringLiteral("JSON.stringify(data, null, 4)");
+}
+
+void tst_json::stringify()
+{
+    QFETCH(QString, code);
+    QJSValue function = m_engine.evaluate(QStringLiteral("(function() { return %1; })").arg(code));
+    QVERIFY(function.isCallable());
+
+    QBENCHMARK {
+        function.call();
+    }
+}
+
+QTEST_MAIN(tst_json)
+
+#include "tst_json.moc"
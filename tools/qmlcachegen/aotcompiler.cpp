@@ -0,0 +1,681 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "aotcompiler.h"
+
+#include <QTextStream>
+
+#include <cmath>
+
+using namespace QQmlJS;
+
+namespace {
+
+enum class Type { Unknown, Number, Bool, String, Object };
+
+struct Value
+{
+    Type type;
+    QString code; // a C++ expression without side effects
+};
+
+static QString cppTypeName(Type type)
+{
+    switch (type) {
+    case Type::Number:
+        return QStringLiteral("double");
+    case Type::Bool:
+        return QStringLiteral("bool");
+    case Type::String:
+        return QStringLiteral("QString");
+    case Type::Object:
+        return QStringLiteral("QObject *");
+    case Type::Unknown:
+        break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+static QString metaTypeName(Type type)
+{
+    switch (type) {
+    case Type::Number:
+        return QStringLiteral("QMetaType::Double");
+    case Type::Bool:
+        return QStringLiteral("QMetaType::Bool");
+    case Type::String:
+        return QStringLiteral("QMetaType::QString");
+    case Type::Object:
+    case Type::Unknown:
+        break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+// Suffix of the AOTCompiledContext accessors for the type
+static QString accessorSuffix(Type type)
+{
+    switch (type) {
+    case Type::Number:
+        return QStringLiteral("Number");
+    case Type::Bool:
+        return QStringLiteral("Bool");
+    case Type::String:
+        return QStringLiteral("String");
+    case Type::Object:
+        return QStringLiteral("Object");
+    case Type::Unknown:
+        break;
+    }
+    Q_UNREACHABLE();
+    return QString();
+}
+
+static bool numberLiteral(double value, QString *literal)
+{
+    if (!std::isfinite(value))
+        return false;
+    *literal = QString::number(value, 'g', 17);
+    if (!literal->contains(QLatin1Char('.')) && !literal->contains(QLatin1Char('e')))
+        *literal += QLatin1String(".0");
+    return true;
+}
+
+// Plain ASCII is emitted as a QStringLiteral. Anything else is encoded as UTF-8 with octal escapes,
+// which, unlike hex escapes, can't swallow the characters that follow them.
+static QString stringLiteral(const QString &value)
+{
+    QString escaped;
+    bool isAscii = true;
+    const QByteArray utf8 = value.toUtf8();
+    for (const char c : utf8) {
+        const uchar u = uchar(c);
+        if (c == '"' || c == '\\' || c == '?') {
+            escaped += QLatin1Char('\\');
+            escaped += QLatin1Char(c);
+        } else if (u >= 0x20 && u < 0x7f) {
+            escaped += QLatin1Char(c);
+        } else {
+            isAscii = isAscii && u < 0x80;
+            escaped += QLatin1Char('\\');
+            escaped += QString::number(u, 8).rightJustified(3, QLatin1Char('0'));
+        }
+    }
+    if (isAscii)
+        return QLatin1String("QStringLiteral(\"") + escaped + QLatin1String("\")");
+    return QLatin1String("QString::fromUtf8(\"") + escaped + QLatin1String("\")");
+}
+
+static AST::ExpressionNode *stripParentheses(AST::ExpressionNode *expr)
+{
+    while (AST::NestedExpression *nested = AST::cast<AST::NestedExpression *>(expr))
+        expr = nested->expression;
+    return expr;
+}
+
+static bool isSignalHandlerName(const QString &name)
+{
+    return name.length() > 2 && name.startsWith(QLatin1String("on")) && name.at(2).isUpper();
+}
+
+// The type of a binding's value if the binding initializes a property declared with it
+static Type declaredPropertyType(const QmlIR::Object *object, quint32 nameIndex)
+{
+    for (auto property = object->propertiesBegin(); property != object->propertiesEnd(); ++property) {
+        if (property->nameIndex != nameIndex)
+            continue;
+        if (property->isList)
+            return Type::Unknown;
+        switch (property->builtinType()) {
+        case QV4::CompiledData::BuiltinType::Int:
+        case QV4::CompiledData::BuiltinType::Real:
+            return Type::Number;
+        case QV4::CompiledData::BuiltinType::Bool:
+            return Type::Bool;
+        case QV4::CompiledData::BuiltinType::String:
+            return Type::String;
+        default:
+            return Type::Unknown;
+        }
+    }
+    return Type::Unknown;
+}
+
+// The type an expression has regardless of the types of the names and properties it reads
+static Type staticType(AST::ExpressionNode *expr)
+{
+    expr = stripParentheses(expr);
+    switch (expr->kind) {
+    case AST::Node::Kind_NumericLiteral:
+    case AST::Node::Kind_UnaryMinusExpression:
+    case AST::Node::Kind_UnaryPlusExpression:
+        return Type::Number;
+    case AST::Node::Kind_StringLiteral:
+        return Type::String;
+    case AST::Node::Kind_TrueLiteral:
+    case AST::Node::Kind_FalseLiteral:
+    case AST::Node::Kind_NotExpression:
+        return Type::Bool;
+    case AST::Node::Kind_BinaryExpression: {
+        AST::BinaryExpression *binary = AST::cast<AST::BinaryExpression *>(expr);
+        switch (binary->op) {
+        case QSOperator::Add: {
+            const Type left = staticType(binary->left);
+            const Type right = staticType(binary->right);
+            if (left == Type::String || right == Type::String)
+                return Type::String;
+            if (left == Type::Number || right == Type::Number)
+                return Type::Number;
+            return Type::Unknown;
+        }
+        case QSOperator::Sub:
+        case QSOperator::Mul:
+        case QSOperator::Div:
+        case QSOperator::Mod:
+            return Type::Number;
+        case QSOperator::Lt:
+        case QSOperator::Gt:
+        case QSOperator::Le:
+        case QSOperator::Ge:
+        case QSOperator::Equal:
+        case QSOperator::NotEqual:
+        case QSOperator::StrictEqual:
+        case QSOperator::StrictNotEqual:
+        case QSOperator::And:
+        case QSOperator::Or:
+            return Type::Bool;
+        default:
+            return Type::Unknown;
+        }
+    }
+    case AST::Node::Kind_ConditionalExpression: {
+        AST::ConditionalExpression *conditional = AST::cast<AST::ConditionalExpression *>(expr);
+        const Type ok = staticType(conditional->ok);
+        return ok != Type::Unknown ? ok : staticType(conditional->ko);
+    }
+    default:
+        return Type::Unknown;
+    }
+}
+
+class FunctionCompiler
+{
+public:
+    FunctionCompiler(QmlIR::Document *document, const QSet<QString> &illegalNames)
+        : document(document), illegalNames(illegalNames)
+    {}
+
+    bool compileBinding(AST::Node *node, Type declaredType, Type *returnType);
+    bool compileSignalHandler(AST::Node *node);
+
+    QString body;
+    bool usesContext = false;
+
+private:
+    bool compileExpression(AST::ExpressionNode *expr, Type type, Value *result);
+    bool compileBinaryExpression(AST::BinaryExpression *binary, Type type, Value *result);
+    bool compileConditionalExpression(AST::ConditionalExpression *conditional, Type type,
+                                      Value *result);
+    bool compileName(const QString &name, Type type, Value *result);
+
+    bool isLookupName(const QString &name) const;
+    QString declareTemporary(Type type);
+    void emitLine(const QString &line);
+    void emitCheckedCall(const QString &call);
+
+    QmlIR::Document *document;
+    const QSet<QString> &illegalNames;
+    int temporaryCount = 0;
+    int indentation = 1;
+};
+
+// Names that QML doesn't look up in its contexts are left to the bytecode, that is types,
+// enums and the JavaScript globals.
+bool FunctionCompiler::isLookupName(const QString &name) const
+{
+    return !name.isEmpty() && !name.at(0).isUpper() && !illegalNames.contains(name)
+            && name != QLatin1String("arguments");
+}
+
+QString FunctionCompiler::declareTemporary(Type type)
+{
+    const QString name = QLatin1String("tmp") + QString::number(temporaryCount++);
+    if (type == Type::Object)
+        emitLine(cppTypeName(type) + name + QLatin1String(" = nullptr;"));
+    else
+        emitLine(cppTypeName(type) + QLatin1Char(' ') + name + QLatin1Char(';'));
+    return name;
+}
+
+void FunctionCompiler::emitLine(const QString &line)
+{
+    body += QString(indentation * 4, QLatin1Char(' ')) + line + QLatin1Char('\n');
+}
+
+void FunctionCompiler::emitCheckedCall(const QString &call)
+{
+    usesContext = true;
+    emitLine(QLatin1String("if (!context->") + call + QLatin1String(")"));
+    emitLine(QLatin1String("    return false;"));
+}
+
+bool FunctionCompiler::compileName(const QString &name, Type type, Value *result)
+{
+    if (type == Type::Unknown || !isLookupName(name))
+        return false;
+    const QString temporary = declareTemporary(type);
+    emitCheckedCall(QLatin1String("lookup") + accessorSuffix(type) + QLatin1Char('(')
+                    + QString::number(document->registerString(name)) + QLatin1String(", &")
+                    + temporary + QLatin1Char(')'));
+    *result = { type, temporary };
+    return true;
+}
+
+bool FunctionCompiler::compileExpression(AST::ExpressionNode *expr, Type type, Value *result)
+{
+    expr = stripParentheses(expr);
+    if (type == Type::Unknown)
+        type = staticType(expr);
+
+    switch (expr->kind) {
+    case AST::Node::Kind_NumericLiteral: {
+        QString literal;
+        if (type != Type::Number
+                || !numberLiteral(AST::cast<AST::NumericLiteral *>(expr)->value, &literal)) {
+            return false;
+        }
+        *result = { type, literal };
+        return true;
+    }
+    case AST::Node::Kind_StringLiteral:
+        if (type != Type::String)
+            return false;
+        *result = { type, stringLiteral(AST::cast<AST::StringLiteral *>(expr)->value.toString()) };
+        return true;
+    case AST::Node::Kind_TrueLiteral:
+    case AST::Node::Kind_FalseLiteral:
+        if (type != Type::Bool)
+            return false;
+        *result = { type, expr->kind == AST::Node::Kind_TrueLiteral ? QStringLiteral("true")
+                                                                    : QStringLiteral("false") };
+        return true;
+    case AST::Node::Kind_IdentifierExpression:
+        return compileName(AST::cast<AST::IdentifierExpression *>(expr)->name.toString(), type,
+                           result);
+    case AST::Node::Kind_FieldMemberExpression: {
+        AST::FieldMemberExpression *member = AST::cast<AST::FieldMemberExpression *>(expr);
+        Value base;
+        if (type == Type::Unknown || !compileExpression(member->base, Type::Object, &base))
+            return false;
+        const QString temporary = declareTemporary(type);
+        emitCheckedCall(QLatin1String("load") + accessorSuffix(type) + QLatin1Char('(')
+                        + base.code + QLatin1String(", ")
+                        + QString::number(document->registerString(member->name.toString()))
+                        + QLatin1String(", &") + temporary + QLatin1Char(')'));
+        *result = { type, temporary };
+        return true;
+    }
+    case AST::Node::Kind_UnaryMinusExpression:
+    case AST::Node::Kind_UnaryPlusExpression: {
+        AST::ExpressionNode *operand = expr->kind == AST::Node::Kind_UnaryMinusExpression
+                ? AST::cast<AST::UnaryMinusExpression *>(expr)->expression
+                : AST::cast<AST::UnaryPlusExpression *>(expr)->expression;
+        Value value;
+        if (type != Type::Number || !compileExpression(operand, Type::Number, &value))
+            return false;
+        if (expr->kind == AST::Node::Kind_UnaryMinusExpression)
+            value.code = QLatin1String("(-") + value.code + QLatin1Char(')');
+        *result = { type, value.code };
+        return true;
+    }
+    case AST::Node::Kind_NotExpression: {
+        Value value;
+        if (type != Type::Bool
+                || !compileExpression(AST::cast<AST::NotExpression *>(expr)->expression,
+                                      Type::Bool, &value)) {
+            return false;
+        }
+        *result = { type, QLatin1Char('!') + value.code };
+        return true;
+    }
+    case AST::Node::Kind_BinaryExpression:
+        return compileBinaryExpression(AST::cast<AST::BinaryExpression *>(expr), type, result);
+    case AST::Node::Kind_ConditionalExpression:
+        return compileConditionalExpression(AST::cast<AST::ConditionalExpression *>(expr), type,
+                                            result);
+    default:
+        return false;
+    }
+}
+
+bool FunctionCompiler::compileBinaryExpression(AST::BinaryExpression *binary, Type type,
+                                               Value *result)
+{
+    QString op;
+    Type operandType = type;
+    switch (binary->op) {
+    case QSOperator::Add:
+        // Adding two operands of unknown type defaults to numbers, unless the result is a string.
+        if (operandType == Type::Unknown)
+            operandType = Type::Number;
+        if (operandType != Type::Number && operandType != Type::String)
+            return false;
+        op = QStringLiteral("+");
+        break;
+    case QSOperator::Sub:
+    case QSOperator::Mul:
+    case QSOperator::Div:
+    case QSOperator::Mod:
+        if (type != Type::Number)
+            return false;
+        op = binary->op == QSOperator::Sub ? QStringLiteral("-")
+           : binary->op == QSOperator::Mul ? QStringLiteral("*")
+           : binary->op == QSOperator::Div ? QStringLiteral("/") : QString();
+        break;
+    case QSOperator::Lt:
+    case QSOperator::Gt:
+    case QSOperator::Le:
+    case QSOperator::Ge:
+    case QSOperator::Equal:
+    case QSOperator::NotEqual:
+    case QSOperator::StrictEqual:
+    case QSOperator::StrictNotEqual: {
+        if (type != Type::Bool)
+            return false;
+        // Both operands are compared as the type one of them is known to have, numbers otherwise.
+        operandType = staticType(binary->left);
+        if (operandType == Type::Unknown)
+            operandType = staticType(binary->right);
+        if (operandType == Type::Unknown)
+            operandType = Type::Number;
+        const bool isRelational = binary->op == QSOperator::Lt || binary->op == QSOperator::Gt
+                || binary->op == QSOperator::Le || binary->op == QSOperator::Ge;
+        if (isRelational && operandType == Type::Bool)
+            return false;
+        switch (binary->op) {
+        case QSOperator::Lt: op = QStringLiteral("<"); break;
+        case QSOperator::Gt: op = QStringLiteral(">"); break;
+        case QSOperator::Le: op = QStringLiteral("<="); break;
+        case QSOperator::Ge: op = QStringLiteral(">="); break;
+        case QSOperator::Equal:
+        case QSOperator::StrictEqual: op = QStringLiteral("=="); break;
+        default: op = QStringLiteral("!="); break;
+        }
+        break;
+    }
+    case QSOperator::And:
+    case QSOperator::Or: {
+        if (type != Type::Bool)
+            return false;
+        // The right operand is only evaluated, and its dependencies captured, when it's needed.
+        Value left;
+        if (!compileExpression(binary->left, Type::Bool, &left))
+            return false;
+        const QString temporary = declareTemporary(Type::Bool);
+        emitLine(temporary + QLatin1String(" = ") + left.code + QLatin1Char(';'));
+        emitLine(QLatin1String(binary->op == QSOperator::And ? "if (" : "if (!") + temporary
+                 + QLatin1String(") {"));
+        ++indentation;
+        Value right;
+        if (!compileExpression(binary->right, Type::Bool, &right))
+            return false;
+        emitLine(temporary + QLatin1String(" = ") + right.code + QLatin1Char(';'));
+        --indentation;
+        emitLine(QLatin1String("}"));
+        *result = { Type::Bool, temporary };
+        return true;
+    }
+    default:
+        return false;
+    }
+
+    Value left;
+    Value right;
+    if (!compileExpression(binary->left, operandType, &left)
+            || !compileExpression(binary->right, operandType, &right)) {
+        return false;
+    }
+
+    if (binary->op == QSOperator::Mod) {
+        // JavaScript's remainder keeps the sign of the dividend, like fmod().
+        *result = { type, QLatin1String("std::fmod(") + left.code + QLatin1String(", ")
+                                  + right.code + QLatin1Char(')') };
+    } else {
+        *result = { type == Type::Unknown ? operandType : type,
+                    QLatin1Char('(') + left.code + QLatin1Char(' ') + op + QLatin1Char(' ')
+                            + right.code + QLatin1Char(')') };
+    }
+    return true;
+}
+
+bool FunctionCompiler::compileConditionalExpression(AST::ConditionalExpression *conditional,
+                                                    Type type, Value *result)
+{
+    Value test;
+    if (type == Type::Unknown || type == Type::Object
+            || !compileExpression(conditional->expression, Type::Bool, &test)) {
+        return false;
+    }
+
+    const QString temporary = declareTemporary(type);
+    emitLine(QLatin1String("if (") + test.code + QLatin1String(") {"));
+    ++indentation;
+    Value ok;
+    if (!compileExpression(conditional->ok, type, &ok))
+        return false;
+    emitLine(temporary + QLatin1String(" = ") + ok.code + QLatin1Char(';'));
+    --indentation;
+    emitLine(QLatin1String("} else {"));
+    ++indentation;
+    Value ko;
+    if (!compileExpression(conditional->ko, type, &ko))
+        return false;
+    emitLine(temporary + QLatin1String(" = ") + ko.code + QLatin1Char(';'));
+    --indentation;
+    emitLine(QLatin1String("}"));
+    *result = { type, temporary };
+    return true;
+}
+
+bool FunctionCompiler::compileBinding(AST::Node *node, Type declaredType, Type *returnType)
+{
+    AST::ExpressionStatement *statement = AST::cast<AST::ExpressionStatement *>(node);
+    if (!statement)
+        return false;
+
+    Type type = staticType(statement->expression);
+    if (type == Type::Unknown)
+        type = declaredType;
+    if (type == Type::Unknown || type == Type::Object)
+        return false;
+
+    Value value;
+    if (!compileExpression(statement->expression, type, &value))
+        return false;
+
+    emitLine(QLatin1String("*static_cast<") + cppTypeName(type) + QLatin1String(" *>(resultPtr) = ")
+             + value.code + QLatin1Char(';'));
+    emitLine(QLatin1String("return true;"));
+    *returnType = type;
+    return true;
+}
+
+// Compiles handlers that assign to a single property. The store comes last and doesn't happen if
+// any of the reads before it fails, so that the bytecode can run the handler from the start.
+bool FunctionCompiler::compileSignalHandler(AST::Node *node)
+{
+    if (AST::Block *block = AST::cast<AST::Block *>(node)) {
+        if (!block->statements || block->statements->next)
+            return false;
+        node = block->statements->statement;
+    }
+
+    AST::ExpressionStatement *statement = AST::cast<AST::ExpressionStatement *>(node);
+    if (!statement)
+        return false;
+    AST::BinaryExpression *assignment
+            = AST::cast<AST::BinaryExpression *>(stripParentheses(statement->expression));
+    if (!assignment)
+        return false;
+
+    Type type = staticType(assignment->right);
+    QString op;
+    switch (assignment->op) {
+    case QSOperator::Assign:
+        break;
+    case QSOperator::InplaceAdd:
+        if (type == Type::Unknown)
+            type = Type::Number;
+        op = QStringLiteral("+");
+        break;
+    case QSOperator::InplaceSub:
+    case QSOperator::InplaceMul:
+    case QSOperator::InplaceDiv:
+        type = Type::Number;
+        op = assignment->op == QSOperator::InplaceSub ? QStringLiteral("-")
+           : assignment->op == QSOperator::InplaceMul ? QStringLiteral("*") : QStringLiteral("/");
+        break;
+    default:
+        return false;
+    }
+    if (type == Type::Unknown || type == Type::Object || (!op.isEmpty() && type == Type::Bool))
+        return false;
+
+    QString object;
+    QString name;
+    AST::ExpressionNode *target = stripParentheses(assignment->left);
+    if (AST::IdentifierExpression *identifier = AST::cast<AST::IdentifierExpression *>(target)) {
+        name = identifier->name.toString();
+        if (!isLookupName(name))
+            return false;
+        object = declareTemporary(Type::Object);
+        emitCheckedCall(QLatin1String("lookupPropertyOwner(")
+                        + QString::number(document->registerString(name)) + QLatin1String(", &")
+                        + object + QLatin1Char(')'));
+    } else if (AST::FieldMemberExpression *member = AST::cast<AST::FieldMemberExpression *>(target)) {
+        Value base;
+        if (!compileExpression(member->base, Type::Object, &base))
+            return false;
+        object = base.code;
+        name = member->name.toString();
+    } else {
+        return false;
+    }
+    const QString nameIndex = QString::number(document->registerString(name));
+
+    QString current;
+    if (!op.isEmpty()) {
+        current = declareTemporary(type);
+        emitCheckedCall(QLatin1String("load") + accessorSuffix(type) + QLatin1Char('(') + object
+                        + QLatin1String(", ") + nameIndex + QLatin1String(", &") + current
+                        + QLatin1Char(')'));
+    }
+
+    Value value;
+    if (!compileExpression(assignment->right, type, &value))
+        return false;
+    if (!op.isEmpty()) {
+        value.code = QLatin1Char('(') + current + QLatin1Char(' ') + op + QLatin1Char(' ')
+                + value.code + QLatin1Char(')');
+    }
+
+    usesContext = true;
+    emitLine(QLatin1String("return context->store") + accessorSuffix(type) + QLatin1Char('(') + object
+             + QLatin1String(", ") + nameIndex + QLatin1String(", ") + value.code
+             + QLatin1String(");"));
+    return true;
+}
+
+} // namespace
+
+AOTCompiler::AOTCompiler(QmlIR::Document *document, const QSet<QString> &illegalNames)
+    : document(document)
+    , illegalNames(illegalNames)
+{
+}
+
+AOTFunctions AOTCompiler::compile()
+{
+    AOTFunctions functions;
+    QTextStream code(&functions.code);
+    QTextStream table(&functions.table);
+
+    for (QmlIR::Object *object: qAsConst(document->objects)) {
+        for (auto binding = object->bindingsBegin(); binding != object->bindingsEnd(); ++binding) {
+            if (binding->type != QV4::CompiledData::Binding::Type_Script)
+                continue;
+
+            const QmlIR::CompiledFunctionOrExpression *foe
+                    = object->functionsAndExpressions->slowAt(binding->value.compiledScriptIndex);
+            // Simple bindings are evaluated without calling their function at all.
+            if (foe->simpleBinding)
+                continue;
+            const int functionIndex
+                    = object->runtimeFunctionIndices.at(binding->value.compiledScriptIndex);
+            const QString propertyName = document->stringAt(binding->propertyNameIndex);
+
+            FunctionCompiler compiler(document, illegalNames);
+            Type returnType = Type::Unknown;
+            bool compiled = false;
+            if (isSignalHandlerName(propertyName)) {
+                compiled = compiler.compileSignalHandler(foe->node);
+            } else {
+                compiled = compiler.compileBinding(
+                        foe->node, declaredPropertyType(object, binding->propertyNameIndex),
+                        &returnType);
+            }
+            if (!compiled)
+                continue;
+
+            const QString functionName = QLatin1String("aotFunction")
+                    + QString::number(functionIndex);
+            code << "// " << propertyName << " at " << quint32(binding->valueLocation.line) << ':'
+                 << quint32(binding->valueLocation.column) << '\n';
+            code << "static bool " << functionName
+                 << "(const QQmlPrivate::AOTCompiledContext *context, void *resultPtr)\n";
+            code << "{\n";
+            if (!compiler.usesContext)
+                code << "    Q_UNUSED(context);\n";
+            if (returnType == Type::Unknown)
+                code << "    Q_UNUSED(resultPtr);\n";
+            code << compiler.body;
+            code << "}\n\n";
+
+            table << "    { " << functionIndex << ", "
+                  << (returnType == Type::Unknown ? QStringLiteral("QMetaType::Void")
+                                                  : metaTypeName(returnType))
+                  << ", &" << functionName << " },\n";
+        }
+    }
+
+    code.flush();
+    table.flush();
+    return functions;
+}
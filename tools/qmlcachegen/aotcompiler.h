@@ -0,0 +1,59 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef AOTCOMPILER_H
+#define AOTCOMPILER_H
+
+#include <private/qqmlirbuilder_p.h>
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+
+struct AOTFunctions
+{
+    QByteArray code; // definitions of the generated functions
+    QByteArray table; // entries of the aotBuiltFunctions table
+};
+
+// Compiles the bindings and signal handlers whose values can be typed statically to C++. The
+// engine runs these functions instead of the bytecode and falls back to the bytecode whenever a
+// name or property turns out to have a different type at run time.
+struct AOTCompiler
+{
+    AOTCompiler(QmlIR::Document *document, const QSet<QString> &illegalNames);
+
+    // Needs the runtime function indices of the objects. Has to run before the unit is generated,
+    // as it registers the names the functions look up.
+    AOTFunctions compile();
+
+private:
+    QmlIR::Document *document;
+    const QSet<QString> &illegalNames;
+};
+
+#endif // AOTCOMPILER_H
@@ -128,8 +128,9 @@ bool generateLoader(const QStringList &compiledFiles, const QString &outputFileN
             const QString ns = symbolNamespaceForPath(compiledFile);
             stream << "namespace " << ns << " { \n";
             stream << "    extern const unsigned char qmlData[];\n";
+            stream << "    extern const QQmlPrivate::AOTCompiledFunction aotBuiltFunctions[];\n";
             stream << "    const QQmlPrivate::CachedQmlUnit unit = {\n";
-            stream << "        reinterpret_cast<const QV4::CompiledData::Unit*>(&qmlData), nullptr, nullptr\n";
+            stream << "        reinterpret_cast<const QV4::CompiledData::Unit*>(&qmlData), &aotBuiltFunctions[0], nullptr\n";
             stream << "    };\n";
             stream << "}\n";
         }
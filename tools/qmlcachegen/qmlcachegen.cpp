@@ -42,6 +42,7 @@
 #include <private/qqmljslexer_p.h>
 
 #include "resourcefilemapper.h"
+#include "aotcompiler.h"
 
 #include <algorithm>
 
@@ -177,7 +178,8 @@ static bool checkArgumentsObjectUseInSignalHandlers(const QmlIR::Document &doc,
 
 using SaveFunction = std::function<bool(const QV4::CompiledData::SaveableUnitPointer &, QString *)>;
 
-static bool compileQmlFile(const QString &inputFileName, SaveFunction saveFunction, Error *error)
+static bool compileQmlFile(const QString &inputFileName, SaveFunction saveFunction,
+                           AOTFunctions *aotFunctions, Error *error)
 {
     QmlIR::Document irDocument(/*debugMode*/false);
 
@@ -228,6 +230,9 @@ static bool compileQmlFile(const QString &inputFileName, SaveFunction saveFuncti
             return false;
         }
 
+        if (aotFunctions)
+            *aotFunctions = AOTCompiler(&irDocument, illegalNames).compile();
+
         QmlIR::QmlUnitGenerator generator;
         irDocument.javaScriptCompilationUnit = v4CodeGen.generateCompilationUnit(/*generate unit*/false);
         generator.generate(irDocument);
@@ -331,7 +336,7 @@ static bool compileJSFile(const QString &inputFileName, const QString &inputFile
 
 static bool saveUnitAsCpp(const QString &inputFileName, const QString &outputFileName,
                           const QV4::CompiledData::SaveableUnitPointer &unit,
-                          QString *errorString)
+                          const AOTFunctions &aotFunctions, QString *errorString)
 {
 #if QT_CONFIG(temporaryfile)
     QSaveFile f(outputFileName);
@@ -360,6 +365,12 @@ static bool saveUnitAsCpp(const QString &inputFileName, const QString &outputFil
     if (!writeStr("\n"))
         return false;
 
+    if (!writeStr(QByteArrayLiteral("#include <QtQml/qqmlprivate.h>\n")))
+        return false;
+
+    if (!aotFunctions.code.isEmpty() && !writeStr(QByteArrayLiteral("#include <cmath>\n")))
+        return false;
+
     if (!writeStr(QByteArrayLiteral("namespace QmlCacheGeneratedCode {\nnamespace ")))
         return false;
 
@@ -390,9 +401,20 @@ static bool saveUnitAsCpp(const QString &inputFileName, const QString &outputFil
         return writeStr(hexifiedData);
     });
 
+    if (!writeStr("};\n"))
+        return false;
 
+    if (!writeStr(aotFunctions.code))
+        return false;
 
-    if (!writeStr("};\n}\n}\n"))
+    // The loader refers to the table of every file, so it's written even if it's empty.
+    if (!writeStr(QByteArrayLiteral("extern const QQmlPrivate::AOTCompiledFunction aotBuiltFunctions[] = {\n")))
+        return false;
+
+    if (!writeStr(aotFunctions.table))
+        return false;
+
+    if (!writeStr("    { -1, 0, nullptr }\n};\n}\n}\n"))
         return false;
 
 #if QT_CONFIG(temporaryfile)
@@ -430,6 +452,9 @@ int main(int argc, char **argv)
     QCommandLineOption outputFileOption(QStringLiteral("o"), QCoreApplication::translate("main", "Output file name"), QCoreApplication::translate("main", "file name"));
     parser.addOption(outputFileOption);
 
+    QCommandLineOption aotBindingsOption(QStringLiteral("aot-bindings"), QCoreApplication::translate("main", "Compile bindings and signal handlers with statically known types to C++. Only applies when generating C++ code."));
+    parser.addOption(aotBindingsOption);
+
     parser.addPositionalArgument(QStringLiteral("[qml file]"),
             QStringLiteral("QML source file to generate cache for."));
 
@@ -483,6 +508,9 @@ int main(int argc, char **argv)
 
     QString inputFileUrl = inputFile;
 
+    AOTFunctions aotFunctions;
+    const bool compileAOTFunctions = target == GenerateCpp && parser.isSet(aotBindingsOption);
+
     SaveFunction saveFunction;
     if (target == GenerateCpp) {
         ResourceFileMapper fileMapper(parser.values(resourceOption));
@@ -519,10 +547,11 @@ int main(int argc, char **argv)
 
         inputFileUrl = QStringLiteral("qrc://") + inputResourcePath;
 
-        saveFunction = [inputResourcePath, outputFileName](
+        saveFunction = [inputResourcePath, outputFileName, &aotFunctions](
                                const QV4::CompiledData::SaveableUnitPointer &unit,
                                QString *errorString) {
-            return saveUnitAsCpp(inputResourcePath, outputFileName, unit, errorString);
+            return saveUnitAsCpp(inputResourcePath, outputFileName, unit, aotFunctions,
+                                 errorString);
         };
 
     } else {
@@ -541,7 +570,8 @@ int main(int argc, char **argv)
 
     if (inputFile.endsWith(QLatin1String(".qml"))) {
         Error error;
-        if (!compileQmlFile(inputFile, saveFunction, &error)) {
+        if (!compileQmlFile(inputFile, saveFunction,
+                            compileAOTFunctions ? &aotFunctions : nullptr, &error)) {
             error.augment(QLatin1String("Error compiling qml file: ")).print();
             return EXIT_FAILURE;
         }
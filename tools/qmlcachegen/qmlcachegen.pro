@@ -6,7 +6,8 @@ DEFINES += QT_NO_CAST_TO_ASCII QT_NO_CAST_FROM_ASCII
 SOURCES = qmlcachegen.cpp \
     resourcefilter.cpp \
     generateloader.cpp \
-    resourcefilemapper.cpp
+    resourcefilemapper.cpp \
+    aotcompiler.cpp
 TARGET = qmlcachegen
 
 build_integration.files = qmlcache.prf qtquickcompiler.prf
@@ -39,4 +40,5 @@ QMAKE_TARGET_DESCRIPTION = QML Cache Generator
 load(qt_tool)
 
 HEADERS += \
-    resourcefilemapper.h
+    resourcefilemapper.h \
+    aotcompiler.h
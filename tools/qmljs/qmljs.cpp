@@ -140,7 +140,8 @@ int main(int argc, char *argv[])
                 QQmlRefPointer<QV4::ExecutableCompilationUnit> unit
                         = QV4::ExecutableCompilationUnit::create();
                 QString error;
-                if (unit->loadFromDisk(QUrl::fromLocalFile(fn), QFileInfo(fn).lastModified(), &error)) {
+                if (unit->loadFromDisk(QUrl::fromLocalFile(fn), QFileInfo(fn).lastModified(), &error,
+                                       vm.lazyFunctionCompilationEnabled())) {
                     script.reset(new QV4::Script(&vm, nullptr, unit));
                 } else {
                     std::cout << "Error loading" << qPrintable(fn) << "from disk cache:" << qPrintable(error) << std::endl;
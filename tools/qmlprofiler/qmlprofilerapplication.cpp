@@ -68,7 +68,8 @@ static const char *features[] = {
     "binding",
     "handlingsignal",
     "inputevents",
-    "debugmessages"
+    "debugmessages",
+    "heapsnapshots"
 };
 
 Q_STATIC_ASSERT(sizeof(features) == MaximumProfileFeature * sizeof(char *));
@@ -107,6 +108,8 @@ QmlProfilerApplication::QmlProfilerApplication(int &argc, char **argv) :
             this, &QmlProfilerApplication::logError);
     connect(m_profilerData.data(), &QmlProfilerData::dataReady,
             this, &QmlProfilerApplication::traceFinished);
+    connect(m_profilerData.data(), &QmlProfilerData::heapSnapshotData,
+            this, &QmlProfilerApplication::writeHeapSnapshot);
 
 }
 
@@ -185,6 +188,16 @@ void QmlProfilerApplication::parseArguments()
                             QLatin1String("feature,..."));
     parser.addOption(exclude);
 
+    QCommandLineOption heapSnapshot(QLatin1String("heap-snapshot"),
+                                    tr("Request a snapshot of the JavaScript heap each time the "
+                                       "recording stops and write it to <file>, one JSON object "
+                                       "per line. This also samples the allocation sites of "
+                                       "JavaScript objects as part of the memory data. The "
+                                       "heapsnapshots feature is only recorded if this option is "
+                                       "given."),
+                                    QLatin1String("file"));
+    parser.addOption(heapSnapshot);
+
     QCommandLineOption interactive(QLatin1String("interactive"),
                                    tr("Manually control the recording from the command line. The "
                                       "profiler will not terminate itself when the application "
@@ -243,6 +256,16 @@ void QmlProfilerApplication::parseArguments()
     if (parser.isSet(exclude))
         features = parseFeatures(featureList, parser.value(exclude), true);
 
+    if (parser.isSet(heapSnapshot)) {
+        m_heapSnapshotFile.setFileName(parser.value(heapSnapshot));
+        if (!m_heapSnapshotFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            logError(tr("Could not open %1 for writing.").arg(m_heapSnapshotFile.fileName()));
+            parser.showHelp(5);
+        }
+    } else {
+        features &= ~(static_cast<quint64>(1) << ProfileHeapSnapshots);
+    }
+
     if (features == 0)
         parser.showHelp(4);
 
@@ -599,6 +622,15 @@ void QmlProfilerApplication::prompt(const QString &line, bool ready)
     }
 }
 
+void QmlProfilerApplication::writeHeapSnapshot(const QByteArray &data)
+{
+    if (!m_heapSnapshotFile.isOpen())
+        return;
+    if (m_heapSnapshotFile.write(data) != data.size())
+        logError(tr("Could not write heap snapshot to %1.").arg(m_heapSnapshotFile.fileName()));
+    m_heapSnapshotFile.flush();
+}
+
 void QmlProfilerApplication::logError(const QString &error)
 {
     std::cerr << "Error: " << qPrintable(error) << std::endl;
@@ -35,6 +35,7 @@
 #include <private/qqmldebugconnection_p.h>
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qprocess.h>
 #include <QtCore/qtimer.h>
 #include <QtNetwork/qabstractsocket.h>
@@ -75,6 +76,7 @@ private:
 
     void traceClientEnabledChanged(bool enabled);
     void traceFinished();
+    void writeHeapSnapshot(const QByteArray &data);
 
     void prompt(const QString &line = QString(), bool ready = true);
     void logError(const QString &error);
@@ -100,6 +102,7 @@ private:
     quint16 m_port;
     QString m_outputFile;
     QString m_interactiveOutputFile;
+    QFile m_heapSnapshotFile;
 
     PendingRequest m_pendingRequest;
     bool m_verbose;
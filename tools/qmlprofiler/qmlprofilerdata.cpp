@@ -62,7 +62,8 @@ static const char *MESSAGE_STRINGS[] = {
     "PixmapCache",
     "SceneGraph",
     "MemoryAllocation",
-    "DebugMessage"
+    "DebugMessage",
+    "HeapSnapshot"
 };
 
 Q_STATIC_ASSERT(sizeof(MESSAGE_STRINGS) == MaximumMessage * sizeof(const char *));
@@ -152,6 +153,13 @@ qint64 QmlProfilerData::traceEndTime() const
 void QmlProfilerData::addEvent(const QQmlProfilerEvent &event)
 {
     setState(AcquiringData);
+
+    // Heap snapshots can be large and are not part of the trace. Pass them on as they arrive.
+    if (d->eventTypes.at(event.typeIndex()).message() == HeapSnapshot) {
+        emit heapSnapshotData(event.numbers<QByteArray, qint8>());
+        return;
+    }
+
     d->events.append(event);
 }
 
@@ -212,6 +220,9 @@ void QmlProfilerData::addEventType(const QQmlProfilerEventType &type)
     case DebugMessage:
         displayName = QString::fromLatin1("DebugMessage:%1").arg(type.detailType());
         break;
+    case HeapSnapshot:
+        displayName = QString::fromLatin1("HeapSnapshot");
+        break;
     case MaximumMessage: {
         const QQmlProfilerEventLocation eventLocation = type.location();
         // generate hash
@@ -74,6 +74,7 @@ signals:
     void error(QString);
     void stateChanged();
     void dataReady();
+    void heapSnapshotData(const QByteArray &data);
 
 private:
     void sortStartTimes();